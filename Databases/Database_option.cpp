@@ -1,6 +1,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <vector>
 #include <thread>
@@ -13,8 +14,57 @@
 #include <ctime>
 #include <limits>
 #include <stdexcept>
-#include <regex> // Diperlukan untuk validasi keamanan
 #include <map>   // Diperlukan untuk update/select interaktif
+#include <deque>
+#include <list>
+#include <future>
+#include <functional>
+#include <condition_variable>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <atomic>
+#include <filesystem>
+#include <optional>
+#include <variant>
+#include <tuple>
+#include <charconv>
+#include <unordered_map>
+#include <unordered_set>
+#include <set>
+#include <cmath>
+#include <numeric>
+#include <csignal>
+#if defined(__linux__)
+#include <sys/inotify.h> // followCSV: notifikasi append tanpa polling
+#include <poll.h>
+#include <unistd.h>
+#include <sys/epoll.h> // Daemon ingest HTTP
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h> // getrusage: puncak RSS
+#endif
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h> // GetProcessMemoryInfo: RSS (working set)
+#include <malloc.h> // _aligned_malloc
+#pragma comment(lib, "psapi.lib")
+#endif
+#if __has_include(<zlib.h>)
+#include <zlib.h> // Kompresi gzip untuk ekspor/backup/impor
+#define DBM_HAVE_ZLIB 1
+#endif
+#if __has_include(<zstd.h>)
+#include <zstd.h> // Kompresi zstd untuk ekspor/backup/impor
+#define DBM_HAVE_ZSTD 1
+#endif
 #include <C:/Program Files/MySQL/mysql-connector-c++-8.0.33-winx64/include/jdbc/mysql_driver.h>
 #include <C:/Program Files/MySQL/mysql-connector-c++-8.0.33-winx64/include/jdbc/mysql_connection.h>
 #include <C:/Program Files/MySQL/mysql-connector-c++-8.0.33-winx64/include/jdbc/cppconn/statement.h>
@@ -25,437 +75,5310 @@
 using namespace std;
 
 /**
- * @class DatabaseManager
- * Mengelola semua koneksi dan operasi ke database MySQL.
- * Ditingkatkan dengan validasi identifier untuk keamanan
- * dan operasi data interaktif yang aman.
+ * @struct ExportFilter
+ * Satu predikat WHERE untuk exportToCSV. Nilai selalu di-bind sebagai
+ * parameter prepared statement, nama kolom divalidasi terhadap skema tabel.
  */
-class DatabaseManager {
-private:
-    sql::mysql::MySQL_Driver* driver;
-    unique_ptr<sql::Connection> conn;
-    string currentDB;
-    mutex dbMutex;
-    mutex logMutex;
-    ofstream logFile;
+struct ExportFilter {
+    enum class Op { Equal, In, Range };
+    string column;
+    Op op = Op::Equal;
+    // Equal: tepat 1 nilai. In: minimal 1 nilai.
+    // Range: {dari, sampai} -> kolom >= dari AND kolom < sampai (string kosong = tanpa batas).
+    vector<string> values;
+};
 
-    /**
-     * @brief Menulis pesan log ke file dengan timestamp. Thread-safe.
-     */
-    void writeLog(const string& msg) {
-        lock_guard<mutex> logLock(logMutex);
-        if (!logFile.is_open()) return;
+/**
+ * @struct ConnectionInfo
+ * Kredensial koneksi, disimpan agar koneksi tambahan (async/paralel) dapat dibuka.
+ */
+struct ConnectionInfo {
+    string host;
+    string user;
+    string pass;
+};
 
-        auto now = chrono::system_clock::now();
-        time_t t = chrono::system_clock::to_time_t(now);
-        tm tmBuf;
-#if defined(_WIN32) || defined(_WIN64)
-        localtime_s(&tmBuf, &t);
-#else
-        localtime_r(&t, &tmBuf);
-#endif
-        ostringstream oss;
-        oss << put_time(&tmBuf, "%Y-%m-%d %H:%M:%S");
-        logFile << "[" << oss.str() << "] " << msg << endl;
+/**
+ * @brief Perilaku saat baris bentrok dengan PRIMARY/UNIQUE KEY yang sudah ada.
+ * Insert = error per baris (perilaku awal); Upsert = INSERT ... ON DUPLICATE KEY UPDATE
+ * dengan kebijakan per kolom; Ignore = INSERT IGNORE (baris lama dipertahankan);
+ * Staging = muat semua baris ke tabel sementara, lalu gabungkan dengan satu
+ * INSERT ... SELECT ... ON DUPLICATE KEY UPDATE (kebijakan sama dengan Upsert).
+ */
+enum class MergeMode { Insert, Upsert, Ignore, Staging };
+
+/**
+ * @brief Nilai akhir satu kolom saat baris bentrok (Upsert/Staging).
+ */
+enum class MergePolicy {
+    Overwrite,    // Nilai baru menimpa
+    KeepExisting, // Kolom tidak diubah
+    Coalesce,     // Nilai baru, kecuali NULL
+    Sum,          // Lama + baru (NULL dianggap 0)
+    Max,
+    Min
+};
+
+struct MergeOptions {
+    MergeMode mode = MergeMode::Insert;
+    map<string, MergePolicy> policies; // Kolom tanpa entri = Overwrite
+};
+
+/**
+ * @struct DedupeOptions
+ * Tahap dedupe opsional di impor: baris yang nilai keyColumns-nya sudah pernah
+ * terlihat di file yang sama dibuang sebelum dikirim ke MySQL. Impor yang
+ * dilanjutkan dari checkpoint hanya membandingkan baris setelah checkpoint.
+ */
+struct DedupeOptions {
+    vector<string> keyColumns;        // Kosong = nonaktif; {"*"} = seluruh baris
+    bool bloom = false;               // true = langsung Bloom filter (memori tetap)
+    size_t maxExactKeys = 4000000;    // Batas hash set eksak (~8 B/kunci + overhead) sebelum beralih ke Bloom
+    size_t bloomBits = size_t(1) << 27; // 16 MB; ~0.2% false positive pada 10 juta kunci
+};
+
+/**
+ * @struct ImportOptions
+ * Opsi importFromCSV. Baris di-commit per 'batchSize' dan checkpoint
+ * disimpan di transaksi yang sama sehingga impor yang terhenti bisa dilanjutkan.
+ * Mode Staging memuat seluruh file sebelum digabung, jadi tidak dilanjutkan per batch.
+ */
+struct ImportOptions {
+    size_t batchSize = 1000;
+    bool restart = false; // true = abaikan checkpoint dan mulai dari baris pertama
+    MergeOptions merge;
+    DedupeOptions dedupe;
+};
+
+/**
+ * @struct ImportCheckpoint
+ * Identitas file (path kanonik, ukuran, hash 64 KB pertama) dan posisi
+ * terakhir yang sudah di-commit. Disimpan di tabel _dbm_import_checkpoints.
+ */
+struct ImportCheckpoint {
+    string fileKey;
+    uint64_t fileSize = 0;
+    uint64_t headHash = 0;
+    int64_t byteOffset = -1; // -1 = tidak bisa seek (file terkompresi), lanjutkan dengan melewati baris
+    uint64_t lineNumber = 0;
+    uint64_t rowsCommitted = 0;
+    bool completed = false;
+};
+
+/**
+ * @brief Hash FNV-1a 64-bit. Cukup cepat untuk identitas file dan kunci hash.
+ */
+static uint64_t fnv1a64(const char* data, size_t len, uint64_t hash = 1469598103934665603ULL) {
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
     }
+    return hash;
+}
 
-    /**
-     * @brief [BARU] Memvalidasi string untuk keamanan identifier SQL.
-     * Mencegah SQL injection pada nama tabel/database.
-     */
-    bool isValidIdentifier(const string& name) {
-        if (name.empty() || name.length() > 64) {
-            cerr << "Error: Nama identifier tidak boleh kosong atau lebih dari 64 karakter." << endl;
-            return false;
+/**
+ * @brief Mengisi identitas file untuk checkpoint impor. False jika file tidak bisa dibaca.
+ */
+static bool readFileIdentity(const string& path, ImportCheckpoint& cp) {
+    error_code ec;
+    filesystem::path canonical = filesystem::weakly_canonical(filesystem::path(path), ec);
+    cp.fileKey = ec ? path : canonical.string();
+    cp.fileSize = filesystem::file_size(path, ec);
+    if (ec) return false;
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) return false;
+    vector<char> head(64 * 1024);
+    in.read(head.data(), (streamsize)head.size());
+    cp.headHash = fnv1a64(head.data(), (size_t)in.gcount());
+    if (cp.fileKey.size() > 255) cp.fileKey = cp.fileKey.substr(cp.fileKey.size() - 255); // batas kolom
+    return true;
+}
+
+/**
+ * @struct SensorReading
+ * Satu baris tabel sensor ingest (ESP32). Pengukuran yang tidak dikirim = NULL.
+ */
+struct SensorReading {
+    string timestamp; // DATETIME(6): "YYYY-MM-DD HH:MM:SS.ffffff"
+    optional<double> temperature;
+    optional<double> humidity;
+    optional<double> airQuality;
+};
+
+/**
+ * @struct AppUsage
+ * Satu baris tabel pemakaian aplikasi (Android): satu package per laporan.
+ */
+struct AppUsage {
+    string timestamp;
+    string package;
+    optional<string> appName;
+    string category;                    // Kosong = diisi dari appCategory(package) saat ingest
+    int64_t foregroundTimeSeconds = 0;
+    int64_t totalScreenTimeSeconds = 0; // Total kumulatif perangkat saat laporan dikirim
+};
+
+/**
+ * @struct ColumnDescriptor
+ * Pemetaan satu kolom SQL ke anggota record, dievaluasi saat kompilasi.
+ * Tipe anggota menentukan bind/encode/decode: string, double, int64_t,
+ * atau optional<...> untuk kolom NULL-able.
+ */
+template <typename Record, typename Field>
+struct ColumnDescriptor {
+    const char* name;
+    Field Record::*member;
+};
+
+template <typename Record, typename Field>
+constexpr ColumnDescriptor<Record, Field> recordColumn(const char* name, Field Record::*member) {
+    return {name, member};
+}
+
+/**
+ * @struct RecordSchema
+ * Skema tetap per tipe record: tabel bawaan dan kolom dalam urutan bind.
+ * Hanya dispesialisasi untuk tabel panas yang skemanya diketahui; tabel lain
+ * tetap memakai jalur generik (kolom dan nilai berupa string).
+ */
+template <typename Record>
+struct RecordSchema;
+
+template <>
+struct RecordSchema<SensorReading> {
+    static constexpr const char* defaultTable = "sensor_data";
+    static constexpr auto columns = make_tuple(
+        recordColumn("timestamp", &SensorReading::timestamp),
+        recordColumn("temperature", &SensorReading::temperature),
+        recordColumn("humidity", &SensorReading::humidity),
+        recordColumn("air_quality", &SensorReading::airQuality));
+};
+
+template <>
+struct RecordSchema<AppUsage> {
+    static constexpr const char* defaultTable = "usage_events";
+    static constexpr auto columns = make_tuple(
+        recordColumn("timestamp", &AppUsage::timestamp),
+        recordColumn("package", &AppUsage::package),
+        recordColumn("app_name", &AppUsage::appName),
+        recordColumn("category", &AppUsage::category),
+        recordColumn("foreground_time_s", &AppUsage::foregroundTimeSeconds),
+        recordColumn("total_screen_time_s", &AppUsage::totalScreenTimeSeconds));
+};
+
+/**
+ * @brief Memanggil f(descriptor) untuk setiap kolom Record, berurutan (di-unroll saat kompilasi).
+ */
+template <typename Record, typename F>
+static void forEachColumn(F&& f) {
+    apply([&](const auto&... column) { (f(column), ...); }, RecordSchema<Record>::columns);
+}
+
+template <typename Record>
+static constexpr size_t recordColumnCount() {
+    return tuple_size_v<decay_t<decltype(RecordSchema<Record>::columns)>>;
+}
+
+/** @brief Nama kolom Record dalam urutan bind (dibangun sekali). */
+template <typename Record>
+static const vector<string>& recordColumnNames() {
+    static const vector<string> names = [] {
+        vector<string> out;
+        forEachColumn<Record>([&](const auto& column) { out.push_back(column.name); });
+        return out;
+    }();
+    return names;
+}
+
+/**
+ * @brief Baris bertipe di RowSet. monostate = RowSet memakai baris generik.
+ */
+using TypedRows = variant<monostate, vector<SensorReading>, vector<AppUsage>>;
+
+/**
+ * @struct QueryResult
+ * Hasil runStatement: kolom dan baris untuk SELECT (nullopt = NULL),
+ * atau jumlah baris terpengaruh untuk DML.
+ */
+struct QueryResult {
+    vector<string> columns;
+    vector<vector<optional<string>>> rows;
+    uint64_t affectedRows = 0;
+};
+
+/**
+ * @struct RowSet
+ * Sekumpulan baris untuk satu tabel, dimasukkan lewat insertRowSets.
+ * Jalur generik: setiap baris di 'rows' memiliki jumlah nilai sama dengan
+ * 'columns' (nullopt = NULL). Jalur bertipe: 'records' berisi SensorReading/
+ * AppUsage, 'columns' = recordColumnNames<Record>() dan 'rows' kosong.
+ */
+struct RowSet {
+    string table;
+    vector<string> columns;
+    vector<vector<optional<string>>> rows;
+    TypedRows records;
+
+    size_t rowCount() const {
+        return visit([this](const auto& typed) -> size_t {
+            if constexpr (is_same_v<decay_t<decltype(typed)>, monostate>) return rows.size();
+            else return typed.size();
+        }, records);
+    }
+
+    bool sameShape(const RowSet& o) const {
+        return table == o.table && columns == o.columns && records.index() == o.records.index();
+    }
+};
+
+/**
+ * @brief Memanggil f(vector baris) milik 's': 'rows' generik atau vector record bertipe.
+ */
+template <typename Set, typename F>
+static void visitRows(Set& s, F&& f) {
+    if (holds_alternative<monostate>(s.records)) {
+        f(s.rows);
+        return;
+    }
+    visit([&](auto& typed) {
+        if constexpr (!is_same_v<decay_t<decltype(typed)>, monostate>) f(typed);
+    }, s.records);
+}
+
+/**
+ * @brief Memindahkan baris [offset, offset+n) dari 'from' ke akhir 'to'.
+ * 'to' harus kosong atau berbentuk sama (sameShape) dengan 'from'.
+ */
+static void moveRows(RowSet& from, size_t offset, size_t n, RowSet& to) {
+    visitRows(from, [&](auto& src) {
+        using Rows = decay_t<decltype(src)>;
+        Rows* dst;
+        if constexpr (is_same_v<Rows, decltype(RowSet::rows)>) {
+            dst = &to.rows;
+        } else {
+            if (!holds_alternative<Rows>(to.records)) to.records = Rows();
+            dst = &get<Rows>(to.records);
         }
-        // Hanya izinkan alfanumerik dan underscore. Tidak boleh dimulai dengan angka.
-        // Ini adalah perlindungan kritis terhadap SQL injection pada identifier.
-        static const regex idRegex("^[a-zA-Z_][a-zA-Z0-9_]*$");
-        if (!regex_match(name, idRegex)) {
-            cerr << "Error: Nama '" << name << "' mengandung karakter tidak valid. Hanya [a-zA-Z0-9_] yang diizinkan dan harus diawali dengan huruf atau _." << endl;
-            return false;
+        auto first = src.begin() + static_cast<ptrdiff_t>(offset);
+        dst->insert(dst->end(), make_move_iterator(first), make_move_iterator(first + static_cast<ptrdiff_t>(n)));
+    });
+}
+
+static const size_t MULTI_INSERT_MAX_ROWS = 1000;    // Baris per statement INSERT multi-baris
+static const size_t MULTI_INSERT_MAX_PARAMS = 60000; // Di bawah batas 65535 placeholder MySQL
+static const uint64_t DML_PREVIEW_LIMIT = 10000;     // Batas COUNT pratinjau update/delete interaktif
+static const size_t EXPORT_BATCH_ROWS = 1024;        // Baris per RowBatch saat ekspor/backup
+
+/**
+ * @brief Membaca daftar kebijakan "kolom=kebijakan,..." (overwrite, keep, coalesce,
+ * sum, max, min). Mengembalikan false jika ada entri yang tidak dikenal.
+ */
+static bool parseMergePolicies(const string& text, map<string, MergePolicy>& policies) {
+    static const map<string, MergePolicy> names = {
+        {"overwrite", MergePolicy::Overwrite}, {"keep", MergePolicy::KeepExisting}, {"coalesce", MergePolicy::Coalesce},
+        {"sum", MergePolicy::Sum}, {"max", MergePolicy::Max}, {"min", MergePolicy::Min}};
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        item.erase(remove_if(item.begin(), item.end(), [](unsigned char ch) { return isspace(ch); }), item.end());
+        if (item.empty()) continue;
+        size_t eq = item.find('=');
+        if (eq == string::npos) return false;
+        auto it = names.find(item.substr(eq + 1));
+        if (it == names.end()) return false;
+        policies[item.substr(0, eq)] = it->second;
+    }
+    return true;
+}
+
+/**
+ * @brief Kolom kebijakan merge yang tidak ada di 'columns' (kosong jika semua valid).
+ */
+static string unknownMergeColumn(const vector<string>& columns, const MergeOptions& merge) {
+    for (const auto& entry : merge.policies) {
+        if (find(columns.begin(), columns.end(), entry.first) == columns.end()) return entry.first;
+    }
+    return "";
+}
+
+/**
+ * @brief Awal statement INSERT sesuai mode merge: "INSERT [IGNORE] INTO `t` (`a`,`b`)".
+ */
+static string insertPrefixSQL(const string& table, const vector<string>& columns, const MergeOptions& merge) {
+    string sql = string(merge.mode == MergeMode::Ignore ? "INSERT IGNORE INTO `" : "INSERT INTO `") + table + "` (";
+    for (size_t i = 0; i < columns.size(); ++i) {
+        sql += (i ? ",`" : "`") + columns[i] + "`";
+    }
+    return sql + ")";
+}
+
+/**
+ * @brief Klausa " ON DUPLICATE KEY UPDATE ..." untuk Upsert/Staging (kosong untuk mode lain).
+ * Nilai lama dirujuk dengan nama tabel agar tidak ambigu pada INSERT ... SELECT.
+ */
+static string mergeUpdateClause(const string& table, const vector<string>& columns, const MergeOptions& merge) {
+    if (merge.mode != MergeMode::Upsert && merge.mode != MergeMode::Staging) return "";
+    string clause;
+    for (const string& c : columns) {
+        auto it = merge.policies.find(c);
+        MergePolicy policy = it == merge.policies.end() ? MergePolicy::Overwrite : it->second;
+        const string col = "`" + c + "`", old = "`" + table + "`." + col, val = "VALUES(" + col + ")";
+        string expr;
+        switch (policy) {
+            case MergePolicy::Overwrite: expr = val; break;
+            case MergePolicy::KeepExisting: continue;
+            case MergePolicy::Coalesce: expr = "COALESCE(" + val + ", " + old + ")"; break;
+            case MergePolicy::Sum: expr = "COALESCE(" + old + ", 0) + COALESCE(" + val + ", 0)"; break;
+            case MergePolicy::Max: expr = "GREATEST(COALESCE(" + old + ", " + val + "), COALESCE(" + val + ", " + old + "))"; break;
+            case MergePolicy::Min: expr = "LEAST(COALESCE(" + old + ", " + val + "), COALESCE(" + val + ", " + old + "))"; break;
         }
-        return true;
+        clause += (clause.empty() ? "" : ", ") + col + " = " + expr;
     }
+    if (clause.empty()) clause = "`" + columns[0] + "` = `" + table + "`.`" + columns[0] + "`"; // Semua 'keep': no-op
+    return " ON DUPLICATE KEY UPDATE " + clause;
+}
 
-    /**
-     * @brief Mendapatkan daftar kolom dan tipenya untuk sebuah tabel.
-     * Digunakan oleh fungsi interaktif (insert, update, select).
-     */
-    map<string, string> getTableColumns(const string& tableName) {
-        // Asumsi: tableName sudah divalidasi oleh pemanggil
-        // Asumsi: dbMutex sudah di-lock oleh pemanggil
-        map<string, string> columns;
-        try {
-            unique_ptr<sql::Statement> stmt(conn->createStatement());
-            unique_ptr<sql::ResultSet> res(stmt->executeQuery("DESCRIBE `" + tableName + "`"));
-            while (res->next()) {
-                columns[res->getString("Field")] = res->getString("Type");
-            }
-        } catch (sql::SQLException& e) {
-            writeLog("Error getTableColumns: " + string(e.what()));
-            // Biarkan map kosong, pemanggil akan menanganinya
+/**
+ * @brief Menyusun "INSERT [IGNORE] INTO t (a,b) VALUES (?,?),(?,?),... [ON DUPLICATE KEY UPDATE ...]"
+ * untuk 'rows' baris. Asumsi: tabel dan kolom sudah divalidasi oleh pemanggil.
+ */
+static string multiRowInsertSQL(const string& table, const vector<string>& columns, size_t rows,
+                                const MergeOptions& merge = MergeOptions()) {
+    string sql = insertPrefixSQL(table, columns, merge) + " VALUES ";
+    string tuple = "(";
+    for (size_t i = 0; i < columns.size(); ++i) {
+        tuple += i ? ",?" : "?";
+    }
+    tuple += ")";
+    string suffix = mergeUpdateClause(table, columns, merge);
+    sql.reserve(sql.size() + rows * (tuple.size() + 1) + suffix.size());
+    for (size_t r = 0; r < rows; ++r) {
+        if (r > 0) sql += ",";
+        sql += tuple;
+    }
+    return sql + suffix;
+}
+
+// --- THREAD POOL ---
+
+/**
+ * @class ThreadPool
+ * Pool worker berukuran tetap. submit() mengembalikan future dari hasil tugas.
+ * Destruktor menunggu semua tugas yang sudah diantrekan selesai.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t numThreads) {
+        if (numThreads == 0) numThreads = 1;
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
         }
-        return columns;
     }
 
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueCv.notify_all();
+        for (auto& t : workers) {
+            if (t.joinable()) t.join();
+        }
+    }
 
-    /**
-     * @brief Memeriksa apakah database ada (versi unlocked).
-     * Pemanggil harus memegang dbMutex.
-     */
-    bool databaseExistsUnlocked(const string& name) {
-        // Asumsi: 'name' sudah divalidasi oleh pemanggil jika input dari user
-        try {
-            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
-                "SELECT SCHEMA_NAME FROM INFORMATION_SCHEMA.SCHEMATA WHERE SCHEMA_NAME = ?"
-            ));
-            pstmt->setString(1, name);
-            unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
-            return res->next();
-        } catch (sql::SQLException& e) {
-            writeLog(string("Error checking database existence: ") + e.what());
-            return false;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <class F>
+    auto submit(F&& f) -> future<invoke_result_t<decay_t<F>>> {
+        using R = invoke_result_t<decay_t<F>>;
+        auto task = make_shared<packaged_task<R()>>(std::forward<F>(f));
+        future<R> result = task->get_future();
+        {
+            lock_guard<mutex> lock(queueMutex);
+            tasks.emplace_back([task]() { (*task)(); });
         }
+        queueCv.notify_one();
+        return result;
     }
 
+    size_t size() const { return workers.size(); }
+
     /**
-     * @brief Mem-parsing satu baris CSV, menangani tanda kutip.
+     * @brief Jumlah thread default: jumlah core, dibatasi ke [1, maxThreads].
      */
-    vector<string> parseCSVLine(const string& line) {
-        vector<string> fields;
-        stringstream ss(line);
-        string field;
-        bool inQuotes = false;
-        char c;
-        while (ss.get(c)) {
-            if (inQuotes) {
-                if (c == '"') {
-                    if (ss.peek() == '"') {
-                        field += '"';
-                        ss.get();
-                    } else {
-                        inQuotes = false;
-                    }
-                } else {
-                    field += c;
-                }
-            } else {
-                if (c == '"') {
-                    inQuotes = true;
-                } else if (c == ',') {
-                    fields.push_back(field);
-                    field.clear();
-                } else if (c != '\r') {
-                    field += c;
-                }
+    static size_t defaultThreads(size_t maxThreads = 8) {
+        size_t hw = thread::hardware_concurrency();
+        return max<size_t>(1, min<size_t>(hw == 0 ? 2 : hw, maxThreads));
+    }
+
+private:
+    vector<thread> workers;
+    deque<function<void()>> tasks;
+    mutex queueMutex;
+    condition_variable queueCv;
+    bool stopping = false;
+
+    void workerLoop() {
+        while (true) {
+            function<void()> task;
+            {
+                unique_lock<mutex> lock(queueMutex);
+                queueCv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if (tasks.empty()) return; // stopping dan antrean kosong
+                task = std::move(tasks.front());
+                tasks.pop_front();
             }
+            task();
         }
-        fields.push_back(field);
-        return fields;
     }
+};
 
+// --- METRIK ---
 
+/**
+ * @class MetricCounter
+ * Penghitung monoton (hanya naik). Lock-free.
+ */
+class MetricCounter {
 public:
-    DatabaseManager(const string& host, const string& user, const string& pass) : driver(nullptr) {
-        try {
-            driver = sql::mysql::get_mysql_driver_instance();
-            conn.reset(driver->connect(host, user, pass));
-            conn->setAutoCommit(true);
-        } catch (sql::SQLException& e) {
-            cerr << "Koneksi ke MySQL gagal: " << e.what() << endl;
-            throw runtime_error(string("Koneksi ke MySQL gagal: ") + e.what());
-        }
-        logFile.open("db_operations.log", ios::app);
-        if (!logFile.is_open()) {
-            cerr << "Gagal membuka file log db_operations.log" << endl;
-        }
-        writeLog("DatabaseManager diinisialisasi.");
+    void add(uint64_t n = 1) { value.fetch_add(n, memory_order_relaxed); }
+    uint64_t get() const { return value.load(memory_order_relaxed); }
+
+private:
+    atomic<uint64_t> value{0};
+};
+
+/**
+ * @class MetricGauge
+ * Nilai yang bisa naik-turun (mis. kedalaman antrean). Beberapa pemilik
+ * boleh berbagi satu gauge selama mereka hanya memakai add() (delta).
+ */
+class MetricGauge {
+public:
+    void set(int64_t v) { value.store(v, memory_order_relaxed); }
+    void add(int64_t delta) { value.fetch_add(delta, memory_order_relaxed); }
+    int64_t get() const { return value.load(memory_order_relaxed); }
+
+private:
+    atomic<int64_t> value{0};
+};
+
+/**
+ * @class MetricHistogram
+ * Histogram dengan batas bucket tetap (semantik 'le' Prometheus:
+ * observasi v masuk ke bucket pertama dengan batas >= v).
+ */
+class MetricHistogram {
+public:
+    explicit MetricHistogram(vector<double> upperBounds)
+        : bounds(std::move(upperBounds)), buckets(bounds.size() + 1) {
+        sort(bounds.begin(), bounds.end());
     }
 
-    ~DatabaseManager() {
-        writeLog("DatabaseManager ditutup.");
-        if (logFile.is_open()) logFile.close();
+    void observe(double v) {
+        size_t i = lower_bound(bounds.begin(), bounds.end(), v) - bounds.begin();
+        buckets[i].fetch_add(1, memory_order_relaxed);
+        count.fetch_add(1, memory_order_relaxed);
+        double old = sum.load(memory_order_relaxed);
+        while (!sum.compare_exchange_weak(old, old + v, memory_order_relaxed)) {}
     }
 
-    string getCurrentDB() const {
-        return currentDB;
+    const vector<double>& upperBounds() const { return bounds; }
+    uint64_t bucketCount(size_t i) const { return buckets[i].load(memory_order_relaxed); } // i == bounds.size(): +Inf
+    uint64_t total() const { return count.load(memory_order_relaxed); }
+    double totalSum() const { return sum.load(memory_order_relaxed); }
+
+private:
+    vector<double> bounds;
+    vector<atomic<uint64_t>> buckets;
+    atomic<uint64_t> count{0};
+    atomic<double> sum{0};
+};
+
+/**
+ * @class MetricsRegistry
+ * Registri metrik proses. Metrik dibuat saat pertama diminta dan alamatnya
+ * stabil, jadi pemanggil cukup menyimpan referensinya sekali. Nama boleh
+ * memuat label, mis. "dbm_x_total{reason=\"size\"}" (tidak untuk histogram).
+ * renderText() menghasilkan format teks Prometheus.
+ */
+class MetricsRegistry {
+public:
+    MetricCounter& counter(const string& name, const string& help) {
+        lock_guard<mutex> lock(registryMutex);
+        Entry& e = entries[name];
+        if (!e.counter) {
+            e.help = help;
+            e.counter = make_unique<MetricCounter>();
+        }
+        return *e.counter;
     }
 
-    // --- OPERASI DATABASE ---
+    MetricGauge& gauge(const string& name, const string& help) {
+        lock_guard<mutex> lock(registryMutex);
+        Entry& e = entries[name];
+        if (!e.gauge) {
+            e.help = help;
+            e.gauge = make_unique<MetricGauge>();
+        }
+        return *e.gauge;
+    }
 
-    bool createDatabase(const string& name) {
-        if (!isValidIdentifier(name)) return false; // Keamanan
+    MetricHistogram& histogram(const string& name, const string& help, const vector<double>& upperBounds) {
+        lock_guard<mutex> lock(registryMutex);
+        Entry& e = entries[name];
+        if (!e.histogram) {
+            e.help = help;
+            e.histogram = make_unique<MetricHistogram>(upperBounds);
+        }
+        return *e.histogram;
+    }
 
-        lock_guard<mutex> lock(dbMutex);
-        try {
-            if (!conn) {
-                cerr << "Belum terhubung ke server." << endl;
-                return false;
-            }
-            if (databaseExistsUnlocked(name)) {
-                cout << "Database '" << name << "' sudah ada. Tidak dapat membuat duplikat." << endl;
-                writeLog("Gagal membuat database (duplikat): " + name);
-                return false;
+    string renderText() const {
+        lock_guard<mutex> lock(registryMutex);
+        ostringstream out;
+        string lastBase;
+        for (const auto& [name, e] : entries) {
+            string base = name.substr(0, name.find('{'));
+            if (base != lastBase) {
+                const char* type = e.counter ? "counter" : e.gauge ? "gauge" : "histogram";
+                out << "# HELP " << base << " " << e.help << "\n# TYPE " << base << " " << type << "\n";
+                lastBase = base;
             }
-            unique_ptr<sql::Statement> stmt(conn->createStatement());
-            // Aman karena 'name' sudah divalidasi
-            stmt->execute("CREATE DATABASE `" + name + "`");
-            cout << "Database '" << name << "' berhasil dibuat." << endl;
-            writeLog("Membuat database: " + name);
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error membuat database: " << e.what() << endl;
-            writeLog(string("Error membuat database: ") + e.what());
-            return false;
-        }
-    }
-
-    bool listDatabases() {
-        try {
-            unique_ptr<sql::Statement> stmt;
-            unique_ptr<sql::ResultSet> res;
-            {
-                lock_guard<mutex> lock(dbMutex);
-                if (!conn) {
-                    cerr << "Belum terhubung ke server." << endl;
-                    return false;
+            if (e.counter) out << name << " " << e.counter->get() << "\n";
+            if (e.gauge) out << name << " " << e.gauge->get() << "\n";
+            if (e.histogram) {
+                const MetricHistogram& h = *e.histogram;
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < h.upperBounds().size(); ++i) {
+                    cumulative += h.bucketCount(i);
+                    out << name << "_bucket{le=\"" << h.upperBounds()[i] << "\"} " << cumulative << "\n";
                 }
-                stmt.reset(conn->createStatement());
-                res.reset(stmt->executeQuery("SHOW DATABASES"));
-            }
-            cout << "\nDaftar Database:\n";
-            cout << string(20, '-') << "\n";
-            bool found = false;
-            while (res->next()) {
-                cout << " - " << res->getString(1) << "\n";
-                found = true;
+                cumulative += h.bucketCount(h.upperBounds().size());
+                out << name << "_bucket{le=\"+Inf\"} " << cumulative << "\n"
+                    << name << "_sum " << h.totalSum() << "\n"
+                    << name << "_count " << h.total() << "\n";
             }
-            if (!found) cout << "(tidak ada database)\n";
-            cout << string(20, '-') << "\n";
-            writeLog("Mendaftar database.");
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Gagal menampilkan daftar database. (" << e.what() << ")\n";
-            writeLog(string("Gagal menampilkan daftar database: ") + e.what());
-            return false;
         }
+        return out.str();
     }
 
-    bool dropDatabase(const string& name) {
-        if (!isValidIdentifier(name)) return false; // Keamanan
+private:
+    struct Entry {
+        string help;
+        unique_ptr<MetricCounter> counter;
+        unique_ptr<MetricGauge> gauge;
+        unique_ptr<MetricHistogram> histogram;
+    };
+    mutable mutex registryMutex;
+    map<string, Entry> entries; // Terurut: metrik berlabel dengan nama dasar sama tampil berdekatan
+};
 
-        lock_guard<mutex> lock(dbMutex);
-        try {
-            if (!conn) {
-                cerr << "Belum terhubung ke server." << endl;
-                return false;
-            }
-            unique_ptr<sql::Statement> stmt(conn->createStatement());
-            // Aman karena 'name' sudah divalidasi
-            stmt->execute("DROP DATABASE IF EXISTS `" + name + "`");
-            cout << "Database '" << name << "' dihapus (jika ada)." << endl;
-            writeLog("Menghapus database: " + name);
-            if (currentDB == name) currentDB.clear();
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error menghapus database: " << e.what() << endl;
-            writeLog(string("Error menghapus database: ") + e.what());
-            return false;
-        }
-    }
+/**
+ * @brief Registri metrik global proses.
+ */
+static MetricsRegistry& metrics() {
+    static MetricsRegistry registry;
+    return registry;
+}
 
-    bool useDatabase(const string& name) {
-        if (!isValidIdentifier(name)) return false; // Keamanan
+// --- TRACING ---
 
-        lock_guard<mutex> lock(dbMutex);
-        try {
-            if (!conn) {
-                cerr << "Belum terhubung ke server." << endl;
-                return false;
-            }
-            // 'databaseExistsUnlocked' menggunakan prepared statement, jadi aman
-            if (!databaseExistsUnlocked(name)) {
-                cout << "Database '" << name << "' tidak ditemukan." << endl;
-                return false;
+/**
+ * @struct TraceEvent
+ * Satu zona waktu (event 'X' Chrome trace). Nama, kategori, dan nama argumen
+ * harus string literal: event disimpan tanpa alokasi.
+ */
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    int64_t startUs;
+    int64_t durUs;
+    const char* argNames[2];
+    int64_t argValues[2];
+};
+
+/**
+ * @class Tracer
+ * Perekam timeline proses. Setiap thread menulis ke buffer miliknya sendiri
+ * (mutex per buffer, hanya diperebutkan saat ekspor), sehingga thread tidak
+ * saling menunggu. Saat tidak aktif, biaya per zona hanya satu load atomik.
+ * Hasil diekspor sebagai Chrome trace JSON (chrome://tracing, Perfetto, atau
+ * diimpor ke Tracy lewat tracy-import-chrome).
+ */
+class Tracer {
+public:
+    static const size_t MAX_EVENTS_PER_THREAD = 1 << 20; // ~64 MiB per thread, sisanya dihitung sebagai 'dropped'
+
+    bool enabled() const { return on.load(memory_order_relaxed); }
+
+    /** @brief Mengosongkan semua buffer dan mulai merekam dari t=0. */
+    void start() {
+        {
+            lock_guard<mutex> lock(listMutex);
+            // Buffer thread yang sudah selesai (hanya dipegang daftar ini) dibuang
+            buffers.erase(remove_if(buffers.begin(), buffers.end(),
+                                    [](const shared_ptr<ThreadBuffer>& b) { return b.use_count() == 1; }),
+                          buffers.end());
+            for (auto& b : buffers) {
+                lock_guard<mutex> bufLock(b->m);
+                b->events.clear();
+                b->dropped = 0;
             }
-            conn->setSchema(name);
-            currentDB = name;
-            cout << "Berhasil menggunakan database: " << name << endl;
-            writeLog("Menggunakan database: " + name);
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error menggunakan database: " << e.what() << endl;
-            writeLog(string("Error menggunakan database: ") + e.what());
-            return false;
         }
+        epochUs.store(steadyUs(), memory_order_relaxed);
+        on.store(true, memory_order_release);
     }
 
-    // --- OPERASI TABEL ---
+    void stop() { on.store(false, memory_order_release); }
 
-    bool createTable(const string& tableName, const string& columnsDef) {
-        if (!isValidIdentifier(tableName)) return false; // Keamanan
-        if (columnsDef.empty()) {
-            cout << "Definisi kolom kosong." << endl;
-            return false;
-        }
-        
-        // Peringatan: columnsDef masih rentan, tapi sulit divalidasi
-        // Ini adalah risiko yang harus diterima pengguna fitur ini.
-        if (columnsDef.find_first_of(";'\"") != string::npos) {
-             cout << "Peringatan: Definisi kolom mungkin mengandung karakter tidak aman. Lanjutkan? (y/n): ";
-             char c;
-             cin >> c;
-             cin.ignore(numeric_limits<streamsize>::max(), '\n');
-             if (c != 'y' && c != 'Y') {
-                cout << "Pembuatan tabel dibatalkan." << endl;
-                return false;
-             }
+    int64_t nowUs() const { return steadyUs() - epochUs.load(memory_order_relaxed); }
+
+    void record(const TraceEvent& e) {
+        ThreadBuffer& b = local();
+        lock_guard<mutex> lock(b.m);
+        if (b.events.size() >= MAX_EVENTS_PER_THREAD) {
+            b.dropped++;
+            return;
         }
+        b.events.push_back(e);
+    }
 
+    /** @brief Memberi nama thread pemanggil di timeline (mis. "ingest-writer-2"). */
+    void setThreadName(const string& name) {
+        ThreadBuffer& b = local();
+        lock_guard<mutex> lock(b.m);
+        b.name = name;
+    }
 
-        lock_guard<mutex> lock(dbMutex);
-        try {
-            if (currentDB.empty()) {
-                cout << "Pilih database terlebih dahulu!" << endl;
-                return false;
-            }
-            unique_ptr<sql::Statement> stmt(conn->createStatement());
-            // Aman untuk tableName, tapi columnsDef masih berisiko
-            string query = "CREATE TABLE `" + tableName + "` (" + columnsDef + ")";
-            stmt->execute(query);
-            cout << "Tabel '" << tableName << "' berhasil dibuat." << endl;
-            writeLog("Membuat tabel: " + tableName + " di " + currentDB);
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error membuat tabel: " << e.what() << endl;
-            writeLog(string("Error membuat tabel: ") + e.what());
+    /** @brief Menulis semua event ke 'path' dalam format Chrome trace JSON. */
+    bool exportChromeTrace(const string& path) {
+        ofstream out(path);
+        if (!out.is_open()) {
+            cerr << "Gagal membuka file trace: " << path << endl;
             return false;
         }
-    }
-
-    bool listTables() {
-        unique_ptr<sql::ResultSet> res;
+        vector<shared_ptr<ThreadBuffer>> snapshot;
         {
-            lock_guard<mutex> lock(dbMutex);
-            try {
-                if (currentDB.empty()) {
-                    cout << "Pilih database terlebih dahulu!" << endl;
-                    return false;
+            lock_guard<mutex> lock(listMutex);
+            snapshot = buffers;
+        }
+        size_t total = 0;
+        uint64_t dropped = 0;
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        auto sep = [&]() -> ostream& {
+            if (!first) out << ",\n";
+            first = false;
+            return out;
+        };
+        for (auto& b : snapshot) {
+            lock_guard<mutex> lock(b->m);
+            string name = b->name.empty() ? "thread-" + to_string(b->tid) : b->name;
+            sep() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid
+                  << ",\"args\":{\"name\":\"" << jsonSafe(name) << "\"}}";
+            for (const TraceEvent& e : b->events) {
+                sep() << "{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category << "\",\"ph\":\"X\",\"ts\":" << e.startUs
+                      << ",\"dur\":" << e.durUs << ",\"pid\":1,\"tid\":" << b->tid;
+                if (e.argNames[0]) {
+                    out << ",\"args\":{\"" << e.argNames[0] << "\":" << e.argValues[0];
+                    if (e.argNames[1]) out << ",\"" << e.argNames[1] << "\":" << e.argValues[1];
+                    out << "}";
                 }
-                unique_ptr<sql::Statement> stmt(conn->createStatement());
-                res.reset(stmt->executeQuery("SHOW TABLES"));
-            } catch (sql::SQLException& e) {
-                cerr << "Error mendaftar tabel: " << e.what() << endl;
-                writeLog(string("Error mendaftar tabel: ") + e.what());
-                return false;
+                out << "}";
             }
+            total += b->events.size();
+            dropped += b->dropped;
         }
-
-        cout << "\nDaftar tabel di " << currentDB << ":" << endl;
-        cout << string(20, '-') << "\n";
-        bool any = false;
-        while (res->next()) {
-            cout << " - " << res->getString(1) << endl;
-            any = true;
+        out << "\n],\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+        out.close();
+        if (out.fail()) {
+            cerr << "Gagal menulis file trace: " << path << endl;
+            return false;
         }
-        if (!any) cout << "(tidak ada tabel)\n";
-        cout << string(20, '-') << "\n";
-        writeLog("Mendaftar tabel di " + currentDB);
+        cout << total << " event dari " << snapshot.size() << " thread diekspor ke " << path;
+        if (dropped) cout << " (" << dropped << " event dibuang karena buffer penuh)";
+        cout << "." << endl;
         return true;
     }
 
-    bool dropTable(const string& name) {
-        if (!isValidIdentifier(name)) return false; // Keamanan
+private:
+    struct ThreadBuffer {
+        mutex m;
+        uint32_t tid = 0;
+        string name;
+        vector<TraceEvent> events;
+        uint64_t dropped = 0;
+    };
+
+    atomic<bool> on{false};
+    atomic<int64_t> epochUs{0};
+    mutex listMutex;
+    vector<shared_ptr<ThreadBuffer>> buffers;
+    atomic<uint32_t> nextTid{1};
+
+    static int64_t steadyUs() {
+        return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
 
-        lock_guard<mutex> lock(dbMutex);
-        try {
-            if (currentDB.empty()) {
-                cout << "Pilih database terlebih dahulu!" << endl;
-                return false;
-            }
-            unique_ptr<sql::Statement> stmt(conn->createStatement());
-            // Aman karena 'name' sudah divalidasi
-            stmt->execute("DROP TABLE IF EXISTS `" + name + "`");
-            cout << "Tabel '" << name << "' dihapus." << endl;
-            writeLog("Menghapus tabel: " + name + " di " + currentDB);
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error menghapus tabel: " << e.what() << endl;
-            writeLog(string("Error menghapus tabel: ") + e.what());
-            return false;
+    ThreadBuffer& local() {
+        thread_local shared_ptr<ThreadBuffer> mine;
+        if (!mine) {
+            mine = make_shared<ThreadBuffer>();
+            mine->tid = nextTid.fetch_add(1, memory_order_relaxed);
+            mine->events.reserve(4096);
+            lock_guard<mutex> lock(listMutex);
+            buffers.push_back(mine);
         }
+        return *mine;
     }
 
-    bool describeTable(const string& tableName) {
-        if (!isValidIdentifier(tableName)) return false; // Keamanan
-
-        unique_ptr<sql::ResultSet> res;
-        {
-            lock_guard<mutex> lock(dbMutex);
-            try {
-                if (currentDB.empty()) {
-                    cout << "Pilih database terlebih dahulu!" << endl;
-                    return false;
-                }
-                unique_ptr<sql::Statement> stmt(conn->createStatement());
-                // Aman karena 'tableName' sudah divalidasi
-                res.reset(stmt->executeQuery("DESCRIBE `" + tableName + "`"));
-            } catch (sql::SQLException& e) {
-                cerr << "Error mendeskripsikan tabel: " << e.what() << endl;
-                writeLog(string("Error mendeskripsikan tabel: ") + e.what());
-                return false;
-            }
+    static string jsonSafe(const string& s) {
+        string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20) out += c;
         }
+        return out;
+    }
+};
 
-        cout << "\nSkema tabel '" << tableName << "':" << endl;
-        cout << left << setw(20) << "Kolom" << setw(20) << "Tipe" << setw(10) << "Null" << setw(10) << "Kunci" << "Default" << "Extra" << endl;
-        cout << string(80, '-') << endl;
-        while (res->next()) {
-            cout << left << setw(20) << res->getString("Field")
-                 << setw(20) << res->getString("Type")
-                 << setw(10) << res->getString("Null")
-                 << setw(10) << res->getString("Key")
-                 << setw(10) << (res->isNull("Default") ? "NULL" : res->getString("Default"))
-                 << res->getString("Extra") << endl;
-        }
-        writeLog("Mendeskripsikan tabel: " + tableName);
-        return true;
+/**
+ * @brief Tracer global proses.
+ */
+static Tracer& tracer() {
+    static Tracer instance;
+    return instance;
+}
+
+/**
+ * @class TraceZone
+ * Zona RAII: mencatat durasi dari konstruksi sampai destruksi (atau end()).
+ * Konstruktor default membuat zona tertutup yang bisa dibuka dengan begin(),
+ * berguna untuk zona per batch di dalam loop.
+ */
+class TraceZone {
+public:
+    TraceZone() = default;
+    TraceZone(const char* name, const char* category) { begin(name, category); }
+    ~TraceZone() { end(); }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+    void begin(const char* name, const char* category) {
+        end();
+        if (!tracer().enabled()) return;
+        event = TraceEvent{name, category, tracer().nowUs(), 0, {nullptr, nullptr}, {0, 0}};
+        open = true;
     }
 
-    bool truncateTable(const string& tableName) {
-        if (!isValidIdentifier(tableName)) return false; // Keamanan
+    /** @brief Argumen numerik (maks 2 per zona); 'name' harus string literal. */
+    void arg(const char* name, int64_t value) {
+        if (!open) return;
+        int i = event.argNames[0] ? 1 : 0;
+        event.argNames[i] = name;
+        event.argValues[i] = value;
+    }
 
-        lock_guard<mutex> lock(dbMutex);
-        try {
-            if (currentDB.empty()) {
-                cout << "Pilih database terlebih dahulu!" << endl;
-                return false;
-            }
-            unique_ptr<sql::Statement> stmt(conn->createStatement());
-            // Aman karena 'tableName' sudah divalidasi
-            stmt->execute("TRUNCATE TABLE `" + tableName + "`");
-            cout << "Tabel '" << tableName << "' dipotong." << endl;
-            writeLog("Memotong tabel: " + tableName);
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error memotong tabel: " << e.what() << endl;
-            writeLog(string("Error memotong tabel: ") + e.what());
-            return false;
-        }
+    void end() {
+        if (!open) return;
+        open = false;
+        event.durUs = tracer().nowUs() - event.startUs;
+        tracer().record(event);
     }
 
-    // --- OPERASI DATA (INTERAKTIF & AMAN) ---
+    bool active() const { return open; }
 
-    bool insertData(const string& tableName) {
-        if (!isValidIdentifier(tableName)) return false; // Keamanan
+private:
+    TraceEvent event{};
+    bool open = false;
+};
 
-        lock_guard<mutex> lock(dbMutex);
-        try {
-            if (currentDB.empty()) {
-                cout << "Gunakan database terlebih dahulu!\n";
-                return false;
-            }
+/**
+ * @class TraceSession
+ * Merekam seluruh masa hidup objek ini dan mengekspornya saat dihancurkan.
+ * Dipakai main() untuk DBM_TRACE=<file.json>; path kosong/null = tidak aktif.
+ */
+class TraceSession {
+public:
+    explicit TraceSession(const char* path) : file(path ? path : "") {
+        if (!file.empty()) tracer().start();
+    }
+
+    ~TraceSession() {
+        if (file.empty()) return;
+        tracer().stop();
+        tracer().exportChromeTrace(file);
+    }
+
+private:
+    string file;
+};
+
+/**
+ * @class TracedMutex
+ * mutex yang, saat tracing aktif dan kunci sedang dipegang thread lain, mencatat
+ * waktu tunggu sebagai zona kategori "lock". Tanpa perebutan tidak ada event.
+ */
+class TracedMutex {
+public:
+    explicit TracedMutex(const char* waitZoneName) : zoneName(waitZoneName) {}
+
+    void lock() {
+        if (!tracer().enabled()) {
+            m.lock();
+            return;
+        }
+        if (m.try_lock()) return;
+        TraceZone wait(zoneName, "lock");
+        m.lock();
+    }
+
+    bool try_lock() { return m.try_lock(); }
+    void unlock() { m.unlock(); }
+
+private:
+    mutex m;
+    const char* zoneName;
+};
+
+// --- KOMPRESI PARALEL (gzip/zstd) ---
+
+/**
+ * Format kompresi file ekspor/backup/impor.
+ * Gzip ditulis sebagai rangkaian member gzip independen (multi-member, valid untuk gunzip).
+ * Setiap member membawa subfield FEXTRA 'MB' berisi ukuran member sehingga pembaca
+ * dapat memecah file tanpa inflate dan mendekompresi member secara paralel.
+ * Zstd ditulis sebagai rangkaian frame independen (multi-frame, valid untuk zstd -d).
+ */
+enum class Compression { None, Gzip, Zstd };
+
+static const size_t COMPRESS_BLOCK_SIZE = 1 << 20; // 1 MiB per blok/frame
+// Batas keluaran satu member/frame saat dekompresi; ukuran di header/trailer file tidak dipercaya
+static const size_t MAX_DECOMPRESSED_UNIT = 64 * COMPRESS_BLOCK_SIZE;
+static const size_t DEFLATE_MAX_RATIO = 1032; // Rasio maksimum deflate (zlib tech notes)
+static const int GZIP_LEVEL = 6;
+static const int ZSTD_LEVEL = 3;
+
+static bool endsWith(const string& s, const string& suffix) {
+    return s.size() >= suffix.size() && equal(suffix.rbegin(), suffix.rend(), s.rbegin(),
+        [](char a, char b) { return tolower((unsigned char)a) == tolower((unsigned char)b); });
+}
+
+/**
+ * @brief Menentukan kompresi output dari ekstensi file (.gz / .zst).
+ */
+Compression compressionFromPath(const string& path) {
+    if (endsWith(path, ".gz")) return Compression::Gzip;
+    if (endsWith(path, ".zst")) return Compression::Zstd;
+    return Compression::None;
+}
+
+bool compressionSupported(Compression kind) {
+    switch (kind) {
+        case Compression::None: return true;
+#ifdef DBM_HAVE_ZLIB
+        case Compression::Gzip: return true;
+#endif
+#ifdef DBM_HAVE_ZSTD
+        case Compression::Zstd: return true;
+#endif
+        default: return false;
+    }
+}
+
+static const char* compressionName(Compression kind) {
+    switch (kind) {
+        case Compression::Gzip: return "gzip";
+        case Compression::Zstd: return "zstd";
+        default: return "none";
+    }
+}
+
+static void putLE16(string& out, size_t pos, uint32_t v) {
+    out[pos] = (char)(v & 0xFF);
+    out[pos + 1] = (char)((v >> 8) & 0xFF);
+}
+
+static void putLE32(string& out, size_t pos, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out[pos + i] = (char)((v >> (8 * i)) & 0xFF);
+}
+
+static uint32_t getLE32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+#ifdef DBM_HAVE_ZLIB
+static const size_t GZ_MEMBER_HEADER = 20; // 10 header + 2 XLEN + 8 subfield 'MB'
+
+/**
+ * @brief Mengompresi satu blok menjadi satu member gzip lengkap (header + deflate + trailer).
+ */
+static string gzipCompressBlock(const char* data, size_t len) {
+    z_stream zs{};
+    if (deflateInit2(&zs, GZIP_LEVEL, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw runtime_error("deflateInit2 gagal");
+    }
+    string out(GZ_MEMBER_HEADER + deflateBound(&zs, (uLong)len) + 8, '\0');
+    const unsigned char header[12] = {0x1f, 0x8b, 8, 0x04 /* FEXTRA */, 0, 0, 0, 0, 0, 0xff, 8, 0};
+    memcpy(&out[0], header, sizeof(header));
+    out[12] = 'M';
+    out[13] = 'B';
+    putLE16(out, 14, 4);
+
+    zs.next_in = (Bytef*)data;
+    zs.avail_in = (uInt)len;
+    zs.next_out = (Bytef*)&out[GZ_MEMBER_HEADER];
+    zs.avail_out = (uInt)(out.size() - GZ_MEMBER_HEADER - 8);
+    int rc = deflate(&zs, Z_FINISH);
+    size_t clen = zs.total_out;
+    deflateEnd(&zs);
+    if (rc != Z_STREAM_END) throw runtime_error("deflate gagal");
+
+    size_t total = GZ_MEMBER_HEADER + clen + 8;
+    putLE32(out, GZ_MEMBER_HEADER + clen, (uint32_t)crc32(0, (const Bytef*)data, (uInt)len));
+    putLE32(out, GZ_MEMBER_HEADER + clen + 4, (uint32_t)len);
+    out.resize(total);
+    putLE32(out, 16, (uint32_t)total);
+    return out;
+}
+
+/**
+ * @brief Mendekompresi satu member gzip utuh (dibaca via subfield 'MB') dan memverifikasi CRC.
+ * ISIZE di trailer hanya petunjuk ukuran awal: dibatasi rasio deflate terhadap ukuran
+ * terkompresi dan MAX_DECOMPRESSED_UNIT, lalu buffer tumbuh selama inflate.
+ */
+static string gzipDecompressMember(const string& member, size_t headerLen) {
+    if (member.size() < headerLen + 8) throw runtime_error("member gzip terpotong");
+    const unsigned char* trailer = (const unsigned char*)member.data() + member.size() - 8;
+    uint32_t expectedCrc = getLE32(trailer);
+    uint32_t isize = getLE32(trailer + 4);
+    size_t compressed = member.size() - headerLen - 8;
+
+    size_t initial = min<size_t>({isize, compressed * DEFLATE_MAX_RATIO, MAX_DECOMPRESSED_UNIT});
+    string out(max<size_t>(initial, 1024), '\0');
+    z_stream zs{};
+    if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) throw runtime_error("inflateInit2 gagal");
+    zs.next_in = (Bytef*)member.data() + headerLen;
+    zs.avail_in = (uInt)compressed;
+    int rc = Z_OK;
+    while (true) {
+        zs.next_out = (Bytef*)&out[zs.total_out];
+        zs.avail_out = (uInt)(out.size() - zs.total_out);
+        rc = inflate(&zs, Z_NO_FLUSH);
+        if (rc == Z_STREAM_END || (rc != Z_OK && rc != Z_BUF_ERROR) || zs.avail_out > 0) break;
+        if (out.size() >= MAX_DECOMPRESSED_UNIT) {
+            rc = Z_MEM_ERROR;
+            break;
+        }
+        out.resize(min(out.size() * 2, MAX_DECOMPRESSED_UNIT));
+    }
+    size_t produced = zs.total_out;
+    inflateEnd(&zs);
+    if (rc == Z_MEM_ERROR) throw runtime_error("member gzip melebihi batas ukuran dekompresi");
+    if (rc != Z_STREAM_END) throw runtime_error("data gzip rusak");
+    out.resize(produced);
+    if ((uint32_t)produced != isize) throw runtime_error("ISIZE gzip tidak cocok");
+    if ((uint32_t)crc32(0, (const Bytef*)out.data(), (uInt)out.size()) != expectedCrc) {
+        throw runtime_error("CRC gzip tidak cocok");
+    }
+    return out;
+}
+#endif
+
+#ifdef DBM_HAVE_ZSTD
+static string zstdCompressBlock(const char* data, size_t len) {
+    string out(ZSTD_compressBound(len), '\0');
+    size_t n = ZSTD_compress(&out[0], out.size(), data, len, ZSTD_LEVEL);
+    if (ZSTD_isError(n)) throw runtime_error(string("ZSTD_compress gagal: ") + ZSTD_getErrorName(n));
+    out.resize(n);
+    return out;
+}
+
+/**
+ * @brief Dekompresi satu frame zstd yang header-nya mencatat ukuran konten
+ * <= MAX_DECOMPRESSED_UNIT (disaring readZstdFrame); frame lain dialirkan berurutan.
+ */
+static string zstdDecompressFrame(const string& frame) {
+    unsigned long long size = ZSTD_getFrameContentSize(frame.data(), frame.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR) throw runtime_error("frame zstd rusak");
+    if (size == ZSTD_CONTENTSIZE_UNKNOWN || size > MAX_DECOMPRESSED_UNIT) throw runtime_error("frame zstd melebihi batas ukuran dekompresi");
+    string out((size_t)size, '\0');
+    size_t n = ZSTD_decompress(&out[0], out.size(), frame.data(), frame.size());
+    if (ZSTD_isError(n)) throw runtime_error(string("ZSTD_decompress gagal: ") + ZSTD_getErrorName(n));
+    if (n != out.size()) throw runtime_error("ukuran frame zstd tidak cocok");
+    return out;
+}
+#endif
+
+static string compressBlock(Compression kind, const char* data, size_t len) {
+    switch (kind) {
+#ifdef DBM_HAVE_ZLIB
+        case Compression::Gzip: return gzipCompressBlock(data, len);
+#endif
+#ifdef DBM_HAVE_ZSTD
+        case Compression::Zstd: return zstdCompressBlock(data, len);
+#endif
+        default: throw runtime_error(string("kompresi tidak didukung: ") + compressionName(kind));
+    }
+}
+
+/**
+ * @class ParallelCompressBuf
+ * streambuf yang memotong output menjadi blok COMPRESS_BLOCK_SIZE, mengompresi
+ * tiap blok di ThreadPool, lalu menulis hasilnya ke sink sesuai urutan.
+ * Jumlah blok yang sedang diproses dibatasi (2x jumlah worker) agar memori tetap konstan.
+ */
+class ParallelCompressBuf : public streambuf {
+public:
+    ParallelCompressBuf(ostream& sinkStream, Compression compression, size_t threads)
+        : sink(sinkStream), kind(compression), pool(threads), block(COMPRESS_BLOCK_SIZE) {
+        setp(block.data(), block.data() + block.size());
+    }
+
+    ~ParallelCompressBuf() override { finish(); }
+
+    /**
+     * @brief Mengompresi sisa blok, menunggu semua worker, dan menulis hasilnya.
+     * Aman dipanggil lebih dari sekali. Mengembalikan false jika ada kegagalan.
+     */
+    bool finish() {
+        if (finished) return !failed;
+        finished = true;
+        // File kosong tetap harus menjadi file gzip/zstd yang valid (satu member/frame kosong)
+        if (pptr() > pbase() || blocksSubmitted == 0) submitBlock();
+        drain(0);
+        setp(nullptr, nullptr);
+        return !failed;
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (finished || failed) return traits_type::eof();
+        submitBlock();
+        if (failed) return traits_type::eof();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    // flush() tidak memotong blok: blok kecil hanya memperburuk rasio kompresi.
+    int sync() override { return failed ? -1 : 0; }
+
+private:
+    ostream& sink;
+    Compression kind;
+    ThreadPool pool;
+    vector<char> block;
+    deque<future<string>> pending;
+    size_t blocksSubmitted = 0;
+    bool finished = false;
+    bool failed = false;
+
+    void submitBlock() {
+        string data(pbase(), pptr());
+        Compression k = kind;
+        pending.push_back(pool.submit([k, data = std::move(data)]() {
+            TraceZone zone("compress.block", "io");
+            zone.arg("bytes", static_cast<int64_t>(data.size()));
+            return compressBlock(k, data.data(), data.size());
+        }));
+        ++blocksSubmitted;
+        setp(block.data(), block.data() + block.size());
+        drain(pool.size() * 2);
+    }
+
+    /**
+     * @brief Menulis blok yang sudah selesai (sesuai urutan) sampai sisa antrean <= maxPending.
+     */
+    void drain(size_t maxPending) {
+        while (pending.size() > maxPending) {
+            TraceZone zone("file.write", "io");
+            try {
+                string out = pending.front().get();
+                if (!failed && !sink.write(out.data(), (streamsize)out.size())) failed = true;
+            } catch (exception&) {
+                failed = true;
+            }
+            pending.pop_front();
+        }
+    }
+};
+
+/**
+ * @class ParallelDecompressBuf
+ * streambuf baca untuk file gzip/zstd multi-blok. Thread pemanggil hanya memecah file
+ * menjadi member/frame; dekompresi dilakukan paralel di ThreadPool dan hasilnya
+ * dikonsumsi sesuai urutan. Gzip tanpa subfield 'MB' (mis. dari gzip biasa) dan
+ * frame zstd tanpa ukuran konten yang masuk akal (mis. dari CLI zstd berbasis
+ * stream) didekompresi secara berurutan mulai dari unit tersebut.
+ */
+class ParallelDecompressBuf : public streambuf {
+public:
+    ParallelDecompressBuf(istream& sourceStream, Compression compression, size_t threads)
+        : source(sourceStream), kind(compression), pool(threads) {
+        // Ukuran file membatasi panjang member yang diklaim header ('MB'); -1 = tidak diketahui
+        streampos start = source.tellg();
+        if (start != streampos(-1) && source.seekg(0, ios::end)) {
+            sourceSize = source.tellg();
+            source.seekg(start);
+        }
+        source.clear();
+    }
+
+    ~ParallelDecompressBuf() override {
+#ifdef DBM_HAVE_ZLIB
+        if (seqInit) inflateEnd(&seq);
+#endif
+    }
+
+    bool hasError() const { return failed; }
+
+protected:
+    int_type underflow() override {
+        while (gptr() == egptr()) {
+            if (failed) return traits_type::eof();
+            if (sequential && pending.empty()) { // Unit paralel sebelumnya dikonsumsi dulu
+                if (!sequentialFill()) return traits_type::eof();
+                continue;
+            }
+            TraceZone zone("file.read", "io"); // Baca sumber + tunggu dekompresi blok berikutnya
+            fillPipeline();
+            if (sequential && pending.empty()) continue; // sisa file hanya bisa dibaca berurutan
+            if (pending.empty()) return traits_type::eof();
+            try {
+                current = pending.front().get();
+            } catch (exception&) {
+                failed = true;
+                current.clear();
+            }
+            pending.pop_front();
+            setg(&current[0], &current[0], &current[0] + current.size());
+        }
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    istream& source;
+    Compression kind;
+    ThreadPool pool;
+    deque<future<string>> pending;
+    string current;
+    string zstdBuffer;
+    streamoff sourceSize = -1;
+    bool sourceDone = false;
+    bool firstUnit = true;
+    bool sequential = false;
+    bool failed = false;
+#ifdef DBM_HAVE_ZLIB
+    z_stream seq{};
+    bool seqInit = false;
+    vector<char> seqIn;
+#endif
+#ifdef DBM_HAVE_ZSTD
+    unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> zseq{nullptr, ZSTD_freeDCtx};
+    size_t zseqPos = 0;       // Posisi baca di zstdBuffer saat berurutan
+    size_t zseqPending = 0;   // != 0: frame terakhir belum selesai
+#endif
+
+    void fillPipeline() {
+        while (!sourceDone && !failed && pending.size() < pool.size() * 2) {
+            string unit;
+            size_t headerLen = 0;
+            if (!readNextUnit(unit, headerLen)) break;
+            Compression k = kind;
+            pending.push_back(pool.submit([k, headerLen, unit = std::move(unit)]() -> string {
+                TraceZone zone("decompress.block", "io");
+                zone.arg("bytes", static_cast<int64_t>(unit.size()));
+#ifdef DBM_HAVE_ZLIB
+                if (k == Compression::Gzip) return gzipDecompressMember(unit, headerLen);
+#endif
+#ifdef DBM_HAVE_ZSTD
+                if (k == Compression::Zstd) return zstdDecompressFrame(unit);
+#endif
+                (void)headerLen;
+                throw runtime_error(string("kompresi tidak didukung: ") + compressionName(k));
+            }));
+        }
+    }
+
+    /**
+     * @brief Membaca satu member gzip / frame zstd utuh dari sumber.
+     * Mengembalikan false pada akhir file (sourceDone) atau error (failed).
+     */
+    bool readNextUnit(string& unit, size_t& headerLen) {
+        if (kind == Compression::Gzip) return readGzipMember(unit, headerLen);
+        return readZstdFrame(unit);
+    }
+
+    bool readGzipMember(string& unit, size_t& headerLen) {
+        streampos memberStart = source.tellg();
+        unsigned char hdr[12];
+        source.read((char*)hdr, 10);
+        if (source.gcount() == 0) { sourceDone = true; return false; }
+        if (source.gcount() < 10 || hdr[0] != 0x1f || hdr[1] != 0x8b || hdr[2] != 8) { failed = true; return false; }
+        uint32_t memberSize = 0;
+        string extra;
+        if (hdr[3] & 0x04) { // FEXTRA
+            source.read((char*)hdr + 10, 2);
+            size_t xlen = hdr[10] | (hdr[11] << 8);
+            extra.resize(xlen);
+            source.read(&extra[0], (streamsize)xlen);
+            for (size_t p = 0; p + 4 <= xlen;) {
+                size_t len = (unsigned char)extra[p + 2] | ((unsigned char)extra[p + 3] << 8);
+                if (extra[p] == 'M' && extra[p + 1] == 'B' && len == 4 && p + 8 <= xlen) {
+                    memberSize = getLE32((const unsigned char*)extra.data() + p + 4);
+                }
+                p += 4 + len;
+            }
+        }
+        headerLen = 10 + ((hdr[3] & 0x04) ? 2 + extra.size() : 0);
+        // Panjang 'MB' berasal dari file: dibatasi blok terbesar yang masuk akal dan sisa file
+        size_t maxMember = headerLen + compressBound((uLong)MAX_DECOMPRESSED_UNIT) + 8;
+        streamoff remaining = sourceSize - (streamoff)memberStart;
+        bool plausible = memberSize <= maxMember && (sourceSize < 0 || memberStart == streampos(-1) || (streamoff)memberSize <= remaining);
+        if (memberSize == 0 || (hdr[3] & ~0x04) != 0 || memberSize < headerLen + 8 || !plausible) {
+            // Bukan ditulis oleh ParallelCompressBuf (atau header rusak): didekompresi berurutan dari member ini
+            return switchToSequential(memberStart);
+        }
+        firstUnit = false;
+        unit.assign((const char*)hdr, 10);
+        unit.append((const char*)hdr + 10, 2);
+        unit += extra;
+        size_t rest = memberSize - unit.size();
+        unit.resize(memberSize);
+        source.read(&unit[memberSize - rest], (streamsize)rest);
+        if ((size_t)source.gcount() != rest) { failed = true; return false; }
+        return true;
+    }
+
+    /**
+     * @brief Membaca satu frame zstd utuh untuk dekompresi paralel. Hanya frame yang
+     * header-nya mencatat ukuran konten <= MAX_DECOMPRESSED_UNIT yang dibuffer;
+     * selain itu sisa file dialirkan lewat ZSTD_decompressStream (switchToZstdStream).
+     */
+    bool readZstdFrame(string& unit) {
+#ifdef DBM_HAVE_ZSTD
+        const size_t headerProbe = 18; // ZSTD_FRAMEHEADERSIZE_MAX
+        const size_t maxFrame = ZSTD_compressBound(MAX_DECOMPRESSED_UNIT);
+        size_t chunk = COMPRESS_BLOCK_SIZE;
+        bool sized = false;
+        while (true) {
+            if (!sized && (zstdBuffer.size() >= headerProbe || (source.eof() && !zstdBuffer.empty()))) {
+                unsigned long long size = ZSTD_getFrameContentSize(zstdBuffer.data(), zstdBuffer.size());
+                if (size == ZSTD_CONTENTSIZE_ERROR) {
+                    failed = true; // Bukan frame zstd
+                    return false;
+                }
+                if (size == ZSTD_CONTENTSIZE_UNKNOWN || size > MAX_DECOMPRESSED_UNIT) return switchToZstdStream();
+                sized = true;
+            }
+            if (sized) {
+                size_t frameSize = ZSTD_findFrameCompressedSize(zstdBuffer.data(), zstdBuffer.size());
+                if (!ZSTD_isError(frameSize)) {
+                    unit = zstdBuffer.substr(0, frameSize);
+                    zstdBuffer.erase(0, frameSize);
+                    return true;
+                }
+                if (zstdBuffer.size() > maxFrame) {
+                    failed = true; // Frame terkompresi lebih besar dari batas untuk ukuran kontennya
+                    return false;
+                }
+            }
+            if (source.eof()) {
+                if (zstdBuffer.empty()) sourceDone = true;
+                else failed = true; // frame terakhir terpotong
+                return false;
+            }
+            size_t old = zstdBuffer.size();
+            zstdBuffer.resize(old + chunk);
+            source.read(&zstdBuffer[old], (streamsize)chunk);
+            zstdBuffer.resize(old + (size_t)source.gcount());
+            chunk = min(chunk * 2, 8 * COMPRESS_BLOCK_SIZE);
+        }
+#else
+        (void)unit;
+        failed = true;
+        return false;
+#endif
+    }
+
+    bool switchToSequential(streampos from) {
+#ifdef DBM_HAVE_ZLIB
+        if (from == streampos(-1)) { // Sumber tidak bisa di-seek kembali ke awal member
+            failed = true;
+            return false;
+        }
+        source.clear();
+        source.seekg(from);
+        if (inflateInit2(&seq, 15 + 32) != Z_OK) { failed = true; return false; }
+        seqInit = true;
+        seqIn.resize(1 << 16);
+        sequential = true;
+        sourceDone = true;
+#else
+        (void)from;
+        failed = true;
+#endif
+        return false;
+    }
+
+    /**
+     * @brief Beralih ke dekompresi zstd berurutan mulai dari frame di awal zstdBuffer.
+     */
+    bool switchToZstdStream() {
+#ifdef DBM_HAVE_ZSTD
+        zseq.reset(ZSTD_createDCtx());
+        if (!zseq) { failed = true; return false; }
+        zseqPos = 0;
+        sequential = true;
+        sourceDone = true;
+#else
+        failed = true;
+#endif
+        return false;
+    }
+
+    /**
+     * @brief Dekompresi berurutan: zstd lewat ZSTD_decompressStream, gzip lewat
+     * inflate (gzip biasa, mendukung multi-member).
+     */
+    bool sequentialFill() {
+#ifdef DBM_HAVE_ZSTD
+        if (kind == Compression::Zstd) {
+            current.resize(ZSTD_DStreamOutSize());
+            while (true) {
+                if (zseqPos == zstdBuffer.size()) {
+                    zstdBuffer.resize(ZSTD_DStreamInSize());
+                    source.read(&zstdBuffer[0], (streamsize)zstdBuffer.size());
+                    zstdBuffer.resize((size_t)source.gcount());
+                    zseqPos = 0;
+                    if (zstdBuffer.empty()) {
+                        if (zseqPending != 0) failed = true; // frame terakhir terpotong
+                        return false;
+                    }
+                }
+                ZSTD_inBuffer in = {zstdBuffer.data(), zstdBuffer.size(), zseqPos};
+                ZSTD_outBuffer out = {&current[0], current.size(), 0};
+                size_t rc = ZSTD_decompressStream(zseq.get(), &out, &in);
+                zseqPos = in.pos;
+                if (ZSTD_isError(rc)) {
+                    failed = true;
+                    return false;
+                }
+                zseqPending = rc;
+                if (out.pos > 0) {
+                    setg(&current[0], &current[0], &current[0] + out.pos);
+                    return true;
+                }
+            }
+        }
+#endif
+#ifdef DBM_HAVE_ZLIB
+        current.resize(1 << 18);
+        while (true) {
+            if (seq.avail_in == 0) {
+                source.read(seqIn.data(), (streamsize)seqIn.size());
+                seq.next_in = (Bytef*)seqIn.data();
+                seq.avail_in = (uInt)source.gcount();
+                if (seq.avail_in == 0) return false;
+            }
+            seq.next_out = (Bytef*)&current[0];
+            seq.avail_out = (uInt)current.size();
+            int rc = inflate(&seq, Z_NO_FLUSH);
+            if (rc == Z_STREAM_END) {
+                inflateReset(&seq); // member berikutnya (jika ada)
+            } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+                failed = true;
+                return false;
+            }
+            size_t produced = current.size() - seq.avail_out;
+            if (produced > 0) {
+                setg(&current[0], &current[0], &current[0] + produced);
+                return true;
+            }
+        }
+#else
+        return false;
+#endif
+    }
+};
+
+/**
+ * @class CompressedOFStream
+ * Pengganti ofstream untuk ekspor/backup. Kompresi dipilih dari ekstensi
+ * path (.gz / .zst); tanpa ekstensi tersebut berperilaku seperti ofstream biasa.
+ */
+class CompressedOFStream : public ostream {
+public:
+    explicit CompressedOFStream(const string& path) : ostream(nullptr), kind(compressionFromPath(path)) {
+        if (!compressionSupported(kind)) {
+            cerr << "Kompresi " << compressionName(kind) << " tidak tersedia di build ini." << endl;
+            setstate(ios::badbit);
+            return;
+        }
+        file.open(path, kind == Compression::None ? ios::out : ios::out | ios::binary);
+        if (!file.is_open()) {
+            setstate(ios::badbit);
+            return;
+        }
+        if (kind == Compression::None) {
+            rdbuf(file.rdbuf());
+        } else {
+            compressor = make_unique<ParallelCompressBuf>(file, kind, ThreadPool::defaultThreads());
+            rdbuf(compressor.get());
+        }
+    }
+
+    ~CompressedOFStream() override { close(); }
+
+    bool is_open() const { return file.is_open(); }
+    Compression compression() const { return kind; }
+
+    /**
+     * @brief Menyelesaikan kompresi dan menutup file. False jika ada kegagalan tulis.
+     */
+    bool close() {
+        if (!file.is_open()) return !fail();
+        flush();
+        bool ok = !fail();
+        if (compressor) ok = compressor->finish() && ok;
+        file.close();
+        ok = ok && !file.fail();
+        if (!ok) setstate(ios::badbit);
+        return ok;
+    }
+
+private:
+    Compression kind;
+    ofstream file;
+    unique_ptr<ParallelCompressBuf> compressor;
+};
+
+/**
+ * @class CompressedIFStream
+ * Pengganti ifstream untuk impor. Format dideteksi dari magic bytes
+ * (gzip 1f 8b, zstd 28 b5 2f fd); file biasa dibuka dalam mode teks seperti semula.
+ */
+class CompressedIFStream : public istream {
+public:
+    explicit CompressedIFStream(const string& path) : istream(nullptr) {
+        file.open(path, ios::in | ios::binary);
+        if (!file.is_open()) {
+            setstate(ios::badbit);
+            return;
+        }
+        unsigned char magic[4] = {0, 0, 0, 0};
+        file.read((char*)magic, 4);
+        file.clear();
+        file.seekg(0);
+        if (magic[0] == 0x1f && magic[1] == 0x8b) kind = Compression::Gzip;
+        else if (magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) kind = Compression::Zstd;
+
+        if (kind == Compression::None) {
+            file.close();
+            file.open(path); // mode teks, sama seperti ifstream sebelumnya
+            rdbuf(file.rdbuf());
+        } else if (!compressionSupported(kind)) {
+            cerr << "Kompresi " << compressionName(kind) << " tidak tersedia di build ini." << endl;
+            file.close();
+            setstate(ios::badbit);
+        } else {
+            decompressor = make_unique<ParallelDecompressBuf>(file, kind, ThreadPool::defaultThreads());
+            rdbuf(decompressor.get());
+        }
+    }
+
+    bool is_open() const { return file.is_open(); }
+    Compression compression() const { return kind; }
+    bool hasError() const { return decompressor && decompressor->hasError(); }
+    void close() { file.close(); }
+
+private:
+    Compression kind = Compression::None;
+    ifstream file;
+    unique_ptr<ParallelDecompressBuf> decompressor;
+};
+
+// --- AKUNTANSI MEMORI ---
+
+/*
+ * Hook alokator global: operator new/delete diganti agar setiap alokasi C++
+ * dihitung (total proses dan per thread). Dengan begitu pemakaian memori bisa
+ * diatribusikan ke operasi/job yang berjalan di thread tersebut. Alokasi
+ * malloc() langsung milik pustaka C (mis. libmysqlclient) tidak terhitung di
+ * sini; untuk itu ada sampling RSS di bawah. Bangun dengan -DDBM_NO_ALLOC_HOOK
+ * untuk mematikan hook (MemoryScope tetap melaporkan RSS).
+ *
+ * Jalur alokasi hanya menyentuh penghitung thread sendiri (load/store relaxed,
+ * tanpa RMW atomik pada cache line bersama); total proses dijumlahkan saat
+ * dibaca (heapTotals). Setiap blok membawa header ukuran + cookie, sehingga
+ * delete hanya mengurangi alokasi yang memang dibuat hook ini; pointer dari
+ * alokator lain (mis. new milik DLL di Windows) dibebaskan tanpa dihitung.
+ */
+#if !defined(DBM_NO_ALLOC_HOOK) && (defined(__linux__) || defined(_WIN32) || defined(__APPLE__))
+#define DBM_ALLOC_HOOK 1
+#endif
+
+struct HeapCounters {
+    atomic<int64_t> liveBytes{0};
+    atomic<uint64_t> allocatedBytes{0};
+    atomic<uint64_t> allocations{0};
+};
+
+struct HeapTotals {
+    int64_t liveBytes = 0;
+    uint64_t allocatedBytes = 0;
+    uint64_t allocations = 0;
+};
+
+/*
+ * Penghitung per thread, terdaftar di daftar berantai global (tanpa alokasi)
+ * agar heapTotals bisa menjumlahkannya. Hanya thread pemilik yang menulis;
+ * saat thread selesai angkanya dilipat ke heapRetired.
+ */
+struct ThreadHeapCounters {
+    HeapCounters counts;    // liveBytes bisa negatif jika thread membebaskan memori milik thread lain
+    int64_t peakLiveBytes = 0; // Puncak liveBytes sejak direset oleh MemoryScope; hanya pemilik
+    ThreadHeapCounters* prev = nullptr;
+    ThreadHeapCounters* next = nullptr;
+
+    ThreadHeapCounters();
+    ~ThreadHeapCounters();
+
+    int64_t liveBytes() const { return counts.liveBytes.load(memory_order_relaxed); }
+    uint64_t allocatedBytes() const { return counts.allocatedBytes.load(memory_order_relaxed); }
+    uint64_t allocations() const { return counts.allocations.load(memory_order_relaxed); }
+};
+
+static mutex heapRegistryMutex;
+static ThreadHeapCounters* heapRegistry = nullptr;
+static HeapCounters heapRetired; // Thread yang sudah selesai + free setelah penghitung thread dihancurkan
+static thread_local int heapThreadState = 0; // 0 = belum, 1 = terdaftar, 2 = sudah dihancurkan
+static thread_local ThreadHeapCounters threadHeap;
+
+ThreadHeapCounters::ThreadHeapCounters() {
+    lock_guard<mutex> lock(heapRegistryMutex);
+    next = heapRegistry;
+    if (next) next->prev = this;
+    heapRegistry = this;
+    heapThreadState = 1;
+}
+
+ThreadHeapCounters::~ThreadHeapCounters() {
+    lock_guard<mutex> lock(heapRegistryMutex);
+    if (prev) prev->next = next;
+    else heapRegistry = next;
+    if (next) next->prev = prev;
+    heapRetired.liveBytes.fetch_add(liveBytes(), memory_order_relaxed);
+    heapRetired.allocatedBytes.fetch_add(allocatedBytes(), memory_order_relaxed);
+    heapRetired.allocations.fetch_add(allocations(), memory_order_relaxed);
+    heapThreadState = 2;
+}
+
+/**
+ * @brief Total heap proses: jumlah penghitung semua thread hidup + yang sudah selesai.
+ */
+static HeapTotals heapTotals() {
+    HeapTotals t;
+    lock_guard<mutex> lock(heapRegistryMutex);
+    t.liveBytes = heapRetired.liveBytes.load(memory_order_relaxed);
+    t.allocatedBytes = heapRetired.allocatedBytes.load(memory_order_relaxed);
+    t.allocations = heapRetired.allocations.load(memory_order_relaxed);
+    for (ThreadHeapCounters* c = heapRegistry; c; c = c->next) {
+        t.liveBytes += c->liveBytes();
+        t.allocatedBytes += c->allocatedBytes();
+        t.allocations += c->allocations();
+    }
+    return t;
+}
+
+static constexpr bool heapAccountingEnabled() {
+#ifdef DBM_ALLOC_HOOK
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef DBM_ALLOC_HOOK
+// Header di depan setiap blok hook; ukurannya menjaga perataan default operator new
+struct HeapBlockHeader {
+    uint64_t size;
+    uint64_t cookie; // HEAP_COOKIE ^ alamat pengguna: penanda blok milik hook
+};
+static const size_t HEAP_HEADER_SIZE = max(sizeof(HeapBlockHeader), alignof(max_align_t));
+static const uint64_t HEAP_COOKIE = 0x9e3779b97f4a7c15ULL;
+
+static inline uint64_t heapCookie(const void* user) {
+    return HEAP_COOKIE ^ (uint64_t)reinterpret_cast<uintptr_t>(user);
+}
+
+// Penulis tunggal: cukup load + store, tidak perlu fetch_add
+template <typename T>
+static inline void heapBump(atomic<T>& counter, T delta) {
+    counter.store(counter.load(memory_order_relaxed) + delta, memory_order_relaxed);
+}
+
+static inline void heapCountAlloc(size_t n) {
+    if (heapThreadState == 2) {
+        heapRetired.liveBytes.fetch_add((int64_t)n, memory_order_relaxed);
+        heapRetired.allocatedBytes.fetch_add(n, memory_order_relaxed);
+        heapRetired.allocations.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+    ThreadHeapCounters& t = threadHeap;
+    int64_t live = t.liveBytes() + (int64_t)n;
+    t.counts.liveBytes.store(live, memory_order_relaxed);
+    if (live > t.peakLiveBytes) t.peakLiveBytes = live;
+    heapBump<uint64_t>(t.counts.allocatedBytes, n);
+    heapBump<uint64_t>(t.counts.allocations, 1);
+}
+
+static inline void heapCountFree(size_t n) {
+    if (heapThreadState == 2) {
+        heapRetired.liveBytes.fetch_sub((int64_t)n, memory_order_relaxed);
+        return;
+    }
+    heapBump<int64_t>(threadHeap.counts.liveBytes, -(int64_t)n);
+}
+
+/**
+ * @brief Menulis header di depan 'user' dan mencatat alokasinya.
+ */
+static inline void* heapTrack(void* user, size_t n) {
+    HeapBlockHeader* h = reinterpret_cast<HeapBlockHeader*>(static_cast<char*>(user) - sizeof(HeapBlockHeader));
+    h->size = n;
+    h->cookie = heapCookie(user);
+    heapCountAlloc(n);
+    return user;
+}
+
+/**
+ * @brief Ukuran blok jika 'user' dibuat hook ini (cookie cocok, lalu dihapus); -1 jika bukan.
+ */
+static inline int64_t heapUntrack(void* user) {
+    HeapBlockHeader* h = reinterpret_cast<HeapBlockHeader*>(static_cast<char*>(user) - sizeof(HeapBlockHeader));
+    if (h->cookie != heapCookie(user)) return -1;
+    h->cookie = 0; // Double free tidak dihitung dua kali
+    heapCountFree(h->size);
+    return (int64_t)h->size;
+}
+
+static void* heapAllocate(size_t n) {
+    if (n == 0) n = 1;
+    if (n > SIZE_MAX - HEAP_HEADER_SIZE) throw bad_alloc();
+    while (true) {
+        void* p = malloc(n + HEAP_HEADER_SIZE);
+        if (p) return heapTrack(static_cast<char*>(p) + HEAP_HEADER_SIZE, n);
+        new_handler handler = get_new_handler();
+        if (!handler) throw bad_alloc();
+        handler();
+    }
+}
+
+// Offset pengguna pada blok aligned: kelipatan 'align' yang muat header
+static inline size_t heapAlignedOffset(size_t align) {
+    return max(align, HEAP_HEADER_SIZE);
+}
+
+static void* heapAllocateAligned(size_t n, size_t align) {
+    if (n == 0) n = 1;
+    size_t offset = heapAlignedOffset(align);
+    if (n > SIZE_MAX - offset) throw bad_alloc();
+    while (true) {
+#if defined(_WIN32)
+        void* p = _aligned_malloc(n + offset, align);
+#else
+        void* p = nullptr;
+        if (posix_memalign(&p, align, n + offset) != 0) p = nullptr;
+#endif
+        if (p) return heapTrack(static_cast<char*>(p) + offset, n);
+        new_handler handler = get_new_handler();
+        if (!handler) throw bad_alloc();
+        handler();
+    }
+}
+
+static void heapRelease(void* p) {
+    if (!p) return;
+    if (heapUntrack(p) < 0) free(p); // Bukan milik hook: bebaskan apa adanya
+    else free(static_cast<char*>(p) - HEAP_HEADER_SIZE);
+}
+
+static void heapReleaseAligned(void* p, size_t align) {
+    if (!p) return;
+    void* base = heapUntrack(p) < 0 ? p : static_cast<char*>(p) - heapAlignedOffset(align);
+#if defined(_WIN32)
+    _aligned_free(base);
+#else
+    free(base);
+#endif
+}
+
+void* operator new(size_t n) { return heapAllocate(n); }
+void* operator new[](size_t n) { return heapAllocate(n); }
+void* operator new(size_t n, const nothrow_t&) noexcept {
+    try { return heapAllocate(n); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t n, const nothrow_t&) noexcept {
+    try { return heapAllocate(n); } catch (...) { return nullptr; }
+}
+void* operator new(size_t n, align_val_t a) { return heapAllocateAligned(n, (size_t)a); }
+void* operator new[](size_t n, align_val_t a) { return heapAllocateAligned(n, (size_t)a); }
+void* operator new(size_t n, align_val_t a, const nothrow_t&) noexcept {
+    try { return heapAllocateAligned(n, (size_t)a); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t n, align_val_t a, const nothrow_t&) noexcept {
+    try { return heapAllocateAligned(n, (size_t)a); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { heapRelease(p); }
+void operator delete[](void* p) noexcept { heapRelease(p); }
+void operator delete(void* p, size_t) noexcept { heapRelease(p); }
+void operator delete[](void* p, size_t) noexcept { heapRelease(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { heapRelease(p); }
+void operator delete[](void* p, const nothrow_t&) noexcept { heapRelease(p); }
+void operator delete(void* p, align_val_t a) noexcept { heapReleaseAligned(p, (size_t)a); }
+void operator delete[](void* p, align_val_t a) noexcept { heapReleaseAligned(p, (size_t)a); }
+void operator delete(void* p, size_t, align_val_t a) noexcept { heapReleaseAligned(p, (size_t)a); }
+void operator delete[](void* p, size_t, align_val_t a) noexcept { heapReleaseAligned(p, (size_t)a); }
+void operator delete(void* p, align_val_t a, const nothrow_t&) noexcept { heapReleaseAligned(p, (size_t)a); }
+void operator delete[](void* p, align_val_t a, const nothrow_t&) noexcept { heapReleaseAligned(p, (size_t)a); }
+#endif // DBM_ALLOC_HOOK
+
+/**
+ * @brief Resident set size proses saat ini (byte); 0 jika tidak didukung.
+ */
+static uint64_t processRssBytes() {
+#if defined(__linux__)
+    ifstream statm("/proc/self/statm");
+    uint64_t sizePages = 0, residentPages = 0;
+    if (!(statm >> sizePages >> residentPages)) return 0;
+    return residentPages * (uint64_t)sysconf(_SC_PAGESIZE);
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+    return pmc.WorkingSetSize;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Puncak RSS proses sejak start (byte), menurut kernel; 0 jika tidak didukung.
+ */
+static uint64_t processPeakRssBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+    return pmc.PeakWorkingSetSize;
+#elif defined(__linux__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return (uint64_t)usage.ru_maxrss; // macOS: byte
+#else
+    return (uint64_t)usage.ru_maxrss * 1024; // Linux: KB
+#endif
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @class RssSampler
+ * Thread latar yang mencuplik RSS tiap SAMPLE_INTERVAL selama ada MemoryScope
+ * aktif, dan menaikkan puncak RSS milik setiap scope. Puncak kernel (ru_maxrss)
+ * tidak bisa direset per operasi, jadi puncak per scope harus dicuplik.
+ * Thread baru dibuat saat scope pertama mendaftar dan tidur jika tidak ada scope.
+ */
+class RssSampler {
+public:
+    static constexpr chrono::milliseconds SAMPLE_INTERVAL{20};
+
+    static RssSampler& instance() {
+        static RssSampler sampler;
+        return sampler;
+    }
+
+    ~RssSampler() {
+        {
+            lock_guard<mutex> lock(samplerMutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    void attach(atomic<uint64_t>* peak) {
+        {
+            lock_guard<mutex> lock(samplerMutex);
+            peaks.push_back(peak);
+            if (!worker.joinable()) worker = thread([this] { run(); });
+        }
+        cv.notify_all();
+    }
+
+    void detach(atomic<uint64_t>* peak) {
+        lock_guard<mutex> lock(samplerMutex);
+        peaks.erase(remove(peaks.begin(), peaks.end(), peak), peaks.end());
+    }
+
+    static void raise(atomic<uint64_t>& peak, uint64_t value) {
+        uint64_t old = peak.load(memory_order_relaxed);
+        while (value > old && !peak.compare_exchange_weak(old, value, memory_order_relaxed)) {}
+    }
+
+private:
+    mutex samplerMutex;
+    condition_variable cv;
+    vector<atomic<uint64_t>*> peaks;
+    bool stopping = false;
+    thread worker;
+
+    RssSampler() = default;
+
+    void run() {
+        unique_lock<mutex> lock(samplerMutex);
+        while (!stopping) {
+            if (peaks.empty()) {
+                cv.wait(lock, [this] { return stopping || !peaks.empty(); });
+                continue;
+            }
+            lock.unlock();
+            uint64_t rss = processRssBytes();
+            lock.lock();
+            for (atomic<uint64_t>* peak : peaks) raise(*peak, rss); // Scope tidak bisa lepas selama lock dipegang
+            cv.wait_for(lock, SAMPLE_INTERVAL, [this] { return stopping; });
+        }
+    }
+};
+
+/**
+ * @struct MemoryUsage
+ * Pemakaian memori satu MemoryScope. Angka heap hanya mencakup alokasi di
+ * thread pemilik scope; RSS mencakup seluruh proses.
+ */
+struct MemoryUsage {
+    uint64_t allocatedBytes = 0; // Total byte yang dialokasikan (termasuk yang sudah dibebaskan)
+    uint64_t allocations = 0;
+    int64_t peakHeapBytes = 0;   // Puncak heap hidup relatif terhadap awal scope
+    int64_t liveHeapBytes = 0;   // Heap hidup relatif terhadap awal scope (saat ini / saat selesai)
+    uint64_t startRssBytes = 0;
+    uint64_t peakRssBytes = 0;
+};
+
+static string formatBytes(uint64_t b);
+
+/**
+ * @class MemoryScope
+ * RAII: mengukur alokasi, puncak heap dan puncak RSS selama satu operasi di
+ * thread ini, lalu mencatatnya ke metrik dbm_op_*{op="..."}. Scope boleh
+ * bersarang; puncak scope dalam tetap terhitung di scope luar. Operasi
+ * streaming yang sehat menunjukkan puncak heap yang tidak tumbuh seiring
+ * jumlah baris.
+ */
+class MemoryScope {
+public:
+    explicit MemoryScope(const char* op) : op(op) {
+        startRss = processRssBytes();
+        peakRss = startRss;
+        RssSampler::instance().attach(&peakRss);
+        // Baseline diambil terakhir agar alokasi milik scope ini sendiri tidak terhitung
+        startAllocated = threadHeap.allocatedBytes();
+        startAllocations = threadHeap.allocations();
+        startLive = threadHeap.liveBytes();
+        outerPeak = threadHeap.peakLiveBytes;
+        threadHeap.peakLiveBytes = startLive;
+    }
+
+    ~MemoryScope() {
+        RssSampler::instance().detach(&peakRss);
+        RssSampler::raise(peakRss, processRssBytes());
+        MemoryUsage u = usage();
+        threadHeap.peakLiveBytes = max(outerPeak, threadHeap.peakLiveBytes);
+        publish(u);
+    }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+    /**
+     * @brief Pemakaian sejauh ini. Hanya boleh dipanggil dari thread pemilik scope.
+     */
+    MemoryUsage usage() const {
+        MemoryUsage u;
+        u.allocatedBytes = threadHeap.allocatedBytes() - startAllocated;
+        u.allocations = threadHeap.allocations() - startAllocations;
+        u.peakHeapBytes = max<int64_t>(0, threadHeap.peakLiveBytes - startLive);
+        u.liveHeapBytes = threadHeap.liveBytes() - startLive;
+        u.startRssBytes = startRss;
+        u.peakRssBytes = peakRss.load(memory_order_relaxed);
+        return u;
+    }
+
+    /**
+     * @brief Menerbitkan angka saat ini ke metrik tanpa menunggu scope selesai
+     *        (untuk operasi yang berjalan terus, mis. followCSV).
+     */
+    void publish() { publish(usage()); }
+
+    static string summary(const MemoryUsage& u) {
+        ostringstream oss;
+        oss << "Memori: ";
+        if (heapAccountingEnabled())
+            oss << formatBytes(u.allocatedBytes) << " dialokasikan (" << u.allocations << "x), puncak heap "
+                << formatBytes((uint64_t)u.peakHeapBytes) << ", ";
+        oss << "puncak RSS " << formatBytes(u.peakRssBytes);
+        if (u.peakRssBytes > u.startRssBytes) oss << " (+" << formatBytes(u.peakRssBytes - u.startRssBytes) << ")";
+        return oss.str();
+    }
+
+private:
+    const char* op;
+    uint64_t startAllocated = 0;
+    uint64_t startAllocations = 0;
+    int64_t startLive = 0;
+    int64_t outerPeak = 0;
+    uint64_t startRss = 0;
+    atomic<uint64_t> peakRss{0};
+    uint64_t publishedAllocated = 0; // Bagian allocatedBytes yang sudah masuk counter
+
+    void publish(const MemoryUsage& u) {
+        string label = string("{op=\"") + op + "\"}";
+        metrics().counter("dbm_op_alloc_bytes_total" + label, "Byte heap yang dialokasikan per operasi")
+            .add(u.allocatedBytes - publishedAllocated);
+        publishedAllocated = u.allocatedBytes;
+        metrics().gauge("dbm_op_peak_heap_bytes" + label, "Puncak heap hidup operasi terakhir (thread operasi)")
+            .set(u.peakHeapBytes);
+        metrics().gauge("dbm_op_peak_rss_bytes" + label, "Puncak RSS proses selama operasi terakhir")
+            .set((int64_t)u.peakRssBytes);
+    }
+};
+
+/**
+ * @brief Menyegarkan gauge memori proses sebelum metrik ditampilkan/di-scrape.
+ */
+static void refreshMemoryMetrics() {
+    static MetricGauge& rss = metrics().gauge("dbm_process_rss_bytes", "Resident set size proses");
+    static MetricGauge& peakRss = metrics().gauge("dbm_process_peak_rss_bytes", "Puncak RSS proses sejak start");
+    rss.set((int64_t)processRssBytes());
+    peakRss.set((int64_t)processPeakRssBytes());
+    if (!heapAccountingEnabled()) return;
+    static MetricGauge& live = metrics().gauge("dbm_heap_live_bytes", "Byte heap C++ yang masih teralokasi");
+    static MetricCounter& allocated = metrics().counter("dbm_heap_allocated_bytes_total", "Total byte heap C++ yang pernah dialokasikan");
+    static MetricCounter& allocations = metrics().counter("dbm_heap_allocations_total", "Jumlah alokasi heap C++");
+    static mutex refreshMutex;
+    lock_guard<mutex> lock(refreshMutex); // Counter hanya bisa add(): selisih dihitung di bawah lock
+    HeapTotals totals = heapTotals();
+    live.set(totals.liveBytes);
+    if (totals.allocatedBytes > allocated.get()) allocated.add(totals.allocatedBytes - allocated.get());
+    if (totals.allocations > allocations.get()) allocations.add(totals.allocations - allocations.get());
+}
+
+// --- JOB LATAR BELAKANG ---
+
+enum class JobState { Queued, Running, Succeeded, Failed, Cancelled };
+
+/**
+ * @struct Job
+ * Status dan progres satu operasi panjang. Semua penghitung atomik sehingga
+ * menu Jobs dapat membacanya saat job masih berjalan di worker.
+ */
+struct Job {
+    int id = 0;
+    string name;
+    atomic<JobState> state{JobState::Queued};
+    atomic<bool> cancelRequested{false};
+    atomic<uint64_t> rows{0};
+    atomic<uint64_t> bytes{0};
+    atomic<uint64_t> totalRows{0};   // 0 = tidak diketahui
+    atomic<uint64_t> totalBytes{0};  // 0 = tidak diketahui
+    atomic<int64_t> startedMs{0};
+    atomic<int64_t> finishedMs{0};
+    atomic<uint64_t> allocatedBytes{0}; // Alokasi heap di thread job
+    atomic<int64_t> peakHeapBytes{0};
+    atomic<uint64_t> peakRssBytes{0};   // Puncak RSS proses selama job
+    MemoryScope* memory = nullptr;      // Milik worker; hanya disentuh dari thread job
+    bool dedicated = false;             // Berjalan di thread sendiri, bukan worker pool
+    Job* parent = nullptr;              // Job pemanggil (sub-operasi AsyncDatabase): progres dan pembatalan diteruskan
+
+    static int64_t nowMs() {
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double elapsedSeconds() const {
+        int64_t start = startedMs.load();
+        if (start == 0) return 0.0;
+        int64_t end = finishedMs.load();
+        return ((end != 0 ? end : nowMs()) - start) / 1000.0;
+    }
+
+    double rowsPerSecond() const {
+        double secs = elapsedSeconds();
+        return secs > 0 ? rows.load() / secs : 0.0;
+    }
+
+    /**
+     * @brief Perkiraan sisa waktu (detik) dari total baris atau byte; -1 jika tidak diketahui.
+     */
+    double etaSeconds() const {
+        double secs = elapsedSeconds();
+        if (secs <= 0 || state.load() != JobState::Running) return -1;
+        uint64_t done = rows.load(), total = totalRows.load();
+        if (total == 0) {
+            done = bytes.load();
+            total = totalBytes.load();
+        }
+        if (total == 0 || done == 0) return -1;
+        if (done >= total) return 0;
+        return secs * (double)(total - done) / (double)done;
+    }
+
+    /**
+     * @brief Menyalin pemakaian memori terkini ke penghitung atomik. Dipanggil dari thread job.
+     */
+    void updateMemory() {
+        if (!memory) return;
+        MemoryUsage u = memory->usage();
+        allocatedBytes.store(u.allocatedBytes, memory_order_relaxed);
+        peakHeapBytes.store(u.peakHeapBytes, memory_order_relaxed);
+        peakRssBytes.store(u.peakRssBytes, memory_order_relaxed);
+    }
+};
+
+// Job yang sedang dijalankan oleh thread ini (nullptr = bukan job)
+static thread_local Job* currentJob = nullptr;
+
+/**
+ * @brief Hook progres untuk operasi panjang. No-op jika dipanggil di luar job.
+ */
+inline void jobAddProgress(uint64_t rowsDone, uint64_t bytesDone = 0) {
+    if (!currentJob) return;
+    if (rowsDone) currentJob->rows.fetch_add(rowsDone, memory_order_relaxed);
+    if (bytesDone) currentJob->bytes.fetch_add(bytesDone, memory_order_relaxed);
+    currentJob->updateMemory();
+    if (Job* parent = currentJob->parent) { // Progres langsung terlihat di job pemanggil
+        if (rowsDone) parent->rows.fetch_add(rowsDone, memory_order_relaxed);
+        if (bytesDone) parent->bytes.fetch_add(bytesDone, memory_order_relaxed);
+    }
+}
+
+inline void jobSetTotal(uint64_t totalRows, uint64_t totalBytes = 0) {
+    if (!currentJob) return;
+    currentJob->totalRows = totalRows;
+    currentJob->totalBytes = totalBytes;
+}
+
+/**
+ * @brief True jika job saat ini diminta berhenti. Operasi memeriksa ini di loop utamanya.
+ */
+inline bool jobCancelled() {
+    if (!currentJob) return false;
+    if (currentJob->cancelRequested.load(memory_order_relaxed)) return true;
+    return currentJob->parent && currentJob->parent->cancelRequested.load(memory_order_relaxed);
+}
+
+static const char* jobStateName(JobState s) {
+    switch (s) {
+        case JobState::Queued: return "Antre";
+        case JobState::Running: return "Berjalan";
+        case JobState::Succeeded: return "Selesai";
+        case JobState::Failed: return "Gagal";
+        case JobState::Cancelled: return "Dibatalkan";
+    }
+    return "?";
+}
+
+/**
+ * @brief Waktu lokal saat ini dengan presisi mikrodetik, format DATETIME(6) MySQL.
+ */
+static string currentTimestampMicros() {
+    auto now = chrono::system_clock::now();
+    time_t t = chrono::system_clock::to_time_t(now);
+    long micros = static_cast<long>(chrono::duration_cast<chrono::microseconds>(now.time_since_epoch()).count() % 1000000);
+    tm tmBuf;
+#if defined(_WIN32) || defined(_WIN64)
+    localtime_s(&tmBuf, &t);
+#else
+    localtime_r(&t, &tmBuf);
+#endif
+    char buf[40];
+    size_t n = strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tmBuf);
+    snprintf(buf + n, sizeof(buf) - n, ".%06ld", micros);
+    return buf;
+}
+
+static string formatBytes(uint64_t b) {
+    ostringstream oss;
+    oss << fixed << setprecision(1);
+    if (b >= (1ULL << 30)) oss << b / double(1ULL << 30) << " GB";
+    else if (b >= (1ULL << 20)) oss << b / double(1ULL << 20) << " MB";
+    else if (b >= 1024) oss << b / 1024.0 << " KB";
+    else oss << b << " B";
+    return oss.str();
+}
+
+/**
+ * @class JobManager
+ * Menjalankan operasi panjang (impor, ekspor, backup, data acak, tes stres)
+ * di ThreadPool. Pembatalan bersifat kooperatif lewat jobCancelled().
+ * Thread job dedicated di-join setelah job-nya selesai dan riwayat job yang
+ * sudah selesai dibatasi MAX_FINISHED_JOBS (yang tertua dibuang).
+ */
+class JobManager {
+public:
+    static constexpr size_t MAX_FINISHED_JOBS = 50;
+
+    explicit JobManager(size_t workers = 2) : pool(workers) {}
+
+    ~JobManager() {
+        cancelAll();
+        map<int, thread> remaining;
+        {
+            lock_guard<mutex> lock(jobsMutex);
+            remaining.swap(dedicatedThreads);
+        }
+        for (auto& [id, t] : remaining) t.join(); // ThreadPool menunggu job pool yang tersisa
+    }
+
+    /**
+     * @brief Menjadwalkan job. 'dedicated' untuk job yang berjalan sampai dibatalkan
+     * (follow, rollup berkala): job mendapat thread sendiri sehingga tidak
+     * menahan worker pool selamanya dan job berikutnya tidak antre tanpa batas.
+     */
+    shared_ptr<Job> submit(const string& name, function<bool()> work, bool dedicated = false) {
+        reap();
+        auto job = make_shared<Job>();
+        job->name = name;
+        job->dedicated = dedicated;
+        lock_guard<mutex> lock(jobsMutex);
+        job->id = nextId++;
+        jobs.push_back(job);
+        if (dedicated) {
+            dedicatedThreads.emplace(job->id, thread([this, job, work = std::move(work)]() {
+                execute(*job, work);
+                lock_guard<mutex> lock(jobsMutex);
+                finishedThreads.push_back(job->id); // Di-join oleh reap(); thread ini tidak bisa join dirinya sendiri
+            }));
+        } else {
+            pool.submit([job, work = std::move(work)]() { execute(*job, work); });
+        }
+        return job;
+    }
+
+    /** @brief True jika semua worker pool terpakai: job pool baru akan antre. */
+    bool workersBusy() {
+        lock_guard<mutex> lock(jobsMutex);
+        size_t pooled = count_if(jobs.begin(), jobs.end(), [](const shared_ptr<Job>& j) {
+            JobState s = j->state;
+            return !j->dedicated && (s == JobState::Queued || s == JobState::Running);
+        });
+        return pooled >= pool.size();
+    }
+
+    bool cancel(int id) {
+        lock_guard<mutex> lock(jobsMutex);
+        for (auto& job : jobs) {
+            if (job->id == id) {
+                JobState s = job->state;
+                if (s != JobState::Queued && s != JobState::Running) return false;
+                job->cancelRequested = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void cancelAll() {
+        lock_guard<mutex> lock(jobsMutex);
+        for (auto& job : jobs) job->cancelRequested = true;
+    }
+
+    size_t activeCount() {
+        lock_guard<mutex> lock(jobsMutex);
+        return count_if(jobs.begin(), jobs.end(), [](const shared_ptr<Job>& j) {
+            JobState s = j->state;
+            return s == JobState::Queued || s == JobState::Running;
+        });
+    }
+
+    /**
+     * @brief Menunggu job selesai sambil menampilkan progres di satu baris.
+     */
+    void waitWithProgress(const shared_ptr<Job>& job) {
+        while (true) {
+            JobState s = job->state;
+            if (s != JobState::Queued && s != JobState::Running) break;
+            cout << "\r" << progressLine(*job) << "   " << flush;
+            this_thread::sleep_for(chrono::milliseconds(500));
+        }
+        cout << "\r" << progressLine(*job) << "   " << endl;
+    }
+
+    void printJobs() {
+        reap();
+        vector<shared_ptr<Job>> snapshot;
+        {
+            lock_guard<mutex> lock(jobsMutex);
+            snapshot = jobs;
+        }
+        cout << "\nDaftar Job:\n";
+        cout << left << setw(5) << "ID" << setw(12) << "Status" << setw(12) << "Baris" << setw(12) << "Data"
+             << setw(14) << "Baris/detik" << setw(12) << "Durasi" << setw(10) << "ETA"
+             << setw(24) << "Puncak heap/RSS" << "Nama" << endl;
+        cout << string(124, '-') << endl;
+        if (snapshot.empty()) cout << "(belum ada job)\n";
+        for (auto& job : snapshot) {
+            double eta = job->etaSeconds();
+            ostringstream rate, dur, etaStr;
+            rate << fixed << setprecision(1) << job->rowsPerSecond();
+            dur << fixed << setprecision(1) << job->elapsedSeconds() << " s";
+            if (eta >= 0) etaStr << fixed << setprecision(0) << eta << " s";
+            else etaStr << "-";
+            string mem = job->peakRssBytes ? formatBytes((uint64_t)job->peakHeapBytes.load()) + "/" + formatBytes(job->peakRssBytes)
+                                           : string("-");
+            cout << left << setw(5) << job->id << setw(12) << jobStateName(job->state) << setw(12) << job->rows.load()
+                 << setw(12) << formatBytes(job->bytes) << setw(14) << rate.str() << setw(12) << dur.str()
+                 << setw(10) << etaStr.str() << setw(24) << mem << job->name << endl;
+        }
+        cout << string(124, '-') << endl;
+    }
+
+private:
+    mutex jobsMutex;
+    vector<shared_ptr<Job>> jobs;
+    int nextId = 1;
+    map<int, thread> dedicatedThreads; // id job -> thread, sampai di-join oleh reap()
+    vector<int> finishedThreads;       // Thread dedicated yang job-nya sudah selesai
+    ThreadPool pool;
+
+    static bool finished(const Job& job) {
+        JobState s = job.state;
+        return s != JobState::Queued && s != JobState::Running;
+    }
+
+    /**
+     * @brief Join thread dedicated yang job-nya sudah selesai dan membuang riwayat
+     * job selesai yang tertua di atas MAX_FINISHED_JOBS. Job yang antre/berjalan
+     * tidak pernah dibuang; pemegang shared_ptr<Job> tetap aman.
+     */
+    void reap() {
+        vector<thread> done;
+        {
+            lock_guard<mutex> lock(jobsMutex);
+            for (int id : finishedThreads) {
+                auto it = dedicatedThreads.find(id);
+                if (it == dedicatedThreads.end()) continue;
+                done.push_back(std::move(it->second));
+                dedicatedThreads.erase(it);
+            }
+            finishedThreads.clear();
+
+            size_t finishedCount = count_if(jobs.begin(), jobs.end(), [](const shared_ptr<Job>& j) { return finished(*j); });
+            for (auto it = jobs.begin(); finishedCount > MAX_FINISHED_JOBS && it != jobs.end();) {
+                if (finished(**it)) {
+                    it = jobs.erase(it);
+                    --finishedCount;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        for (thread& t : done) t.join(); // Thread sudah keluar dari execute(): join hanya menunggu return
+    }
+
+    static void execute(Job& job, const function<bool()>& work) {
+        if (job.cancelRequested) {
+            job.state = JobState::Cancelled;
+            return;
+        }
+        job.startedMs = Job::nowMs();
+        job.state = JobState::Running;
+        currentJob = &job;
+        bool ok = false;
+        {
+            MemoryScope memory("job");
+            job.memory = &memory;
+            try {
+                ok = work();
+            } catch (exception& e) {
+                cerr << "Job #" << job.id << " gagal: " << e.what() << endl;
+            }
+            job.updateMemory();
+            job.memory = nullptr;
+        }
+        currentJob = nullptr;
+        job.finishedMs = Job::nowMs();
+        job.state = job.cancelRequested ? JobState::Cancelled : (ok ? JobState::Succeeded : JobState::Failed);
+    }
+
+    static string progressLine(const Job& job) {
+        ostringstream oss;
+        oss << "[Job #" << job.id << " " << jobStateName(job.state) << "] " << job.rows.load();
+        if (job.totalRows) oss << "/" << job.totalRows.load();
+        oss << " baris | " << formatBytes(job.bytes) << " | " << fixed << setprecision(1) << job.rowsPerSecond() << " baris/s";
+        double eta = job.etaSeconds();
+        if (eta >= 0) oss << " | ETA " << setprecision(0) << eta << " s";
+        if (job.peakRssBytes) oss << " | heap " << formatBytes((uint64_t)job.peakHeapBytes.load()) << ", RSS " << formatBytes(job.peakRssBytes);
+        return oss.str();
+    }
+};
+
+// --- PEMANTAU FILE (tail-follow) ---
+
+/**
+ * @struct FollowOptions
+ * Batas micro-batch untuk followCSV: flush setiap 'flushRows' baris
+ * atau paling lambat 'flushMs' ms setelah baris pertama yang tertunda.
+ */
+struct FollowOptions {
+    size_t flushRows = 500;
+    int flushMs = 1000;
+};
+
+/**
+ * @class FileWatcher
+ * Menunggu perubahan pada satu file. Di Linux memakai inotify (tanpa polling);
+ * di platform lain kembali ke sleep singkat. wait() selalu kembali paling lambat
+ * setelah timeoutMs sehingga pemanggil dapat memeriksa deadline dan pembatalan.
+ */
+class FileWatcher {
+public:
+    explicit FileWatcher(const string& filePath) : path(filePath) {
+#if defined(__linux__)
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        addWatch();
+#endif
+    }
+
+    ~FileWatcher() {
+#if defined(__linux__)
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief True jika ada event perubahan sebelum timeout.
+     */
+    bool wait(int timeoutMs) {
+#if defined(__linux__)
+        if (fd >= 0) {
+            if (wd < 0) addWatch(); // file belum ada / baru dirotasi
+            if (wd >= 0) {
+                pollfd pfd = {fd, POLLIN, 0};
+                int rc = poll(&pfd, 1, timeoutMs);
+                if (rc <= 0) return false;
+                alignas(inotify_event) char buf[4096];
+                ssize_t n;
+                bool changed = false;
+                while ((n = read(fd, buf, sizeof(buf))) > 0) {
+                    for (char* p = buf; p < buf + n;) {
+                        inotify_event* ev = (inotify_event*)p;
+                        if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                            if (ev->mask & IN_IGNORED) wd = -1;
+                            else { inotify_rm_watch(fd, wd); wd = -1; }
+                        }
+                        changed = true;
+                        p += sizeof(inotify_event) + ev->len;
+                    }
+                }
+                return changed;
+            }
+        }
+#endif
+        this_thread::sleep_for(chrono::milliseconds(min(timeoutMs, 200)));
+        return false;
+    }
+
+private:
+    string path;
+#if defined(__linux__)
+    int fd = -1;
+    int wd = -1;
+
+    void addWatch() {
+        if (fd >= 0) wd = inotify_add_watch(fd, path.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ATTRIB);
+    }
+#endif
+};
+
+/**
+ * @struct RetentionOptions
+ * Konfigurasi purge retensi bertahap (purgeOlderThan). Baris dengan
+ * timeColumn < cutoff dihapus per potongan berurutan primary key; ukuran
+ * potongan disesuaikan agar setiap DELETE mendekati 'targetChunkMs'.
+ */
+struct RetentionOptions {
+    string timeColumn = "timestamp";
+    string cutoff;              // "YYYY-MM-DD HH:MM:SS"; kosong = NOW() - keepDays (waktu server)
+    int keepDays = 30;
+    size_t chunkRows = 1000;    // Ukuran potongan awal
+    size_t minChunkRows = 100;
+    size_t maxChunkRows = 50000;
+    double targetChunkMs = 100; // Membatasi lama kunci baris dan ukuran undo per transaksi
+    int pauseMs = 50;           // Jeda antar potongan agar workload lain (ingest) mendapat giliran
+};
+
+/**
+ * @struct PartitionOptions
+ * Tata letak PARTITION BY RANGE COLUMNS(timeColumn) per hari/bulan.
+ * 'precreate' periode ke depan selalu disiapkan; partisi yang seluruhnya lebih
+ * tua dari 'retain' periode di-drop (0 = tidak pernah drop).
+ */
+struct PartitionOptions {
+    enum class Granularity { Daily, Monthly };
+    string timeColumn = "timestamp";
+    Granularity granularity = Granularity::Daily;
+    int precreate = 7;
+    int retain = 0;
+};
+
+/**
+ * @struct PartitionInfo
+ * Satu partisi dari information_schema.PARTITIONS. 'bound' kosong = MAXVALUE.
+ * rows dan bytes adalah perkiraan statistik InnoDB.
+ */
+struct PartitionInfo {
+    string name;
+    string bound;
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+};
+
+struct CivilDate {
+    int y, m, d;
+};
+
+/**
+ * @brief Jumlah hari sejak 1970-01-01 untuk tanggal kalender Gregorian (algoritma
+ * days_from_civil Howard Hinnant). Bebas zona waktu, tidak seperti mktime.
+ */
+static int64_t daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static CivilDate civilFromDays(int64_t z) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    const int d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    const int m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    return {static_cast<int>(yoe + era * 400 + (m <= 2)), m, d};
+}
+
+/** @brief Mem-parse awalan 'YYYY-MM-DD' (boleh diikuti jam, boleh diapit kutip). */
+static bool parseCivilDate(string text, CivilDate& out) {
+    text.erase(remove(text.begin(), text.end(), '\''), text.end());
+    return text.size() >= 10 && sscanf(text.c_str(), "%4d-%2d-%2d", &out.y, &out.m, &out.d) == 3
+           && out.m >= 1 && out.m <= 12 && out.d >= 1 && out.d <= 31;
+}
+
+static string civilDateString(const CivilDate& d) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%04d-%02d-%02d", d.y, d.m, d.d);
+    return buf;
+}
+
+static CivilDate periodStart(CivilDate d, PartitionOptions::Granularity g) {
+    if (g == PartitionOptions::Granularity::Monthly) d.d = 1;
+    return d;
+}
+
+static CivilDate addPeriods(const CivilDate& d, PartitionOptions::Granularity g, int n) {
+    if (g == PartitionOptions::Granularity::Daily) return civilFromDays(daysFromCivil(d.y, d.m, d.d) + n);
+    int months = d.y * 12 + (d.m - 1) + n;
+    return {months / 12, months % 12 + 1, 1};
+}
+
+/** @brief Nama partisi untuk periode yang dimulai di 'start': p20261019 / p202610. */
+static string partitionName(const CivilDate& start, PartitionOptions::Granularity g) {
+    char buf[16];
+    if (g == PartitionOptions::Granularity::Daily) snprintf(buf, sizeof(buf), "p%04d%02d%02d", start.y, start.m, start.d);
+    else snprintf(buf, sizeof(buf), "p%04d%02d", start.y, start.m);
+    return buf;
+}
+
+/**
+ * @brief Definisi partisi untuk periode [from, to): masing-masing
+ * "PARTITION pX VALUES LESS THAN ('awal periode berikutnya')".
+ */
+static string partitionDefinitions(CivilDate from, const CivilDate& to, PartitionOptions::Granularity g) {
+    string defs;
+    int64_t end = daysFromCivil(to.y, to.m, to.d);
+    while (daysFromCivil(from.y, from.m, from.d) < end) {
+        CivilDate next = addPeriods(from, g, 1);
+        if (!defs.empty()) defs += ", ";
+        defs += "PARTITION `" + partitionName(from, g) + "` VALUES LESS THAN ('" + civilDateString(next) + "')";
+        from = next;
+    }
+    return defs;
+}
+
+/**
+ * @struct RollupSpec
+ * Definisi rollup satu tabel sumber. Untuk setiap granularitas (menit/jam/hari)
+ * dibuat tabel _dbm_rollup_<sumber>_<granularitas> berisi, per bucket waktu dan
+ * groupColumns: jumlah baris serta count/sum/min/max setiap kolom 'measures'
+ * (rata-rata = sum / count saat dibaca). Disimpan di registri _dbm_rollups
+ * bersama watermark idColumn, sehingga refresh hanya melipat baris baru.
+ */
+struct RollupSpec {
+    string sourceTable;
+    string timeColumn = "timestamp";
+    string idColumn = "id";       // Kunci naik monoton (AUTO_INCREMENT) untuk watermark
+    vector<string> groupColumns;  // Dimensi tambahan, harus NOT NULL (mis. package)
+    vector<string> measures;      // Kolom numerik yang diagregasi
+};
+
+/**
+ * @struct RollupOptions
+ * Baris dengan id <= watermark yang baru di-commit setelah refresh tidak akan
+ * terlipat; 'settleMs' memberi waktu transaksi yang sudah mendapat id lebih
+ * kecil (mis. writer group commit paralel) untuk commit sebelum dilipat.
+ */
+struct RollupOptions {
+    uint64_t foldIds = 100000; // Rentang id per transaksi lipat
+    int settleMs = 500;
+};
+
+static const char* const ROLLUP_GRANULARITIES[] = {"minute", "hour", "day"};
+
+/**
+ * @brief Format DATE_FORMAT untuk memotong waktu ke awal bucket granularitas.
+ */
+static const char* rollupBucketFormat(const string& granularity) {
+    if (granularity == "minute") return "%Y-%m-%d %H:%i:00";
+    if (granularity == "hour") return "%Y-%m-%d %H:00:00";
+    return "%Y-%m-%d 00:00:00";
+}
+
+static string rollupTableName(const string& sourceTable, const string& granularity) {
+    return "_dbm_rollup_" + sourceTable + "_" + granularity;
+}
+
+/**
+ * @brief Preset rollup untuk tabel sensor ingest (suhu, kelembapan, kualitas udara).
+ */
+static RollupSpec sensorRollupSpec(const string& table = "sensor_data") {
+    RollupSpec spec;
+    spec.sourceTable = table;
+    spec.measures = {"temperature", "humidity", "air_quality"};
+    return spec;
+}
+
+/**
+ * @brief Kategori aplikasi per package, sama dengan APP_CATEGORY_MAP di
+ * Server/package_map.py (writer Flask). Package yang tidak dikenal = "Lainnya".
+ */
+static const string& appCategory(string_view package) {
+    static const unordered_map<string_view, string> categories = {
+        {"com.whatsapp", "Sosial"},
+        {"com.instagram.android", "Sosial"},
+        {"org.telegram.messenger", "Sosial"},
+        {"com.twitter.android", "Sosial"},
+        {"com.facebook.katana", "Sosial"},
+        {"com.ss.android.ugc.trill", "Sosial"},
+        {"com.google.android.apps.docs.editors.sheets", "Produktivitas"},
+        {"com.google.android.apps.docs.editors.docs", "Produktivitas"},
+        {"com.google.android.apps.tachyon", "Produktivitas"},
+        {"com.google.android.gm", "Produktivitas"},
+        {"com.google.android.apps.drive", "Produktivitas"},
+        {"com.google.android.youtube", "Hiburan"},
+        {"com.netflix.mediaclient", "Hiburan"},
+        {"com.spotify.music", "Hiburan"},
+        {"com.android.chrome", "Browser"},
+        {"com.miui.home", "Sistem"},
+        {"com.android.systemui", "Sistem"},
+        {"com.android.vending", "Sistem"},
+    };
+    static const string other = "Lainnya";
+    auto it = categories.find(package);
+    return it != categories.end() ? it->second : other;
+}
+
+/**
+ * @brief Preset rollup untuk tabel pemakaian aplikasi ingest, dikelompokkan per
+ * kategori lalu package: total layar per kategori = SUM foreground_time_s semua
+ * package di kategori itu dalam bucket (awalan kunci rollup).
+ * total_screen_time_s adalah total kumulatif per laporan, jadi bacalah nilai max-nya.
+ */
+static RollupSpec usageRollupSpec(const string& table = "usage_events") {
+    RollupSpec spec;
+    spec.sourceTable = table;
+    spec.groupColumns = {"category", "package"};
+    spec.measures = {"foreground_time_s", "total_screen_time_s"};
+    return spec;
+}
+
+/**
+ * @brief Memecah string berdasarkan pemisah dan membuang spasi di tepi tiap elemen.
+ * Elemen kosong dibuang.
+ */
+vector<string> splitList(const string& text, char sep = ',') {
+    vector<string> items;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, sep)) {
+        item.erase(item.begin(), find_if(item.begin(), item.end(), [](int ch) { return !isspace(ch); }));
+        item.erase(find_if(item.rbegin(), item.rend(), [](int ch) { return !isspace(ch); }).base(), item.end());
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+static string joinList(const vector<string>& items, const string& sep = ",") {
+    string out;
+    for (size_t i = 0; i < items.size(); ++i) out += (i ? sep : "") + items[i];
+    return out;
+}
+
+/**
+ * @brief Inti parser CSV (menangani tanda kutip): byte field ditambahkan ke 'out'
+ * dan endField() dipanggil di akhir setiap field. Potongan tanpa karakter khusus
+ * disalin sekaligus, bukan per karakter.
+ */
+template <typename EndField>
+static void parseCSVInto(string_view line, string& out, EndField&& endField) {
+    bool inQuotes = false;
+    size_t i = 0, n = line.size();
+    while (i < n) {
+        size_t start = i;
+        if (inQuotes) {
+            while (i < n && line[i] != '"') ++i;
+            out.append(line.data() + start, i - start);
+            if (i == n) break;
+            if (i + 1 < n && line[i + 1] == '"') {
+                out += '"';
+                i += 2;
+            } else {
+                inQuotes = false;
+                ++i;
+            }
+        } else {
+            while (i < n && line[i] != ',' && line[i] != '"' && line[i] != '\r') ++i;
+            out.append(line.data() + start, i - start);
+            if (i == n) break;
+            if (line[i] == '"') inQuotes = true;
+            else if (line[i] == ',') endField();
+            ++i; // '\r' di luar kutip dibuang
+        }
+    }
+    endField();
+}
+
+/**
+ * @brief Mem-parsing satu baris CSV, menangani tanda kutip.
+ */
+static vector<string> parseCSVLine(const string& line) {
+    vector<string> fields;
+    string field;
+    parseCSVInto(line, field, [&]() {
+        fields.push_back(field);
+        field.clear();
+    });
+    return fields;
+}
+
+/**
+ * @brief Menambahkan satu nilai CSV ke 'out': nilai yang mengandung koma,
+ * tanda kutip, atau newline dibungkus kutip dengan kutip digandakan.
+ */
+static void appendCSVField(string& out, string_view value) {
+    if (value.find_first_of(",\"\n") == string_view::npos) {
+        out.append(value.data(), value.size());
+        return;
+    }
+    out += '"';
+    for (char c : value) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+/**
+ * @brief Timestamp lokal "YYYY-MM-DD HH:MM:SS" untuk baris log.
+ */
+static string formatLogTimestamp(chrono::system_clock::time_point when) {
+    time_t t = chrono::system_clock::to_time_t(when);
+    tm tmBuf;
+#if defined(_WIN32) || defined(_WIN64)
+    localtime_s(&tmBuf, &t);
+#else
+    localtime_r(&t, &tmBuf);
+#endif
+    ostringstream oss;
+    oss << put_time(&tmBuf, "%Y-%m-%d %H:%M:%S");
+    return oss.str();
+}
+
+/**
+ * @class RowBatch
+ * Batch baris untuk pipeline impor/ekspor: byte semua field disimpan di satu
+ * arena bersambung, dengan satu array offset (akhir tiap field) dan nomor baris
+ * sumber per baris. clear() mempertahankan kapasitas, jadi batch yang dipakai
+ * ulang tidak lagi mengalokasikan per field/baris setelah batch pertama.
+ * Field dibaca sebagai string_view yang berlaku sampai batch diubah lagi.
+ */
+class RowBatch {
+public:
+    explicit RowBatch(size_t columns = 1) : cols(max<size_t>(1, columns)) {}
+
+    /** @brief Mengosongkan batch dan mengganti jumlah kolom. */
+    void reset(size_t columns) {
+        cols = max<size_t>(1, columns);
+        clear();
+    }
+
+    void clear() {
+        arena.clear();
+        ends.clear();
+        lines.clear();
+    }
+
+    void reserve(size_t rows, size_t bytesPerRow) {
+        arena.reserve(rows * bytesPerRow);
+        ends.reserve(rows * cols);
+        lines.reserve(rows);
+    }
+
+    size_t columns() const { return cols; }
+    size_t size() const { return lines.size(); }
+    bool empty() const { return lines.empty(); }
+    size_t bytes() const { return arena.size(); }
+    uint64_t lineNumber(size_t row) const { return lines[row]; }
+
+    string_view field(size_t row, size_t col) const {
+        size_t i = row * cols + col;
+        size_t begin = i == 0 ? 0 : ends[i - 1];
+        return string_view(arena.data() + begin, ends[i] - begin);
+    }
+
+    /**
+     * @brief Mem-parsing satu baris CSV langsung ke arena. Baris hanya disimpan jika
+     * jumlah field sama dengan columns(); jika tidak, arena dikembalikan seperti semula.
+     * @return Jumlah field hasil parsing (untuk pesan error).
+     */
+    size_t appendCSVLine(string_view line, uint64_t lineNumber) {
+        size_t first = ends.size();
+        parseCSVInto(line, arena, [this]() { ends.push_back(arena.size()); });
+        size_t n = ends.size() - first;
+        if (n == cols) lines.push_back(lineNumber);
+        else discardPending();
+        return n;
+    }
+
+    /** @brief Menambahkan satu field ke baris yang sedang disusun (lihat finishRow). */
+    void addField(string_view value) {
+        arena.append(value.data(), value.size());
+        ends.push_back(arena.size());
+    }
+
+    /** @brief Menutup baris yang disusun dengan addField(); ditolak jika jumlah field salah. */
+    bool finishRow(uint64_t lineNumber = 0) {
+        if (ends.size() - lines.size() * cols != cols) {
+            discardPending();
+            return false;
+        }
+        lines.push_back(lineNumber);
+        return true;
+    }
+
+    /** @brief Membuang baris terakhir (mis. ditolak dedupe setelah di-parse). */
+    void popRow() {
+        if (lines.empty()) return;
+        lines.pop_back();
+        discardPending();
+    }
+
+private:
+    size_t cols;
+    string arena;
+    vector<size_t> ends;    // ends[r * cols + c] = offset akhir field (r, c) di arena
+    vector<uint64_t> lines; // Nomor baris sumber (untuk pesan error per baris)
+
+    void discardPending() {
+        size_t keep = lines.size() * cols;
+        arena.resize(keep == 0 ? 0 : ends[keep - 1]);
+        ends.resize(keep);
+    }
+};
+
+/**
+ * @brief Menulis semua baris 'batch' sebagai baris CSV ter-escape ke akhir 'out'.
+ */
+static void appendCSVRows(const RowBatch& batch, string& out) {
+    for (size_t r = 0; r < batch.size(); ++r) {
+        for (size_t c = 0; c < batch.columns(); ++c) {
+            if (c) out += ',';
+            appendCSVField(out, batch.field(r, c));
+        }
+        out += '\n';
+    }
+}
+
+// Codec record bertipe (RecordSchema): bind, CSV, dan teks angka tanpa stringstream
+
+static void bindField(sql::PreparedStatement* pstmt, unsigned int idx, const string& v) { pstmt->setString(idx, v); }
+static void bindField(sql::PreparedStatement* pstmt, unsigned int idx, double v) { pstmt->setDouble(idx, v); }
+static void bindField(sql::PreparedStatement* pstmt, unsigned int idx, int64_t v) { pstmt->setInt64(idx, v); }
+
+template <typename T>
+static void bindField(sql::PreparedStatement* pstmt, unsigned int idx, const optional<T>& v) {
+    if (v) {
+        bindField(pstmt, idx, *v);
+        return;
+    }
+    if constexpr (is_same_v<T, double>) pstmt->setNull(idx, sql::DataType::DOUBLE);
+    else if constexpr (is_same_v<T, int64_t>) pstmt->setNull(idx, sql::DataType::BIGINT);
+    else pstmt->setNull(idx, sql::DataType::VARCHAR);
+}
+
+/**
+ * @brief Bind satu record mulai placeholder 'idx' (urutan RecordSchema), lalu memajukan idx.
+ * Angka di-bind sebagai DOUBLE/BIGINT, bukan teks yang harus dikonversi server.
+ */
+template <typename Record>
+static void bindRecord(sql::PreparedStatement* pstmt, unsigned int& idx, const Record& rec) {
+    forEachColumn<Record>([&](const auto& column) { bindField(pstmt, idx++, rec.*(column.member)); });
+}
+
+/** @brief Overload generik untuk visitRows: satu baris nilai teks (nullopt = NULL). */
+static void bindRecord(sql::PreparedStatement* pstmt, unsigned int& idx, const vector<optional<string>>& row) {
+    for (const optional<string>& v : row) {
+        if (v) pstmt->setString(idx++, *v);
+        else pstmt->setNull(idx++, sql::DataType::VARCHAR);
+    }
+}
+
+template <typename T>
+static void appendNumber(string& out, T v) {
+    char buf[32];
+    auto res = to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, static_cast<size_t>(res.ptr - buf));
+}
+
+static void appendCSVValue(string& out, const string& v) { appendCSVField(out, v); }
+static void appendCSVValue(string& out, double v) { appendNumber(out, v); }
+static void appendCSVValue(string& out, int64_t v) { appendNumber(out, v); }
+
+template <typename T>
+static void appendCSVValue(string& out, const optional<T>& v) {
+    if (v) appendCSVValue(out, *v); // NULL = field kosong, sama seperti exportToCSV
+}
+
+/** @brief Menulis record sebagai satu baris CSV (urutan kolom = recordColumnNames). */
+template <typename Record>
+static void appendRecordCSV(string& out, const Record& rec) {
+    bool first = true;
+    forEachColumn<Record>([&](const auto& column) {
+        if (!first) out += ',';
+        first = false;
+        appendCSVValue(out, rec.*(column.member));
+    });
+    out += '\n';
+}
+
+/** @brief Kolom teks wajib: kosong/"NULL" ditolak agar jalur teks tetap mengirim NULL. */
+static bool parseFieldText(string_view text, string& v) {
+    if (text.empty() || text == "NULL") return false;
+    v.assign(text.data(), text.size());
+    return true;
+}
+
+template <typename T>
+static bool parseNumberText(string_view text, T& v) {
+    auto res = from_chars(text.data(), text.data() + text.size(), v);
+    return res.ec == errc() && res.ptr == text.data() + text.size();
+}
+
+static bool parseFieldText(string_view text, double& v) { return parseNumberText(text, v); }
+static bool parseFieldText(string_view text, int64_t& v) { return parseNumberText(text, v); }
+
+template <typename T>
+static bool parseFieldText(string_view text, optional<T>& v) {
+    if (text.empty() || text == "NULL") { // Konvensi impor CSV
+        v.reset();
+        return true;
+    }
+    T value{};
+    if (!parseFieldText(text, value)) return false;
+    v = std::move(value);
+    return true;
+}
+
+/**
+ * @brief Men-decode baris 'row' RowBatch ke record. Kolom batch harus berurutan
+ * sama dengan recordColumnNames<Record>(). False jika ada nilai yang tidak valid.
+ */
+template <typename Record>
+static bool decodeRecordCSV(const RowBatch& batch, size_t row, Record& rec) {
+    if (batch.columns() != recordColumnCount<Record>()) return false;
+    size_t c = 0;
+    bool ok = true;
+    forEachColumn<Record>([&](const auto& column) {
+        ok = ok && parseFieldText(batch.field(row, c++), rec.*(column.member));
+    });
+    return ok;
+}
+
+/**
+ * @brief Tipe record untuk CSV impor/ekspor: hanya tabel bawaan RecordSchema yang
+ * kolomnya persis recordColumnNames (mis. header Server/sensor_data.csv).
+ * Selain itu CSV memakai jalur teks generik.
+ */
+enum class CSVRecordKind { None, Sensor, Usage };
+
+static CSVRecordKind csvRecordKind(const string& table, const vector<string>& columns) {
+    if (table == RecordSchema<SensorReading>::defaultTable && columns == recordColumnNames<SensorReading>()) return CSVRecordKind::Sensor;
+    if (table == RecordSchema<AppUsage>::defaultTable && columns == recordColumnNames<AppUsage>()) return CSVRecordKind::Usage;
+    return CSVRecordKind::None;
+}
+
+/** @brief Decode lalu bind baris CSV sebagai Record; tidak mem-bind apa pun jika decode gagal. */
+template <typename Record>
+static bool bindCSVRecord(sql::PreparedStatement* pstmt, unsigned int& idx, const RowBatch& batch, size_t row) {
+    Record rec;
+    if (!decodeRecordCSV(batch, row, rec)) return false;
+    bindRecord(pstmt, idx, rec);
+    return true;
+}
+
+static void readResultField(sql::ResultSet* res, unsigned int idx, string& v) {
+    sql::SQLString text = res->getString(idx);
+    v.assign(text.c_str(), text.length());
+}
+static void readResultField(sql::ResultSet* res, unsigned int idx, double& v) { v = static_cast<double>(res->getDouble(idx)); }
+static void readResultField(sql::ResultSet* res, unsigned int idx, int64_t& v) { v = res->getInt64(idx); }
+
+template <typename T>
+static void readResultField(sql::ResultSet* res, unsigned int idx, optional<T>& v) {
+    if (res->isNull(idx)) {
+        v.reset();
+        return;
+    }
+    T value{};
+    readResultField(res, idx, value);
+    v = std::move(value);
+}
+
+/** @brief Membaca baris aktif 'res' (kolom = recordColumnNames) langsung ke record bertipe. */
+template <typename Record>
+static void readRecordRow(sql::ResultSet* res, Record& rec) {
+    unsigned int idx = 1;
+    forEachColumn<Record>([&](const auto& column) { readResultField(res, idx++, rec.*(column.member)); });
+}
+
+/**
+ * @class RowDeduper
+ * Menandai baris duplikat berdasarkan hash FNV-1a 64-bit dari kolom kunci.
+ * Mode eksak menyimpan hash di unordered_set (tabrakan 64-bit dapat diabaikan
+ * untuk ukuran file praktis). Jika jumlah kunci melewati maxExactKeys, isi set
+ * dipindah ke Bloom filter berukuran tetap: memori tidak bertambah lagi, dengan
+ * imbalan sebagian kecil baris unik ikut terbuang (false positive, dilaporkan).
+ */
+class RowDeduper {
+public:
+    RowDeduper(const DedupeOptions& options, const vector<string>& header) : opts(options) {
+        if (opts.keyColumns.size() == 1 && opts.keyColumns[0] == "*") {
+            for (size_t i = 0; i < header.size(); ++i) keyIndex.push_back(i);
+        } else {
+            for (const string& key : opts.keyColumns) {
+                auto it = find(header.begin(), header.end(), key);
+                if (it == header.end()) {
+                    missing = key;
+                    return;
+                }
+                keyIndex.push_back(static_cast<size_t>(it - header.begin()));
+            }
+        }
+        if (opts.bloom) startBloom();
+    }
+
+    /** @brief Kolom kunci yang tidak ada di header (kosong jika valid). */
+    const string& missingColumn() const { return missing; }
+
+    /**
+     * @brief True jika kunci baris 'row' sudah pernah terlihat; jika belum, kunci dicatat.
+     * 'lineBytes' (ukuran baris mentah) dijumlahkan untuk laporan byte yang dihemat.
+     */
+    bool seen(const RowBatch& batch, size_t row, size_t lineBytes = 0) {
+        uint64_t hash = 1469598103934665603ULL;
+        for (size_t i : keyIndex) hash = hashKeyField(batch.field(row, i), hash);
+        return seenHash(hash, lineBytes);
+    }
+
+    bool usingBloom() const { return !bits.empty(); }
+    uint64_t checkedRows() const { return checked; }
+    uint64_t duplicateRows() const { return duplicates; }
+    uint64_t droppedBytes() const { return dropped; }
+
+    /** @brief Perkiraan laju false positive Bloom saat ini (0 untuk mode eksak). */
+    double falsePositiveRate() const {
+        if (bits.empty()) return 0.0;
+        return pow(1.0 - exp(-double(BLOOM_HASHES) * bloomKeys / double(bits.size() * 64)), BLOOM_HASHES);
+    }
+
+    size_t memoryBytes() const {
+        return bits.empty() ? exact.size() * (sizeof(uint64_t) + 2 * sizeof(void*)) + exact.bucket_count() * sizeof(void*)
+                            : bits.size() * sizeof(uint64_t);
+    }
+
+private:
+    static const int BLOOM_HASHES = 7;
+
+    DedupeOptions opts;
+    vector<size_t> keyIndex;
+    string missing;
+    unordered_set<uint64_t> exact;
+    vector<uint64_t> bits;
+    uint64_t bloomKeys = 0;
+    uint64_t checked = 0;
+    uint64_t duplicates = 0;
+    uint64_t dropped = 0;
+
+    static uint64_t hashKeyField(string_view value, uint64_t hash) {
+        hash = fnv1a64(value.data(), value.size(), hash);
+        return fnv1a64("\x1f", 1, hash); // Pemisah agar ("ab","c") != ("a","bc")
+    }
+
+    bool seenHash(uint64_t hash, size_t lineBytes) {
+        checked++;
+        bool duplicate;
+        if (bits.empty()) {
+            duplicate = !exact.insert(hash).second;
+            if (!duplicate && exact.size() > opts.maxExactKeys) startBloom();
+        } else {
+            duplicate = bloomTestAndSet(hash);
+            if (!duplicate) bloomKeys++;
+        }
+        if (duplicate) {
+            duplicates++;
+            dropped += lineBytes;
+        }
+        return duplicate;
+    }
+
+    void startBloom() {
+        bits.assign(max<size_t>(1, opts.bloomBits / 64), 0);
+        if (!exact.empty()) {
+            cout << "Dedupe: " << exact.size() << " kunci melewati batas hash set; beralih ke Bloom filter ("
+                 << formatBytes(bits.size() * sizeof(uint64_t)) << ")." << endl;
+        }
+        for (uint64_t h : exact) bloomTestAndSet(h);
+        bloomKeys += exact.size();
+        unordered_set<uint64_t>().swap(exact);
+    }
+
+    // Double hashing (Kirsch-Mitzenmacher): posisi ke-i = h1 + i*h2
+    bool bloomTestAndSet(uint64_t hash) {
+        uint64_t h2 = hash * 0x9E3779B97F4A7C15ULL;
+        h2 = (h2 ^ (h2 >> 31)) | 1;
+        const uint64_t m = bits.size() * 64;
+        bool present = true;
+        for (int i = 0; i < BLOOM_HASHES; ++i) {
+            uint64_t bit = (hash + i * h2) % m;
+            uint64_t mask = 1ULL << (bit & 63);
+            if (!(bits[bit >> 6] & mask)) {
+                present = false;
+                bits[bit >> 6] |= mask;
+            }
+        }
+        return present;
+    }
+};
+
+/**
+ * @struct ResultCacheOptions
+ * Batas cache hasil selectData. maxBytes adalah perkiraan memori total
+ * (isi sel + overhead per sel); hasil yang lebih besar dari maxEntryBytes
+ * tidak disimpan sama sekali. maxAgeMs membatasi umur entri karena tulis
+ * dari koneksi/proses lain tidak terlihat oleh invalidasi lokal (0 = tanpa batas).
+ */
+struct ResultCacheOptions {
+    size_t maxBytes = 64u << 20;
+    size_t maxEntryBytes = 8u << 20;
+    int64_t maxAgeMs = 60000;
+};
+
+/**
+ * @class ResultCache
+ * Cache LRU untuk hasil SELECT per tabel. Kunci dibentuk dari database,
+ * tabel, serta pasangan kolom=nilai filter; setiap entri juga didaftarkan
+ * di indeks per tabel ("db.tabel") sehingga satu tulis cukup membuang
+ * entri tabel itu saja, bukan seluruh cache. Thread-safe (mutex sendiri,
+ * tidak pernah dipegang bersamaan dengan query).
+ */
+class ResultCache {
+public:
+    explicit ResultCache(const ResultCacheOptions& options = ResultCacheOptions())
+        : opts(options),
+          hitsTotal(metrics().counter("dbm_result_cache_hits_total", "Pencarian cache hasil selectData yang kena")),
+          missesTotal(metrics().counter("dbm_result_cache_misses_total", "Pencarian cache hasil selectData yang meleset")),
+          evictionsTotal(metrics().counter("dbm_result_cache_evictions_total", "Entri dibuang karena batas byte (LRU)")),
+          invalidationsTotal(metrics().counter("dbm_result_cache_invalidations_total", "Entri dibuang karena tulis ke tabelnya")),
+          bytesGauge(metrics().gauge("dbm_result_cache_bytes", "Perkiraan memori cache hasil")),
+          entriesGauge(metrics().gauge("dbm_result_cache_entries", "Jumlah entri cache hasil")) {}
+
+    ~ResultCache() { clear(); }
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    /** @brief Cakupan invalidasi satu tabel. */
+    static string scopeOf(const string& db, const string& table) { return db + "." + table; }
+
+    /** @brief Kunci cache; tiap bagian diberi awalan panjang agar ("a=b","c") != ("a","b=c"). */
+    static string makeKey(const string& db, const string& table, const vector<string>& columns, const vector<string>& values) {
+        string key;
+        auto append = [&key](const string& part) {
+            key += to_string(part.size());
+            key += ':';
+            key += part;
+        };
+        append(db);
+        append(table);
+        for (size_t i = 0; i < columns.size(); ++i) {
+            append(columns[i]);
+            append(values[i]);
+        }
+        return key;
+    }
+
+    /** @brief Perkiraan memori satu baris (dipakai juga saat mengisi hasil secara bertahap). */
+    static size_t rowBytes(const vector<optional<string>>& row) {
+        size_t bytes = sizeof(row) + row.size() * sizeof(optional<string>);
+        for (const auto& cell : row) {
+            if (cell && cell->size() > 15) bytes += cell->capacity() + 1; // Di luar SSO
+        }
+        return bytes;
+    }
+
+    size_t entryLimit() const { return opts.maxEntryBytes; }
+
+    /**
+     * @brief Penanda invalidasi; diambil sebelum query dan diteruskan ke put()
+     * agar hasil yang dibaca bersamaan dengan tulis tidak disimpan.
+     */
+    uint64_t generation() {
+        lock_guard<mutex> lock(m);
+        return gen;
+    }
+
+    /** @brief Menyalin hasil ke 'out' jika ada entri yang belum kedaluwarsa. */
+    bool get(const string& key, QueryResult& out) {
+        lock_guard<mutex> lock(m);
+        auto it = index.find(key);
+        if (it != index.end() && opts.maxAgeMs > 0 &&
+            chrono::steady_clock::now() - it->second->storedAt > chrono::milliseconds(opts.maxAgeMs)) {
+            eraseUnlocked(it->second);
+            it = index.end();
+        }
+        if (it == index.end()) {
+            misses++;
+            missesTotal.add();
+            return false;
+        }
+        lru.splice(lru.begin(), lru, it->second);
+        out = it->second->result;
+        hits++;
+        hitsTotal.add();
+        return true;
+    }
+
+    /**
+     * @brief Menyimpan hasil; 'bytes' dari rowBytes(). Entri terlama dibuang hingga muat.
+     * Diabaikan jika ada invalidasi sejak 'seenGeneration' diambil.
+     */
+    void put(const string& scope, const string& key, QueryResult result, size_t bytes, uint64_t seenGeneration) {
+        for (const string& c : result.columns) bytes += sizeof(string) + c.size();
+        if (bytes > opts.maxEntryBytes || bytes > opts.maxBytes) return;
+
+        lock_guard<mutex> lock(m);
+        if (seenGeneration != gen) return;
+        auto existing = index.find(key);
+        if (existing != index.end()) eraseUnlocked(existing->second);
+        while (!lru.empty() && used + bytes > opts.maxBytes) {
+            eraseUnlocked(prev(lru.end()));
+            evictionsTotal.add();
+        }
+        lru.push_front(Entry{key, scope, std::move(result), bytes, chrono::steady_clock::now()});
+        index[key] = lru.begin();
+        byScope[scope].insert(key);
+        used += bytes;
+        bytesGauge.add(static_cast<int64_t>(bytes));
+        entriesGauge.add(1);
+    }
+
+    /** @brief Membuang semua entri milik satu tabel ("db.tabel"). */
+    void invalidate(const string& scope) {
+        lock_guard<mutex> lock(m);
+        gen++;
+        auto it = byScope.find(scope);
+        if (it == byScope.end()) return;
+        vector<string> keys(it->second.begin(), it->second.end());
+        for (const string& key : keys) {
+            auto entry = index.find(key);
+            if (entry == index.end()) continue;
+            eraseUnlocked(entry->second);
+            invalidationsTotal.add();
+        }
+    }
+
+    /** @brief Membuang semua entri (mis. setelah SQL bebas yang tidak bisa dipetakan ke tabel). */
+    void clear() {
+        lock_guard<mutex> lock(m);
+        gen++;
+        invalidationsTotal.add(lru.size());
+        bytesGauge.add(-static_cast<int64_t>(used));
+        entriesGauge.add(-static_cast<int64_t>(lru.size()));
+        lru.clear();
+        index.clear();
+        byScope.clear();
+        used = 0;
+    }
+
+    void printStats() {
+        lock_guard<mutex> lock(m);
+        uint64_t lookups = hits + misses;
+        cout << "Cache hasil: " << lru.size() << " entri, " << formatBytes(used) << " / " << formatBytes(opts.maxBytes)
+             << " (maks " << formatBytes(opts.maxEntryBytes) << " per entri, umur maks "
+             << (opts.maxAgeMs > 0 ? to_string(opts.maxAgeMs / 1000) + " dtk" : string("tanpa batas")) << ")" << endl;
+        cout << "  Kena: " << hits << ", meleset: " << misses << ", rasio kena: " << fixed << setprecision(1)
+             << (lookups ? 100.0 * hits / lookups : 0.0) << "%" << defaultfloat << setprecision(6) << endl;
+    }
+
+private:
+    struct Entry {
+        string key;
+        string scope;
+        QueryResult result;
+        size_t bytes;
+        chrono::steady_clock::time_point storedAt;
+    };
+
+    ResultCacheOptions opts;
+    mutex m;
+    list<Entry> lru; // Depan = paling baru dipakai
+    unordered_map<string, list<Entry>::iterator> index;
+    unordered_map<string, unordered_set<string>> byScope;
+    size_t used = 0;
+    uint64_t gen = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    MetricCounter& hitsTotal;
+    MetricCounter& missesTotal;
+    MetricCounter& evictionsTotal;
+    MetricCounter& invalidationsTotal;
+    MetricGauge& bytesGauge;
+    MetricGauge& entriesGauge;
+
+    void eraseUnlocked(list<Entry>::iterator it) {
+        auto scope = byScope.find(it->scope);
+        if (scope != byScope.end()) {
+            scope->second.erase(it->key);
+            if (scope->second.empty()) byScope.erase(scope);
+        }
+        used -= it->bytes;
+        bytesGauge.add(-static_cast<int64_t>(it->bytes));
+        entriesGauge.add(-1);
+        index.erase(it->key);
+        lru.erase(it);
+    }
+};
+
+/**
+ * @struct FilterObservation
+ * Statistik satu pola filter (tabel + himpunan kolom WHERE =) yang dibangun
+ * oleh selectData/updateData/deleteData, beserta rencana EXPLAIN terakhir.
+ */
+struct FilterObservation {
+    string db;
+    string table;
+    vector<string> columns; // Urutan saat pertama kali terlihat
+    uint64_t calls = 0;
+    uint64_t fullScans = 0;
+    double totalMs = 0;
+    double maxMs = 0;
+    bool explained = false;
+    string accessType; // Kolom 'type' EXPLAIN (ALL = full scan)
+    string key;        // Indeks yang dipilih optimizer (kosong jika tidak ada)
+    uint64_t estimatedRows = 0;
+};
+
+/**
+ * @struct IndexRecommendation
+ * Satu baris laporan index advisor, diurutkan menurut total waktu query.
+ */
+struct IndexRecommendation {
+    string db;
+    string table;
+    vector<string> columns;
+    string indexName;
+    string ddl;
+    uint64_t calls = 0;
+    double totalMs = 0;
+    double avgMs = 0;
+    string accessType;
+    uint64_t estimatedRows = 0;
+};
+
+/**
+ * @class IndexAdvisor
+ * Mencatat pola filter dan latensinya. EXPLAIN cukup dijalankan sekali per pola
+ * (needsPlan), lalu diulang hanya setelah indeks tabel berubah (forgetPlans).
+ * Pola dengan kolom yang sama dalam urutan berbeda digabung.
+ */
+class IndexAdvisor {
+public:
+    IndexAdvisor()
+        : fullScansTotal(metrics().counter("dbm_filter_full_scans_total", "Query berfilter yang dieksekusi dengan full table scan")),
+          filterMs(metrics().histogram("dbm_filter_query_ms", "Latensi query berfilter dari menu (ms)",
+                                       {1, 5, 10, 50, 100, 500, 1000, 5000, 30000})) {}
+
+    /** @brief Mencatat satu eksekusi; true jika pola ini belum punya rencana EXPLAIN. */
+    bool record(const string& db, const string& table, const vector<string>& columns, double elapsedMs) {
+        filterMs.observe(elapsedMs);
+        lock_guard<mutex> lock(m);
+        FilterObservation& o = observations[keyOf(db, table, columns)];
+        if (o.calls == 0) {
+            o.db = db;
+            o.table = table;
+            o.columns = columns;
+        }
+        o.calls++;
+        o.totalMs += elapsedMs;
+        o.maxMs = max(o.maxMs, elapsedMs);
+        if (o.explained && o.accessType == "ALL") {
+            o.fullScans++;
+            fullScansTotal.add();
+        }
+        return !o.explained;
+    }
+
+    /** @brief Menyimpan rencana EXPLAIN; true jika rencananya full table scan. */
+    bool setPlan(const string& db, const string& table, const vector<string>& columns,
+                 const string& accessType, const string& key, uint64_t estimatedRows) {
+        lock_guard<mutex> lock(m);
+        auto it = observations.find(keyOf(db, table, columns));
+        if (it == observations.end()) return false;
+        FilterObservation& o = it->second;
+        o.explained = true;
+        o.accessType = accessType;
+        o.key = key;
+        o.estimatedRows = estimatedRows;
+        if (accessType == "ALL") {
+            o.fullScans++; // Eksekusi yang baru saja dicatat
+            fullScansTotal.add();
+        }
+        return accessType == "ALL";
+    }
+
+    /** @brief Membuang rencana EXPLAIN satu tabel (setelah indeks ditambah/dihapus). */
+    void forgetPlans(const string& db, const string& table) {
+        lock_guard<mutex> lock(m);
+        for (auto& [key, o] : observations) {
+            if (o.db == db && o.table == table) o.explained = false;
+        }
+    }
+
+    vector<FilterObservation> snapshot() {
+        lock_guard<mutex> lock(m);
+        vector<FilterObservation> out;
+        out.reserve(observations.size());
+        for (const auto& [key, o] : observations) out.push_back(o);
+        return out;
+    }
+
+    /** @brief Nama indeks yang disarankan; dipendekkan dengan hash jika melebihi 64 karakter. */
+    static string indexNameFor(const vector<string>& columns) {
+        string name = "idx_dbm_" + joinList(columns, "_");
+        if (name.size() <= 64) return name;
+        ostringstream oss;
+        oss << name.substr(0, 55) << "_" << hex << setw(8) << setfill('0') << (fnv1a64(name.data(), name.size()) & 0xffffffffULL);
+        return oss.str();
+    }
+
+private:
+    mutex m;
+    map<string, FilterObservation> observations;
+    MetricCounter& fullScansTotal;
+    MetricHistogram& filterMs;
+
+    static string keyOf(const string& db, const string& table, vector<string> columns) {
+        sort(columns.begin(), columns.end());
+        return db + "." + table + "|" + joinList(columns);
+    }
+};
+
+/**
+ * @brief Sidik jari SQL untuk pengelompokan: literal string/angka menjadi '?',
+ * daftar '(?,?,...)' menjadi '(?+)', komentar dibuang, spasi diringkas,
+ * dan huruf dikecilkan (kecuali identifier ber-backtick).
+ */
+static string fingerprintSQL(const string& sql) {
+    string out;
+    out.reserve(sql.size());
+    auto isWord = [](char c) { return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$'; };
+    auto isToken = [&](char c) { return isWord(c) || c == '?' || c == '`' || c == '*'; };
+    bool pendingSpace = false;
+    // Spasi hanya dipertahankan di antara dua token kata, sehingga "a=1" dan "a = 1" sama
+    auto emit = [&](char first) {
+        if (pendingSpace && !out.empty() && isToken(out.back()) && isToken(first)) out += ' ';
+        pendingSpace = false;
+    };
+    size_t i = 0;
+    while (i < sql.size()) {
+        char c = sql[i];
+        if (c == '\'' || c == '"') {
+            for (++i; i < sql.size() && sql[i] != c; ++i) {
+                if (sql[i] == '\\') ++i;
+            }
+            ++i;
+            emit('?');
+            out += '?';
+        } else if (c == '`') {
+            size_t end = sql.find('`', i + 1);
+            if (end == string::npos) end = sql.size() - 1;
+            emit('`');
+            out.append(sql, i, end - i + 1);
+            i = end + 1;
+        } else if (c == '-' && i + 1 < sql.size() && sql[i + 1] == '-') {
+            while (i < sql.size() && sql[i] != '\n') ++i;
+        } else if (c == '/' && i + 1 < sql.size() && sql[i + 1] == '*') {
+            size_t end = sql.find("*/", i + 2);
+            i = end == string::npos ? sql.size() : end + 2;
+        } else if (isdigit(static_cast<unsigned char>(c)) && (out.empty() || pendingSpace || !isWord(out.back()))) {
+            while (i < sql.size() && (isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '.')) ++i;
+            emit('?');
+            out += '?';
+        } else if (isspace(static_cast<unsigned char>(c)) || c == ';') {
+            pendingSpace = true;
+            ++i;
+        } else {
+            emit(c);
+            out += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+            ++i;
+        }
+    }
+
+    // Ringkas daftar nilai: "(?,?,?)" -> "(?+)", lalu "(?+),(?+)" -> "(?+)"
+    string folded;
+    for (size_t p = 0; p < out.size();) {
+        if (out[p] == '(') {
+            size_t q = p + 1;
+            bool onlyValues = true, any = false;
+            while (q < out.size() && out[q] != ')') {
+                if (out[q] == '?') any = true;
+                else if (out[q] != ',') onlyValues = false;
+                ++q;
+            }
+            if (q < out.size() && onlyValues && any) {
+                folded += "(?+)";
+                p = q + 1;
+                continue;
+            }
+        }
+        folded += out[p++];
+    }
+    for (size_t pos; (pos = folded.find("(?+),(?+)")) != string::npos;) folded.erase(pos + 4, 5);
+    return folded;
+}
+
+/**
+ * @struct QueryProfileOptions
+ * Mode profiling untuk executeQuery/executeQueryFromFile. Statement yang lebih
+ * lambat dari slowMs ditulis ke slowLogPath beserta rencananya: EXPLAIN ANALYZE
+ * untuk statement baca (menjalankan ulang query!) bila 'analyze', selain itu
+ * EXPLAIN FORMAT=JSON yang tidak mengeksekusi apa pun.
+ */
+struct QueryProfileOptions {
+    bool enabled = false;
+    double slowMs = 1000;
+    string slowLogPath = "slow_queries.log";
+    bool analyze = true;
+};
+
+/**
+ * @struct StatementProfile
+ * Titik awal satu statement yang diprofil; elapsedMs diisi setelah eksekusi
+ * (sebelum hasil dicetak) agar waktu tampilan tidak ikut terhitung.
+ */
+struct StatementProfile {
+    bool active = false;
+    chrono::steady_clock::time_point start;
+    uint64_t handlerReadsBefore = 0;
+    double elapsedMs = 0;
+
+    void stop() { elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count(); }
+};
+
+/**
+ * @struct StatementStats
+ * Agregat per sidik jari. rowsExamined berasal dari selisih counter sesi
+ * Handler_read_* (perkiraan baris yang dibaca storage engine).
+ */
+struct StatementStats {
+    string fingerprint;
+    string example;
+    uint64_t calls = 0;
+    uint64_t slowCalls = 0;
+    double totalMs = 0;
+    double maxMs = 0;
+    uint64_t rowsExamined = 0;
+    uint64_t rowsReturned = 0;
+};
+
+/**
+ * @class QueryProfiler
+ * Mengumpulkan StatementStats per sidik jari. Thread-safe.
+ */
+class QueryProfiler {
+public:
+    QueryProfiler()
+        : statementMs(metrics().histogram("dbm_statement_ms", "Durasi statement SQL bebas saat profiling (ms)",
+                                          {1, 5, 10, 50, 100, 500, 1000, 5000, 30000})),
+          slowTotal(metrics().counter("dbm_slow_queries_total", "Statement yang melewati ambang slow query")) {}
+
+    void record(const string& sql, double elapsedMs, uint64_t rowsExamined, uint64_t rowsReturned, bool slow) {
+        statementMs.observe(elapsedMs);
+        if (slow) slowTotal.add();
+        string fp = fingerprintSQL(sql);
+        lock_guard<mutex> lock(m);
+        StatementStats& s = stats[fp];
+        if (s.calls == 0) {
+            s.fingerprint = fp;
+            s.example = sql;
+        }
+        s.calls++;
+        if (slow) s.slowCalls++;
+        s.totalMs += elapsedMs;
+        s.maxMs = max(s.maxMs, elapsedMs);
+        s.rowsExamined += rowsExamined;
+        s.rowsReturned += rowsReturned;
+    }
+
+    /** @brief Agregat diurutkan menurut total waktu (paling mahal dulu). */
+    vector<StatementStats> ranked() {
+        vector<StatementStats> out;
+        {
+            lock_guard<mutex> lock(m);
+            for (const auto& [fp, s] : stats) out.push_back(s);
+        }
+        sort(out.begin(), out.end(), [](const StatementStats& a, const StatementStats& b) { return a.totalMs > b.totalMs; });
+        return out;
+    }
+
+    void reset() {
+        lock_guard<mutex> lock(m);
+        stats.clear();
+    }
+
+private:
+    mutex m;
+    unordered_map<string, StatementStats> stats;
+    MetricHistogram& statementMs;
+    MetricCounter& slowTotal;
+};
+
+/** @brief Kata kunci pertama statement dalam huruf besar (kurung pembuka dilewati). */
+static string firstKeyword(const string& sql) {
+    size_t i = 0;
+    while (i < sql.size() && (isspace(static_cast<unsigned char>(sql[i])) || sql[i] == '(')) i++;
+    string word;
+    while (i < sql.size() && isalpha(static_cast<unsigned char>(sql[i]))) word += static_cast<char>(toupper(static_cast<unsigned char>(sql[i++])));
+    return word;
+}
+
+/**
+ * @brief True jika SQL bebas jelas hanya membaca (SELECT/SHOW/DESCRIBE/EXPLAIN).
+ * Selain itu tabel yang ditulis tidak diketahui, jadi cache hasil dikosongkan.
+ */
+static bool isReadOnlyStatement(const string& sql) {
+    string word = firstKeyword(sql);
+    return word == "SELECT" || word == "SHOW" || word == "DESCRIBE" || word == "DESC" || word == "EXPLAIN";
+}
+
+/**
+ * @brief Memeriksa identifier SQL (nama DB/tabel/kolom) tanpa mencetak apa pun:
+ * 1-64 karakter [a-zA-Z0-9_], tidak diawali angka. Setara dengan
+ * ^[a-zA-Z_][a-zA-Z0-9_]*$ tetapi tanpa biaya regex, untuk jalur panas.
+ */
+static bool isSafeIdentifier(const string& name) {
+    if (name.empty() || name.length() > 64) return false;
+    if (name[0] >= '0' && name[0] <= '9') return false;
+    for (char c : name) {
+        bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        if (!ok) return false;
+    }
+    return true;
+}
+
+// --- CAPTURE WORKLOAD ---
+
+/**
+ * Format file capture (teks per baris, dipisah tab; .gz/.zst dikompresi seperti ekspor):
+ *   #dbm-capture  1  <waktu mulai>
+ *   S  <id>  <sql>                                  teks SQL unik, ditulis sekali
+ *   Q  <offset_us>  <sesi>  <durasi_us>  <ok>  <id>  [parameter...]
+ * offset_us relatif terhadap awal capture; satu sesi = satu DatabaseManager
+ * (satu koneksi). Nilai di-escape gaya LOAD DATA: \\ \t \n \r, NULL = \N.
+ */
+static void appendCaptureField(string& out, string_view value) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: out += c;
+        }
+    }
+}
+
+static void appendCaptureField(string& out, const optional<string>& value) {
+    if (value) appendCaptureField(out, string_view(*value));
+    else out += "\\N";
+}
+
+/** @brief Kebalikan appendCaptureField: memecah satu baris capture menjadi field. */
+static void splitCaptureLine(string_view line, vector<optional<string>>& fields) {
+    fields.clear();
+    string field;
+    bool escaped = false;
+    auto finish = [&]() {
+        if (field == "\\N" && !escaped) fields.emplace_back(nullopt);
+        else fields.emplace_back(std::move(field));
+        field.clear();
+        escaped = false;
+    };
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (c == '\t') {
+            finish();
+        } else if (c == '\\' && i + 1 < line.size() && line[i + 1] != 'N') {
+            char e = line[++i];
+            field += e == 't' ? '\t' : e == 'n' ? '\n' : e == 'r' ? '\r' : e;
+            escaped = true;
+        } else {
+            field += c;
+        }
+    }
+    finish();
+}
+
+/** @brief Nilai parameter bind dalam bentuk teks untuk capture (angka lewat to_chars). */
+static optional<string> captureValue(const string& v) { return v; }
+static optional<string> captureValue(const optional<string>& v) { return v; }
+
+static optional<string> captureValue(double v) {
+    string out;
+    appendNumber(out, v);
+    return out;
+}
+
+static optional<string> captureValue(int64_t v) {
+    string out;
+    appendNumber(out, v);
+    return out;
+}
+
+template <typename T>
+static optional<string> captureValue(const optional<T>& v) {
+    return v ? captureValue(*v) : nullopt;
+}
+
+/** @brief Parameter satu record dengan urutan yang sama seperti bindRecord. */
+template <typename Record>
+static void captureRecord(vector<optional<string>>& out, const Record& rec) {
+    forEachColumn<Record>([&](const auto& column) { out.push_back(captureValue(rec.*(column.member))); });
+}
+
+static void captureRecord(vector<optional<string>>& out, const vector<optional<string>>& row) {
+    out.insert(out.end(), row.begin(), row.end());
+}
+
+/**
+ * @class WorkloadRecorder
+ * Merekam statement yang dieksekusi DatabaseManager (waktu, sesi, durasi,
+ * parameter) ke file capture untuk diputar ulang dengan replayWorkload.
+ * Satu perekam per proses; saat tidak aktif biaya per statement hanya satu
+ * load atomik dan tidak ada alokasi.
+ */
+class WorkloadRecorder {
+public:
+    WorkloadRecorder()
+        : statementsTotal(metrics().counter("dbm_capture_statements_total", "Statement yang direkam ke file capture workload")) {}
+
+    bool active() const { return on.load(memory_order_relaxed); }
+
+    /** @brief Id sesi baru; dipanggil sekali per DatabaseManager. */
+    uint32_t newSession() { return nextSession.fetch_add(1, memory_order_relaxed); }
+
+    bool start(const string& path) {
+        lock_guard<mutex> lock(m);
+        if (out) {
+            cerr << "Capture sudah berjalan ke " << file << "." << endl;
+            return false;
+        }
+        auto stream = make_unique<CompressedOFStream>(path);
+        if (!stream->is_open() || stream->fail()) {
+            cerr << "Gagal membuka file capture: " << path << endl;
+            return false;
+        }
+        *stream << "#dbm-capture\t1\t" << currentTimestampMicros() << "\n";
+        out = std::move(stream);
+        file = path;
+        sqlIds.clear();
+        statements = 0;
+        epoch = chrono::steady_clock::now();
+        on.store(true, memory_order_release);
+        return true;
+    }
+
+    /** @brief Menghentikan capture dan menutup file. False jika tidak aktif atau gagal menulis. */
+    bool stop() {
+        on.store(false, memory_order_release);
+        lock_guard<mutex> lock(m);
+        if (!out) return false;
+        bool ok = out->close();
+        out.reset();
+        if (!ok) {
+            cerr << "Gagal menulis file capture: " << file << endl;
+            return false;
+        }
+        cout << statements << " statement (" << sqlIds.size() << " teks SQL unik) direkam ke " << file << "." << endl;
+        return true;
+    }
+
+    void record(uint32_t session, const string& sql, chrono::steady_clock::time_point start,
+                chrono::steady_clock::time_point end, bool ok, const vector<optional<string>>& params) {
+        lock_guard<mutex> lock(m);
+        if (!out) return;
+        line.clear();
+        auto it = sqlIds.find(sql);
+        if (it == sqlIds.end()) {
+            it = sqlIds.emplace(sql, static_cast<uint32_t>(sqlIds.size())).first;
+            line += "S\t" + to_string(it->second) + "\t";
+            appendCaptureField(line, string_view(sql));
+            line += '\n';
+        }
+        auto us = [](chrono::steady_clock::duration d) { return max<int64_t>(0, chrono::duration_cast<chrono::microseconds>(d).count()); };
+        line += "Q\t" + to_string(us(start - epoch)) + "\t" + to_string(session) + "\t" + to_string(us(end - start)) +
+                (ok ? "\t1\t" : "\t0\t") + to_string(it->second);
+        for (const optional<string>& p : params) {
+            line += '\t';
+            appendCaptureField(line, p);
+        }
+        line += '\n';
+        *out << line;
+        statements++;
+        statementsTotal.add();
+    }
+
+private:
+    atomic<bool> on{false};
+    atomic<uint32_t> nextSession{1};
+    mutex m;
+    unique_ptr<CompressedOFStream> out;
+    string file;
+    unordered_map<string, uint32_t> sqlIds;
+    uint64_t statements = 0;
+    string line; // Buffer baris, dipakai ulang di bawah 'm'
+    chrono::steady_clock::time_point epoch;
+    MetricCounter& statementsTotal;
+};
+
+/**
+ * @brief Perekam workload global proses.
+ */
+static WorkloadRecorder& workloadRecorder() {
+    static WorkloadRecorder instance;
+    return instance;
+}
+
+/**
+ * @class CaptureZone
+ * Satu statement untuk capture workload, dibuat tepat sebelum bind parameter
+ * dan eksekusi (durasi yang direkam = bind + eksekusi, sama seperti replay).
+ * Dicatat saat done() (berhasil) atau saat destruksi tanpa done() (gagal,
+ * mis. exception). Parameter hanya perlu diisi bila recording().
+ */
+class CaptureZone {
+public:
+    CaptureZone(uint32_t session, const string& sql) : session(session), sql(sql), open(workloadRecorder().active()) {
+        if (open) start = chrono::steady_clock::now();
+    }
+    ~CaptureZone() { finish(false); }
+
+    CaptureZone(const CaptureZone&) = delete;
+    CaptureZone& operator=(const CaptureZone&) = delete;
+
+    bool recording() const { return open; }
+    vector<optional<string>>& params() { return values; }
+
+    /** @brief Menandai eksekusi selesai; durasi dihitung sampai titik ini. */
+    void done() { finish(true); }
+
+private:
+    uint32_t session;
+    const string& sql;
+    bool open;
+    chrono::steady_clock::time_point start;
+    vector<optional<string>> values;
+
+    void finish(bool ok) {
+        if (!open) return;
+        open = false;
+        workloadRecorder().record(session, sql, start, chrono::steady_clock::now(), ok, values);
+    }
+};
+
+/**
+ * @class CaptureSession
+ * Merekam workload selama masa hidup objek ini. Dipakai main() untuk
+ * DBM_CAPTURE=<file>; path kosong/null = tidak aktif.
+ */
+class CaptureSession {
+public:
+    explicit CaptureSession(const char* path) : active(path && *path && workloadRecorder().start(path)) {}
+
+    ~CaptureSession() {
+        if (active) workloadRecorder().stop();
+    }
+
+private:
+    bool active;
+};
+
+/**
+ * @class DatabaseManager
+ * Mengelola semua koneksi dan operasi ke database MySQL.
+ * Ditingkatkan dengan validasi identifier untuk keamanan
+ * dan operasi data interaktif yang aman.
+ */
+class DatabaseManager {
+private:
+    sql::mysql::MySQL_Driver* driver;
+    unique_ptr<sql::Connection> conn;
+    ConnectionInfo connInfo;
+    string currentDB;
+    TracedMutex dbMutex{"lock_wait.dbMutex"};
+    mutex logMutex;
+    ofstream logFile;
+    ResultCache resultCache;
+    IndexAdvisor indexAdvisor;
+    QueryProfiler profiler;
+    QueryProfileOptions profileOptions;
+    int64_t statusOverhead = -1; // Kenaikan Handler_read_* akibat SHOW STATUS sendiri (-1 = belum diukur)
+    const uint32_t captureSession = workloadRecorder().newSession(); // Sesi koneksi ini di file capture workload
+
+    /**
+     * @brief Menulis pesan log ke file dengan timestamp. Thread-safe.
+     */
+    void writeLog(const string& msg) {
+        lock_guard<mutex> logLock(logMutex);
+        if (!logFile.is_open()) return;
+        logFile << "[" << formatLogTimestamp(chrono::system_clock::now()) << "] " << msg << endl;
+    }
+
+    /**
+     * @brief Membuang entri cache hasil milik tabel di database aktif.
+     * Dipanggil oleh setiap jalur tulis, sebaiknya selagi dbMutex dipegang.
+     */
+    void invalidateCachedTable(const string& tableName) {
+        resultCache.invalidate(ResultCache::scopeOf(currentDB, tableName));
+    }
+
+    /**
+     * @brief [BARU] Memvalidasi string untuk keamanan identifier SQL.
+     * Mencegah SQL injection pada nama tabel/database.
+     */
+    bool isValidIdentifier(const string& name) {
+        if (name.empty() || name.length() > 64) {
+            cerr << "Error: Nama identifier tidak boleh kosong atau lebih dari 64 karakter." << endl;
+            return false;
+        }
+        // Hanya izinkan alfanumerik dan underscore. Tidak boleh dimulai dengan angka.
+        // Ini adalah perlindungan kritis terhadap SQL injection pada identifier.
+        if (!isSafeIdentifier(name)) {
+            cerr << "Error: Nama '" << name << "' mengandung karakter tidak valid. Hanya [a-zA-Z0-9_] yang diizinkan dan harus diawali dengan huruf atau _." << endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Mendapatkan daftar kolom dan tipenya untuk sebuah tabel.
+     * Digunakan oleh fungsi interaktif (insert, update, select).
+     */
+    map<string, string> getTableColumns(const string& tableName) {
+        // Asumsi: tableName sudah divalidasi oleh pemanggil
+        // Asumsi: dbMutex sudah di-lock oleh pemanggil
+        map<string, string> columns;
+        try {
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            unique_ptr<sql::ResultSet> res(stmt->executeQuery("DESCRIBE `" + tableName + "`"));
+            while (res->next()) {
+                columns[res->getString("Field")] = res->getString("Type");
+            }
+        } catch (sql::SQLException& e) {
+            writeLog("Error getTableColumns: " + string(e.what()));
+            // Biarkan map kosong, pemanggil akan menanganinya
+        }
+        return columns;
+    }
+
+
+    /**
+     * @brief Kolom PRIMARY KEY tabel sesuai urutan indeks (kosong jika tidak ada).
+     * Asumsi: tableName sudah divalidasi dan dbMutex sudah di-lock oleh pemanggil.
+     */
+    vector<string> getPrimaryKeyUnlocked(const string& tableName) {
+        vector<pair<int, string>> parts;
+        try {
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            unique_ptr<sql::ResultSet> res(stmt->executeQuery("SHOW KEYS FROM `" + tableName + "` WHERE Key_name = 'PRIMARY'"));
+            while (res->next()) {
+                parts.emplace_back(res->getInt("Seq_in_index"), res->getString("Column_name"));
+            }
+        } catch (sql::SQLException& e) {
+            writeLog("Error getPrimaryKey: " + string(e.what()));
+        }
+        sort(parts.begin(), parts.end());
+        vector<string> columns;
+        for (auto& p : parts) columns.push_back(p.second);
+        return columns;
+    }
+
+    /**
+     * @brief Membaca daftar partisi tabel dari information_schema. 'parts' kosong
+     * jika tabel tidak dipartisi. Asumsi: dbMutex sudah di-lock oleh pemanggil.
+     */
+    bool loadPartitionsUnlocked(const string& tableName, vector<PartitionInfo>& parts, string& method, string& expression) {
+        parts.clear();
+        method.clear();
+        expression.clear();
+        try {
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+                "SELECT PARTITION_NAME, PARTITION_METHOD, PARTITION_EXPRESSION, PARTITION_DESCRIPTION,"
+                " TABLE_ROWS, DATA_LENGTH + INDEX_LENGTH AS BYTES"
+                " FROM information_schema.PARTITIONS WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ?"
+                " ORDER BY PARTITION_ORDINAL_POSITION"));
+            pstmt->setString(1, currentDB);
+            pstmt->setString(2, tableName);
+            unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+            while (res->next()) {
+                if (res->isNull("PARTITION_NAME")) continue; // Tabel tanpa partisi: satu baris NULL
+                PartitionInfo p;
+                p.name = res->getString("PARTITION_NAME");
+                string bound = res->getString("PARTITION_DESCRIPTION");
+                bound.erase(remove(bound.begin(), bound.end(), '\''), bound.end());
+                p.bound = bound == "MAXVALUE" ? "" : bound;
+                p.rows = res->getUInt64("TABLE_ROWS");
+                p.bytes = res->getUInt64("BYTES");
+                method = res->getString("PARTITION_METHOD");
+                expression = res->getString("PARTITION_EXPRESSION");
+                expression.erase(remove(expression.begin(), expression.end(), '`'), expression.end());
+                parts.push_back(p);
+            }
+            return true;
+        } catch (sql::SQLException& e) {
+            writeLog(string("Error membaca partisi: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Men-drop partisi RANGE COLUMNS(timeColumn) yang seluruh isinya < cutoff
+     * (batas atas <= cutoff). Partisi terakhir tidak pernah di-drop.
+     * Mengembalikan jumlah partisi yang di-drop, atau -1 jika gagal.
+     * Asumsi: dbMutex sudah di-lock oleh pemanggil.
+     */
+    int dropExpiredPartitionsUnlocked(const string& tableName, const string& timeColumn, const string& cutoff) {
+        vector<PartitionInfo> parts;
+        string method, expression;
+        if (!loadPartitionsUnlocked(tableName, parts, method, expression)) return -1;
+        if (parts.empty() || method != "RANGE COLUMNS" || expression != timeColumn) return 0;
+
+        vector<string> expired;
+        uint64_t rows = 0;
+        for (const PartitionInfo& p : parts) {
+            if (p.bound.empty() || !isSafeIdentifier(p.name)) continue;
+            string bound = p.bound.size() == 10 ? p.bound + " 00:00:00" : p.bound;
+            if (bound <= cutoff) {
+                expired.push_back(p.name);
+                rows += p.rows;
+            }
+        }
+        if (expired.size() == parts.size()) expired.pop_back(); // Tabel harus tetap punya minimal satu partisi
+        if (expired.empty()) return 0;
+
+        string sql = "ALTER TABLE `" + tableName + "` DROP PARTITION ";
+        for (size_t i = 0; i < expired.size(); ++i) sql += (i ? ", `" : "`") + expired[i] + "`";
+        try {
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            stmt->execute(sql);
+            invalidateCachedTable(tableName);
+        } catch (sql::SQLException& e) {
+            cerr << "Error drop partisi: " << e.what() << endl;
+            writeLog(string("Error drop partisi (") + tableName + "): " + e.what());
+            return -1;
+        }
+        cout << expired.size() << " partisi kedaluwarsa di-drop dari '" << tableName << "' (~" << rows << " baris)." << endl;
+        writeLog("Drop " + to_string(expired.size()) + " partisi kedaluwarsa " + tableName + " < " + cutoff);
+        return static_cast<int>(expired.size());
+    }
+
+    /** @brief Tanggal hari ini menurut server (CURDATE()). Asumsi: dbMutex sudah di-lock. */
+    bool serverTodayUnlocked(CivilDate& today) {
+        unique_ptr<sql::Statement> stmt(conn->createStatement());
+        unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT DATE_FORMAT(CURDATE(), '%Y-%m-%d')"));
+        return res->next() && parseCivilDate(res->getString(1), today);
+    }
+
+    /**
+     * @brief Membuat registri rollup jika belum ada. Pemanggil harus memegang dbMutex.
+     */
+    void ensureRollupRegistryUnlocked() {
+        unique_ptr<sql::Statement> stmt(conn->createStatement());
+        stmt->execute(
+            "CREATE TABLE IF NOT EXISTS `_dbm_rollups` ("
+            " `source_table` VARCHAR(64) NOT NULL,"
+            " `time_column` VARCHAR(64) NOT NULL,"
+            " `id_column` VARCHAR(64) NOT NULL,"
+            " `group_columns` VARCHAR(1024) NOT NULL,"
+            " `measures` VARCHAR(1024) NOT NULL,"
+            " `last_id` BIGINT UNSIGNED NOT NULL DEFAULT 0,"
+            " `rows_folded` BIGINT UNSIGNED NOT NULL DEFAULT 0,"
+            " `updated_at` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,"
+            " PRIMARY KEY (`source_table`))");
+    }
+
+    /**
+     * @brief Membaca definisi rollup terdaftar (semua, atau hanya untuk sourceTable).
+     * Registri yang belum ada dianggap kosong. Pemanggil harus memegang dbMutex.
+     */
+    vector<RollupSpec> loadRollupsUnlocked(const string& sourceTable) {
+        vector<RollupSpec> specs;
+        {
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+                "SELECT COUNT(*) FROM information_schema.TABLES WHERE TABLE_SCHEMA = ? AND TABLE_NAME = '_dbm_rollups'"));
+            pstmt->setString(1, currentDB);
+            unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+            if (!res->next() || res->getInt(1) == 0) return specs;
+        }
+        string sql = "SELECT `source_table`, `time_column`, `id_column`, `group_columns`, `measures` FROM `_dbm_rollups`";
+        if (!sourceTable.empty()) sql += " WHERE `source_table` = ?";
+        unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(sql));
+        if (!sourceTable.empty()) pstmt->setString(1, sourceTable);
+        unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+        while (res->next()) {
+            RollupSpec spec;
+            spec.sourceTable = res->getString(1);
+            spec.timeColumn = res->getString(2);
+            spec.idColumn = res->getString(3);
+            spec.groupColumns = splitList(res->getString(4));
+            spec.measures = splitList(res->getString(5));
+            specs.push_back(spec);
+        }
+        return specs;
+    }
+
+    /**
+     * @brief INSERT ... SELECT yang melipat baris sumber dengan id dalam (?, ?]
+     * ke tabel rollup satu granularitas. Bucket yang sudah ada digabung:
+     * count/sum dijumlahkan, min/max dibandingkan (NULL = belum ada nilai).
+     */
+    static string rollupFoldSQL(const RollupSpec& spec, const string& granularity) {
+        string groups, cols = "`bucket`", select = string("DATE_FORMAT(`") + spec.timeColumn + "`, '" + rollupBucketFormat(granularity) + "')";
+        for (const string& g : spec.groupColumns) {
+            groups += ", `" + g + "`";
+        }
+        cols += groups + ", `row_count`";
+        select += groups + ", COUNT(*)";
+        string update = "`row_count` = `row_count` + VALUES(`row_count`)";
+        for (const string& m : spec.measures) {
+            const string c = "`" + m + "_count`", s = "`" + m + "_sum`", lo = "`" + m + "_min`", hi = "`" + m + "_max`";
+            cols += ", " + c + ", " + s + ", " + lo + ", " + hi;
+            select += ", COUNT(`" + m + "`), COALESCE(SUM(`" + m + "`), 0), MIN(`" + m + "`), MAX(`" + m + "`)";
+            update += ", " + c + " = " + c + " + VALUES(" + c + ")"
+                      ", " + s + " = " + s + " + VALUES(" + s + ")"
+                      ", " + lo + " = COALESCE(LEAST(" + lo + ", VALUES(" + lo + ")), " + lo + ", VALUES(" + lo + "))"
+                      ", " + hi + " = COALESCE(GREATEST(" + hi + ", VALUES(" + hi + ")), " + hi + ", VALUES(" + hi + "))";
+        }
+        return "INSERT INTO `" + rollupTableName(spec.sourceTable, granularity) + "` (" + cols + ") SELECT " + select
+               + " FROM `" + spec.sourceTable + "` WHERE `" + spec.idColumn + "` > ? AND `" + spec.idColumn + "` <= ?"
+               + " AND `" + spec.timeColumn + "` IS NOT NULL GROUP BY 1" + groups
+               + " ON DUPLICATE KEY UPDATE " + update;
+    }
+
+    /**
+     * @brief Menanyakan pasangan kolom = nilai sampai 'selesai'. Tidak menyentuh
+     * koneksi, jadi dipanggil tanpa memegang dbMutex.
+     */
+    static void promptColumnValues(const map<string, string>& columns, const string& columnPrompt, const string& valuePrompt,
+                                   vector<string>& names, vector<string>& values) {
+        string colName;
+        while (true) {
+            cout << columnPrompt;
+            getline(cin, colName);
+            if (colName == "selesai" || colName.empty()) break;
+
+            if (columns.find(colName) == columns.end()) {
+                cout << "Kolom '" << colName << "' tidak ditemukan." << endl;
+                continue;
+            }
+
+            cout << valuePrompt << " '" << colName << "': ";
+            string val;
+            getline(cin, val);
+            names.push_back(colName);
+            values.push_back(val);
+        }
+    }
+
+    /**
+     * @brief Mengambil kolom tabel untuk prompt interaktif; lock hanya selama DESCRIBE.
+     */
+    bool columnsForPrompt(const string& tableName, map<string, string>& columns) {
+        lock_guard<TracedMutex> lock(dbMutex);
+        if (currentDB.empty()) {
+            cout << "Pilih database terlebih dahulu!" << endl;
+            return false;
+        }
+        columns = getTableColumns(tableName);
+        if (columns.empty()) {
+            cerr << "Gagal mendapatkan kolom untuk '" << tableName << "'." << endl;
+            return false;
+        }
+        cout << "Kolom yang tersedia: ";
+        for(auto const& [key, val] : columns) cout << key << " ";
+        cout << "\n";
+        return true;
+    }
+
+    static string whereEqualsClause(const vector<string>& whereColumns) {
+        string clause;
+        for (size_t i = 0; i < whereColumns.size(); ++i) {
+            clause += (i ? " AND `" : " WHERE `") + whereColumns[i] + "` = ?";
+        }
+        return clause;
+    }
+
+    /**
+     * @brief Pratinjau murah jumlah baris yang akan terkena UPDATE/DELETE:
+     * COUNT dibatasi DML_PREVIEW_LIMIT + 1 baris; jika melewati batas, perkiraan
+     * diambil dari EXPLAIN. Mengembalikan -1 jika pratinjau gagal.
+     */
+    int64_t previewAffectedRows(const string& tableName, const vector<string>& whereColumns, const vector<string>& whereValues) {
+        lock_guard<TracedMutex> lock(dbMutex);
+        const string from = " FROM `" + tableName + "`" + whereEqualsClause(whereColumns);
+        try {
+            int64_t count = 0;
+            {
+                unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+                    "SELECT COUNT(*) FROM (SELECT 1" + from + " LIMIT " + to_string(DML_PREVIEW_LIMIT + 1) + ") AS `preview`"));
+                for (size_t i = 0; i < whereValues.size(); ++i) pstmt->setString(i + 1, whereValues[i]);
+                unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+                if (res->next()) count = res->getInt64(1);
+            }
+            if (count <= (int64_t)DML_PREVIEW_LIMIT) {
+                cout << "Pratinjau: " << count << " baris cocok." << endl;
+                return count;
+            }
+            int64_t estimate = 0;
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement("EXPLAIN SELECT 1" + from));
+            for (size_t i = 0; i < whereValues.size(); ++i) pstmt->setString(i + 1, whereValues[i]);
+            unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+            while (res->next()) estimate = max(estimate, (int64_t)res->getInt64("rows"));
+            cout << "Pratinjau: lebih dari " << DML_PREVIEW_LIMIT << " baris cocok (perkiraan EXPLAIN ~" << estimate << ")." << endl;
+            return max(count, estimate);
+        } catch (sql::SQLException& e) {
+            cerr << "Error pratinjau: " << e.what() << endl;
+            writeLog(string("Error pratinjau DML: ") + e.what());
+            return -1;
+        }
+    }
+
+    /**
+     * @brief Mencatat latensi filter untuk index advisor. Pola baru di-EXPLAIN
+     * sekali; full table scan dilaporkan ke operator. Filter kosong diabaikan
+     * (scan penuh memang diminta). Asumsi: dbMutex sudah di-lock oleh pemanggil.
+     */
+    void recordFilterUnlocked(const string& tableName, const vector<string>& whereColumns,
+                              const vector<string>& whereValues, double elapsedMs) {
+        if (whereColumns.empty()) return;
+        if (!indexAdvisor.record(currentDB, tableName, whereColumns, elapsedMs)) return;
+        try {
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+                "EXPLAIN SELECT 1 FROM `" + tableName + "`" + whereEqualsClause(whereColumns)));
+            for (size_t i = 0; i < whereValues.size(); ++i) pstmt->setString(i + 1, whereValues[i]);
+            unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+            if (!res->next()) return;
+            string type = res->isNull("type") ? "" : string(res->getString("type"));
+            string key = res->isNull("key") ? "" : string(res->getString("key"));
+            uint64_t rows = res->isNull("rows") ? 0 : res->getUInt64("rows");
+            if (indexAdvisor.setPlan(currentDB, tableName, whereColumns, type, key, rows)) {
+                cout << "Catatan: filter (" << joinList(whereColumns, ", ") << ") pada '" << tableName
+                     << "' memakai full table scan (~" << rows << " baris). Lihat Index Advisor (menu 25)." << endl;
+                writeLog("Full scan: " + tableName + " WHERE " + joinList(whereColumns, ", ") + " (~" + to_string(rows) + " baris)");
+            }
+        } catch (sql::SQLException& e) {
+            writeLog(string("Error EXPLAIN index advisor: ") + e.what());
+        }
+    }
+
+    /**
+     * @brief Jumlah counter sesi Handler_read_* (baris yang dibaca storage engine).
+     * Asumsi: dbMutex sudah di-lock oleh pemanggil.
+     */
+    uint64_t handlerReadsUnlocked() {
+        uint64_t total = 0;
+        unique_ptr<sql::Statement> stmt(conn->createStatement());
+        unique_ptr<sql::ResultSet> res(stmt->executeQuery("SHOW SESSION STATUS LIKE 'Handler_read%'"));
+        while (res->next()) total += res->getUInt64(2);
+        return total;
+    }
+
+    /** @brief Memulai profil statement jika mode profiling aktif. Asumsi: dbMutex di-lock. */
+    StatementProfile beginProfileUnlocked() {
+        StatementProfile profile;
+        if (!profileOptions.enabled) return profile;
+        try {
+            if (statusOverhead < 0) {
+                // SHOW STATUS sendiri bisa menaikkan Handler_read_*; ukur sekali lalu kurangkan
+                uint64_t a = handlerReadsUnlocked();
+                statusOverhead = static_cast<int64_t>(handlerReadsUnlocked() - a);
+            }
+            profile.handlerReadsBefore = handlerReadsUnlocked();
+            profile.active = true;
+        } catch (sql::SQLException& e) {
+            writeLog(string("Error profiling (status sesi): ") + e.what());
+        }
+        profile.start = chrono::steady_clock::now();
+        return profile;
+    }
+
+    /**
+     * @brief Mencatat statement yang diprofil; statement lambat ditulis ke file
+     * slow query beserta rencananya. Asumsi: dbMutex sudah di-lock oleh pemanggil.
+     */
+    void endProfileUnlocked(StatementProfile& profile, const string& sql, uint64_t rowsReturned) {
+        if (!profile.active) return;
+        if (profile.elapsedMs == 0) profile.stop();
+        uint64_t examined = 0;
+        try {
+            int64_t delta = static_cast<int64_t>(handlerReadsUnlocked() - profile.handlerReadsBefore) - statusOverhead;
+            examined = static_cast<uint64_t>(max<int64_t>(0, delta));
+        } catch (sql::SQLException& e) {
+            writeLog(string("Error profiling (status sesi): ") + e.what());
+        }
+        bool slow = profile.elapsedMs >= profileOptions.slowMs;
+        profiler.record(sql, profile.elapsedMs, examined, rowsReturned, slow);
+        ostringstream oss;
+        oss << fixed << setprecision(1) << "[profil] " << profile.elapsedMs << " ms, " << examined << " baris dibaca, "
+            << rowsReturned << " baris hasil/terpengaruh" << (slow ? " (LAMBAT)" : "");
+        cout << oss.str() << endl;
+        if (slow) captureSlowQueryUnlocked(sql, profile.elapsedMs, examined, rowsReturned);
+    }
+
+    /**
+     * @brief Menambahkan satu entri ke file slow query. Statement baca diberi
+     * EXPLAIN ANALYZE (dijalankan ulang); DML dan server tanpa EXPLAIN ANALYZE
+     * memakai EXPLAIN FORMAT=JSON. Asumsi: dbMutex sudah di-lock oleh pemanggil.
+     */
+    void captureSlowQueryUnlocked(const string& sql, double elapsedMs, uint64_t examined, uint64_t returned) {
+        const string keyword = firstKeyword(sql);
+        const bool explainable = keyword == "SELECT" || keyword == "INSERT" || keyword == "UPDATE" ||
+                                 keyword == "DELETE" || keyword == "REPLACE";
+        string plan;
+        auto explain = [&](const string& prefix) {
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            unique_ptr<sql::ResultSet> res(stmt->executeQuery(prefix + sql));
+            string out;
+            while (res->next()) out += string(res->getString(1)) + "\n";
+            return out;
+        };
+        if (profileOptions.analyze && keyword == "SELECT") {
+            try {
+                plan = explain("EXPLAIN ANALYZE ");
+            } catch (sql::SQLException& e) {
+                writeLog(string("EXPLAIN ANALYZE tidak tersedia, memakai FORMAT=JSON: ") + e.what());
+            }
+        }
+        if (plan.empty() && explainable) {
+            try {
+                plan = explain("EXPLAIN FORMAT=JSON ");
+            } catch (sql::SQLException& e) {
+                plan = string("(rencana tidak tersedia: ") + e.what() + ")\n";
+            }
+        }
+
+        ofstream out(profileOptions.slowLogPath, ios::app);
+        if (!out.is_open()) {
+            cerr << "Gagal membuka file slow query: " << profileOptions.slowLogPath << endl;
+            return;
+        }
+        out << "# Time: " << currentTimestampMicros() << "\n"
+            << "# Schema: " << currentDB << "\n"
+            << "# Query_time_ms: " << fixed << setprecision(3) << elapsedMs << "  Rows_examined: " << examined
+            << "  Rows_returned: " << returned << "\n"
+            << "# Fingerprint: " << fingerprintSQL(sql) << "\n"
+            << sql << ";\n";
+        if (!plan.empty()) {
+            istringstream lines(plan);
+            string line;
+            while (getline(lines, line)) out << "# " << line << "\n";
+        }
+        out << "\n";
+        writeLog("Slow query (" + to_string(static_cast<int64_t>(elapsedMs)) + " ms) dicatat ke " + profileOptions.slowLogPath);
+    }
+
+    /**
+     * @brief Menjalankan satu statement dari file SQL (dengan profiling bila aktif).
+     * Hasil SELECT dihabiskan agar koneksi siap untuk statement berikutnya.
+     * Asumsi: dbMutex sudah di-lock oleh pemanggil.
+     */
+    void executeScriptStatementUnlocked(const string& sql) {
+        unique_ptr<sql::Statement> stmt(conn->createStatement());
+        if (!isReadOnlyStatement(sql)) resultCache.clear();
+        StatementProfile profile = beginProfileUnlocked();
+        uint64_t rows = 0;
+        CaptureZone capture(captureSession, sql);
+        bool hasResult = stmt->execute(sql);
+        capture.done();
+        if (hasResult) {
+            profile.stop();
+            unique_ptr<sql::ResultSet> res(stmt->getResultSet());
+            while (res && res->next()) rows++;
+        } else {
+            profile.stop();
+            rows = stmt->getUpdateCount();
+        }
+        endProfileUnlocked(profile, sql, rows);
+    }
+
+    /**
+     * @brief Konfirmasi setelah pratinjau. Tanpa WHERE, operator harus mengetik
+     * frasa 'phrase'; dengan WHERE cukup y/n. Tidak memegang dbMutex.
+     */
+    static bool confirmAffected(bool hasWhere, const string& phrase, const string& action) {
+        string confirm;
+        if (!hasWhere) {
+            cout << "PERINGATAN: " << action << " tanpa WHERE akan mengenai SEMUA baris!" << endl;
+            cout << "Ketik '" << phrase << "' untuk mengkonfirmasi: ";
+            getline(cin, confirm);
+            return confirm == phrase;
+        }
+        cout << "Lanjutkan " << action << "? (y/n): ";
+        getline(cin, confirm);
+        return confirm == "y" || confirm == "Y";
+    }
+
+    /**
+     * @brief Memeriksa apakah database ada (versi unlocked).
+     * Pemanggil harus memegang dbMutex.
+     */
+    bool databaseExistsUnlocked(const string& name) {
+        // Asumsi: 'name' sudah divalidasi oleh pemanggil jika input dari user
+        try {
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+                "SELECT SCHEMA_NAME FROM INFORMATION_SCHEMA.SCHEMATA WHERE SCHEMA_NAME = ?"
+            ));
+            pstmt->setString(1, name);
+            unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+            return res->next();
+        } catch (sql::SQLException& e) {
+            writeLog(string("Error checking database existence: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Memvalidasi header CSV terhadap kolom tabel dan menyusun INSERT berparameter.
+     * Dipakai bersama oleh importFromCSV dan followCSV.
+     */
+    bool buildCSVInsertQuery(const string& tableName, const vector<string>& columns, string& query) {
+        MergeOptions insertOnly;
+        return buildCSVInsertQuery(tableName, columns, query, insertOnly);
+    }
+
+    /**
+     * @brief Seperti di atas, untuk mode merge. Kolom PRIMARY/UNIQUE KEY tanpa kebijakan
+     * eksplisit diberi KeepExisting agar bentrok pada satu unique key tidak menimpa
+     * kunci lain (mis. id baris lama) dengan nilai dari file.
+     */
+    bool buildCSVInsertQuery(const string& tableName, const vector<string>& columns, string& query, MergeOptions& merge) {
+        // [Keamanan] Validasi kolom CSV terhadap kolom tabel
+        map<string, string> actualColumns;
+        {
+            lock_guard<TracedMutex> lock(dbMutex);
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+            actualColumns = getTableColumns(tableName);
+            if (actualColumns.empty()) {
+                cerr << "Gagal memverifikasi kolom tabel '" << tableName << "'." << endl;
+                return false;
+            }
+            if (merge.mode == MergeMode::Upsert || merge.mode == MergeMode::Staging) {
+                try {
+                    unique_ptr<sql::Statement> stmt(conn->createStatement());
+                    unique_ptr<sql::ResultSet> res(stmt->executeQuery("SHOW KEYS FROM `" + tableName + "` WHERE Non_unique = 0"));
+                    while (res->next()) {
+                        string key = res->getString("Column_name");
+                        if (find(columns.begin(), columns.end(), key) != columns.end()) merge.policies.emplace(key, MergePolicy::KeepExisting);
+                    }
+                } catch (sql::SQLException& e) {
+                    cerr << "Gagal membaca unique key '" << tableName << "': " << e.what() << endl;
+                    return false;
+                }
+            }
+        }
+
+        for (const string& csvCol : columns) {
+            if (!isValidIdentifier(csvCol)) { // Periksa juga header CSV
+                cerr << "Error: Header CSV '" << csvCol << "' mengandung karakter tidak valid." << endl;
+                return false;
+            }
+            if (actualColumns.find(csvCol) == actualColumns.end()) {
+                cerr << "Error: Kolom '" << csvCol << "' dari CSV tidak ditemukan di tabel '" << tableName << "'. Impor dibatalkan." << endl;
+                return false;
+            }
+        }
+        // Aman untuk melanjutkan, semua kolom CSV ada di tabel
+        string unknown = unknownMergeColumn(columns, merge);
+        if (!unknown.empty()) {
+            cerr << "Error: Kebijakan merge untuk kolom '" << unknown << "' yang tidak ada di header CSV." << endl;
+            return false;
+        }
+
+        query = multiRowInsertSQL(tableName, columns, 1, merge);
+        return true;
+    }
+
+    /**
+     * @brief Membuat tabel checkpoint impor jika belum ada. Pemanggil harus memegang dbMutex.
+     */
+    void ensureCheckpointTableUnlocked() {
+        unique_ptr<sql::Statement> stmt(conn->createStatement());
+        stmt->execute(
+            "CREATE TABLE IF NOT EXISTS `_dbm_import_checkpoints` ("
+            " `table_name` VARCHAR(64) NOT NULL,"
+            " `file_key` VARCHAR(255) NOT NULL,"
+            " `file_size` BIGINT UNSIGNED NOT NULL,"
+            " `head_hash` BIGINT UNSIGNED NOT NULL,"
+            " `byte_offset` BIGINT NOT NULL,"
+            " `line_number` BIGINT UNSIGNED NOT NULL,"
+            " `rows_committed` BIGINT UNSIGNED NOT NULL,"
+            " `completed` TINYINT NOT NULL DEFAULT 0,"
+            " `updated_at` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,"
+            " PRIMARY KEY (`table_name`, `file_key`))");
+    }
+
+    /**
+     * @brief Membaca checkpoint (table, file) yang identitas filenya sama. Pemanggil harus memegang dbMutex.
+     * @return true jika checkpoint yang cocok ditemukan (posisi disalin ke 'cp').
+     */
+    bool loadCheckpointUnlocked(const string& tableName, ImportCheckpoint& cp) {
+        unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+            "SELECT `file_size`, `head_hash`, `byte_offset`, `line_number`, `rows_committed`, `completed` "
+            "FROM `_dbm_import_checkpoints` WHERE `table_name` = ? AND `file_key` = ?"));
+        pstmt->setString(1, tableName);
+        pstmt->setString(2, cp.fileKey);
+        unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+        if (!res->next()) return false;
+        if (res->getUInt64(1) != cp.fileSize || res->getUInt64(2) != cp.headHash) return false; // file berubah
+        cp.byteOffset = res->getInt64(3);
+        cp.lineNumber = res->getUInt64(4);
+        cp.rowsCommitted = res->getUInt64(5);
+        cp.completed = res->getInt(6) != 0;
+        return true;
+    }
+
+    void saveCheckpointUnlocked(const string& tableName, const ImportCheckpoint& cp) {
+        unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+            "INSERT INTO `_dbm_import_checkpoints` "
+            "(`table_name`, `file_key`, `file_size`, `head_hash`, `byte_offset`, `line_number`, `rows_committed`, `completed`) "
+            "VALUES (?, ?, ?, ?, ?, ?, ?, ?) ON DUPLICATE KEY UPDATE "
+            "`file_size` = VALUES(`file_size`), `head_hash` = VALUES(`head_hash`), `byte_offset` = VALUES(`byte_offset`), "
+            "`line_number` = VALUES(`line_number`), `rows_committed` = VALUES(`rows_committed`), `completed` = VALUES(`completed`)"));
+        pstmt->setString(1, tableName);
+        pstmt->setString(2, cp.fileKey);
+        pstmt->setUInt64(3, cp.fileSize);
+        pstmt->setUInt64(4, cp.headHash);
+        pstmt->setInt64(5, cp.byteOffset);
+        pstmt->setUInt64(6, cp.lineNumber);
+        pstmt->setUInt64(7, cp.rowsCommitted);
+        pstmt->setInt(8, cp.completed ? 1 : 0);
+        pstmt->executeUpdate();
+    }
+
+    /**
+     * @brief Mengambil hingga 'maxRows' baris berikutnya dari 'res' ke 'batch' (dikosongkan
+     * lebih dulu; kapasitasnya dipakai ulang). NULL disimpan sebagai 'nullText'.
+     * @return Jumlah baris yang diambil; 0 berarti result set sudah habis.
+     */
+    static size_t fetchRowBatch(sql::ResultSet* res, RowBatch& batch, size_t maxRows, string_view nullText) {
+        batch.clear();
+        const unsigned int cols = static_cast<unsigned int>(batch.columns());
+        while (batch.size() < maxRows && res->next()) {
+            for (unsigned int i = 1; i <= cols; ++i) {
+                if (res->isNull(i)) {
+                    batch.addField(nullText);
+                } else {
+                    sql::SQLString value = res->getString(i);
+                    batch.addField(string_view(value.c_str(), value.length()));
+                }
+            }
+            batch.finishRow();
+        }
+        return batch.size();
+    }
+
+    static void bindCSVValue(sql::PreparedStatement* pstmt, unsigned int idx, string_view value) {
+        if (value.empty() || value == "NULL") {
+            pstmt->setNull(idx, sql::DataType::VARCHAR);
+        } else {
+            pstmt->setString(idx, sql::SQLString(value.data(), value.size()));
+        }
+    }
+
+    /**
+     * @brief Bind satu baris CSV mulai placeholder 'idx'. Untuk tabel record bertipe
+     * (CSVRecordKind) baris di-decode dan angka di-bind sebagai DOUBLE/BIGINT; baris
+     * yang tidak bisa di-decode tetap dikirim sebagai teks agar error dilaporkan server.
+     */
+    static void bindCSVRow(sql::PreparedStatement* pstmt, unsigned int& idx, const RowBatch& rows, size_t r, CSVRecordKind kind) {
+        if (kind == CSVRecordKind::Sensor && bindCSVRecord<SensorReading>(pstmt, idx, rows, r)) return;
+        if (kind == CSVRecordKind::Usage && bindCSVRecord<AppUsage>(pstmt, idx, rows, r)) return;
+        for (size_t c = 0; c < rows.columns(); ++c) bindCSVValue(pstmt, idx++, rows.field(r, c));
+    }
+
+    /**
+     * @brief Memasukkan baris [start, start+n) satu per satu dengan 'pstmt' (satu baris).
+     * Error per baris (mis. duplikat) hanya me-rollback statement tersebut dan dicatat;
+     * 1213 deadlock dan 2006/2013 koneksi hilang dilempar ulang karena transaksi sudah batal.
+     * Asumsi: dbMutex sudah di-lock oleh pemanggil.
+     */
+    uint64_t insertCSVRowsOneByOneUnlocked(sql::PreparedStatement* pstmt, const RowBatch& rows, size_t start, size_t n,
+                                           CSVRecordKind kind = CSVRecordKind::None) {
+        uint64_t inserted = 0;
+        for (size_t r = start; r < start + n; ++r) {
+            try {
+                unsigned int idx = 1;
+                bindCSVRow(pstmt, idx, rows, r, kind);
+                pstmt->executeUpdate();
+                inserted++;
+            } catch (sql::SQLException& e) {
+                int code = e.getErrorCode();
+                if (code == 1213 || code == 2006 || code == 2013) throw;
+                cout << "Error pada baris " << rows.lineNumber(r) << ": " << e.what() << endl;
+                writeLog("Error impor CSV baris " + to_string(rows.lineNumber(r)) + ": " + e.what());
+            }
+        }
+        return inserted;
+    }
+
+    /**
+     * @brief Memasukkan baris CSV dengan INSERT multi-baris (mode merge tidak gagal pada
+     * duplikat, jadi satu statement per potongan aman). Potongan yang gagal karena
+     * data (mis. tipe tidak cocok) diulang per baris dengan 'single' agar error tetap
+     * dilaporkan per baris. Asumsi: dbMutex sudah di-lock oleh pemanggil.
+     */
+    uint64_t insertCSVRowsBulkUnlocked(const string& table, const vector<string>& columns, const MergeOptions& merge,
+                                       sql::PreparedStatement* single, const RowBatch& rows,
+                                       CSVRecordKind kind = CSVRecordKind::None) {
+        const size_t chunk = max<size_t>(1, min(MULTI_INSERT_MAX_ROWS, MULTI_INSERT_MAX_PARAMS / columns.size()));
+        uint64_t inserted = 0;
+        for (size_t start = 0; start < rows.size(); start += chunk) {
+            size_t n = min(chunk, rows.size() - start);
+            try {
+                unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(multiRowInsertSQL(table, columns, n, merge)));
+                unsigned int idx = 1;
+                for (size_t r = start; r < start + n; ++r) bindCSVRow(pstmt.get(), idx, rows, r, kind);
+                pstmt->executeUpdate();
+                inserted += n;
+            } catch (sql::SQLException& e) {
+                int code = e.getErrorCode();
+                if (code == 1213 || code == 2006 || code == 2013) throw;
+                inserted += insertCSVRowsOneByOneUnlocked(single, rows, start, n, kind);
+            }
+        }
+        return inserted;
+    }
+
+    /**
+     * @brief Laporan tahap dedupe. Waktu yang dihemat diperkirakan dari rata-rata
+     * waktu kirim per baris yang benar-benar dikirim dikali jumlah duplikat.
+     */
+    void reportDedupe(const RowDeduper& deduper, double sendSeconds, uint64_t rowsSent, const string& tableName) {
+        static MetricCounter& droppedTotal = metrics().counter("dbm_import_duplicates_dropped_total", "Baris duplikat yang dibuang sebelum dikirim");
+        uint64_t dup = deduper.duplicateRows();
+        droppedTotal.add(dup);
+        double perRow = rowsSent > 0 ? sendSeconds / rowsSent : 0.0;
+        ostringstream oss;
+        oss << fixed << setprecision(2);
+        oss << "Dedupe: " << dup << " dari " << deduper.checkedRows() << " baris duplikat dibuang ("
+            << (deduper.checkedRows() ? 100.0 * dup / deduper.checkedRows() : 0.0) << "%, " << formatBytes(deduper.droppedBytes())
+            << "), perkiraan waktu kirim dihemat " << dup * perRow << " s; memori " << formatBytes(deduper.memoryBytes())
+            << (deduper.usingBloom() ? " (Bloom filter)" : " (hash set eksak)");
+        if (deduper.usingBloom()) oss << ", perkiraan false positive " << setprecision(4) << deduper.falsePositiveRate() * 100 << "%";
+        cout << oss.str() << endl;
+        writeLog("Dedupe impor " + tableName + ": " + to_string(dup) + " duplikat dibuang");
+    }
+
+    /**
+     * @brief Jalur Staging importFromCSV: seluruh sisa file dimuat ke tabel TEMPORARY
+     * `_dbm_staging` (kolom nullable tanpa indeks, urutan file dijaga `_dbm_seq`),
+     * lalu digabung ke tabel tujuan dengan satu INSERT ... SELECT ... ON DUPLICATE KEY
+     * UPDATE yang di-commit bersama checkpoint 'selesai'. Tabel sementara hanya
+     * terlihat oleh koneksi ini dan dibuang di akhir.
+     */
+    bool importCSVViaStaging(const string& tableName, CompressedIFStream& csvFile, const vector<string>& columns,
+                             ImportCheckpoint& cp, const ImportOptions& options, const MergeOptions& merge, uint64_t& lineCount,
+                             RowDeduper* deduper) {
+        const string staging = "_dbm_staging";
+        auto dropStaging = [&]() {
+            try {
+                unique_ptr<sql::Statement> stmt(conn->createStatement());
+                stmt->execute("DROP TEMPORARY TABLE IF EXISTS `" + staging + "`");
+            } catch (sql::SQLException&) {}
+        };
+
+        unique_ptr<sql::PreparedStatement> single;
+        try {
+            lock_guard<TracedMutex> lock(dbMutex);
+            map<string, string> types = getTableColumns(tableName);
+            string ddl = "CREATE TEMPORARY TABLE `" + staging + "` (`_dbm_seq` BIGINT UNSIGNED NOT NULL AUTO_INCREMENT PRIMARY KEY";
+            for (const string& c : columns) ddl += ", `" + c + "` " + types[c] + " NULL";
+            dropStaging();
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            stmt->execute(ddl + ")");
+            single.reset(conn->prepareStatement(multiRowInsertSQL(staging, columns, 1)));
+        } catch (sql::SQLException& e) {
+            cerr << "Error membuat tabel staging: " << e.what() << endl;
+            writeLog(string("Error membuat tabel staging: ") + e.what());
+            return false;
+        }
+
+        // 1. Muat ke staging (INSERT multi-baris, autocommit; tabel sementara tidak perlu transaksi)
+        auto loadStart = chrono::steady_clock::now();
+        CSVRecordKind kind = csvRecordKind(tableName, columns);
+        size_t batchSize = max<size_t>(1, options.batchSize);
+        RowBatch batch(columns.size());
+        uint64_t staged = 0;
+        string line;
+        bool more = true;
+        try {
+            while (more) {
+                if (jobCancelled()) {
+                    lock_guard<TracedMutex> lock(dbMutex);
+                    dropStaging();
+                    cout << "Impor dibatalkan saat memuat staging; tabel '" << tableName << "' tidak berubah." << endl;
+                    writeLog("Impor CSV (staging) dibatalkan: " + tableName);
+                    return false;
+                }
+                more = static_cast<bool>(getline(csvFile, line));
+                if (more) {
+                    lineCount++;
+                    jobAddProgress(0, line.size() + 1);
+                    if (!line.empty() && line.find_first_not_of(" \t\r\n") != string::npos) {
+                        size_t fields = batch.appendCSVLine(line, lineCount);
+                        if (fields != columns.size()) {
+                            cout << "Peringatan: Melewatkan baris " << lineCount << " (jumlah kolom tidak cocok: " << fields << " vs " << columns.size() << ")" << endl;
+                        } else if (deduper && deduper->seen(batch, batch.size() - 1, line.size() + 1)) {
+                            batch.popRow();
+                        }
+                    }
+                    if (batch.size() < batchSize) continue;
+                }
+                if (!batch.empty()) {
+                    lock_guard<TracedMutex> lock(dbMutex);
+                    staged += insertCSVRowsBulkUnlocked(staging, columns, MergeOptions(), single.get(), batch, kind);
+                }
+                batch.clear();
+            }
+        } catch (sql::SQLException& e) {
+            lock_guard<TracedMutex> lock(dbMutex);
+            dropStaging();
+            cerr << "Error memuat staging: " << e.what() << endl;
+            writeLog(string("Error memuat staging: ") + e.what());
+            return false;
+        }
+
+        // 2. Gabungkan dengan satu statement set-based, commit bersama checkpoint
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            string cols;
+            for (const string& c : columns) cols += (cols.empty() ? "`" : ", `") + c + "`";
+            conn->setAutoCommit(false);
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            uint64_t affected = stmt->executeUpdate(
+                "INSERT INTO `" + tableName + "` (" + cols + ") SELECT " + cols + " FROM `" + staging + "` ORDER BY `_dbm_seq`"
+                + mergeUpdateClause(tableName, columns, merge));
+            invalidateCachedTable(tableName);
+            ImportCheckpoint next = cp;
+            next.lineNumber = lineCount;
+            next.byteOffset = -1;
+            next.rowsCommitted = staged;
+            next.completed = !csvFile.hasError();
+            saveCheckpointUnlocked(tableName, next);
+            conn->commit();
+            conn->setAutoCommit(true);
+            cp = next;
+            dropStaging();
+            jobAddProgress(staged);
+            cout << staged << " baris staging digabung ke '" << tableName << "' (" << affected
+                 << " baris terpengaruh; baris yang diperbarui dihitung 2 oleh MySQL)." << endl;
+            if (deduper) reportDedupe(*deduper, chrono::duration<double>(chrono::steady_clock::now() - loadStart).count(), staged, tableName);
+            return true;
+        } catch (sql::SQLException& e) {
+            try { conn->rollback(); } catch (sql::SQLException&) {}
+            try { conn->setAutoCommit(true); } catch (sql::SQLException&) {}
+            dropStaging();
+            cerr << "Error menggabungkan staging: " << e.what() << endl;
+            writeLog(string("Error menggabungkan staging ke ") + tableName + ": " + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Memasukkan satu batch baris dan checkpoint-nya dalam satu transaksi.
+     * Mode Insert memakai statement per baris; Upsert/Ignore memakai INSERT multi-baris.
+     * Error lain (koneksi putus, deadlock, commit gagal) me-rollback seluruh batch
+     * dan dilempar ulang, sehingga checkpoint tetap menunjuk batch terakhir yang sukses.
+     */
+    void commitImportBatch(sql::PreparedStatement* pstmt, const string& tableName, const RowBatch& batch,
+                           ImportCheckpoint& cp, const vector<string>& columns = {},
+                           const MergeOptions& merge = MergeOptions()) {
+        TraceZone zone("import.commit_batch", "db"); // Termasuk tunggu dbMutex dan round trip server
+        zone.arg("rows", static_cast<int64_t>(batch.size()));
+        lock_guard<TracedMutex> lock(dbMutex);
+        conn->setAutoCommit(false);
+        uint64_t inserted = 0;
+        CSVRecordKind kind = csvRecordKind(tableName, columns);
+        try {
+            if (merge.mode == MergeMode::Insert || batch.empty()) {
+                inserted = insertCSVRowsOneByOneUnlocked(pstmt, batch, 0, batch.size(), kind);
+            } else {
+                inserted = insertCSVRowsBulkUnlocked(tableName, columns, merge, pstmt, batch, kind);
+            }
+            ImportCheckpoint next = cp;
+            next.rowsCommitted += inserted;
+            saveCheckpointUnlocked(tableName, next);
+            invalidateCachedTable(tableName);
+            TraceZone commitZone("db.commit", "db");
+            conn->commit();
+            commitZone.end();
+            conn->setAutoCommit(true);
+            cp = next;
+            jobAddProgress(inserted);
+        } catch (sql::SQLException&) {
+            try { conn->rollback(); } catch (sql::SQLException&) {}
+            try { conn->setAutoCommit(true); } catch (sql::SQLException&) {}
+            throw;
+        }
+    }
+
+    /**
+     * @brief Menyusun klausa WHERE berparameter dari daftar ExportFilter.
+     * Setiap kolom divalidasi terhadap 'columns'; nilai ditambahkan ke 'params'
+     * sesuai urutan placeholder '?'. Mengembalikan false jika ada filter tidak valid.
+     */
+    bool buildFilterClause(const vector<ExportFilter>& filters, const map<string, string>& columns,
+                           string& clause, vector<string>& params) {
+        clause.clear();
+        params.clear();
+        vector<string> parts;
+        for (const ExportFilter& f : filters) {
+            if (!isValidIdentifier(f.column)) return false; // Keamanan
+            if (columns.find(f.column) == columns.end()) {
+                cerr << "Error: Kolom filter '" << f.column << "' tidak ditemukan di tabel." << endl;
+                return false;
+            }
+            string col = "`" + f.column + "`";
+            switch (f.op) {
+                case ExportFilter::Op::Equal:
+                    if (f.values.size() != 1) {
+                        cerr << "Error: Filter '=' pada '" << f.column << "' membutuhkan tepat 1 nilai." << endl;
+                        return false;
+                    }
+                    parts.push_back(col + " = ?");
+                    params.push_back(f.values[0]);
+                    break;
+                case ExportFilter::Op::In: {
+                    if (f.values.empty()) {
+                        cerr << "Error: Filter IN pada '" << f.column << "' membutuhkan minimal 1 nilai." << endl;
+                        return false;
+                    }
+                    string in = col + " IN (";
+                    for (size_t i = 0; i < f.values.size(); ++i) {
+                        in += "?";
+                        if (i < f.values.size() - 1) in += ",";
+                        params.push_back(f.values[i]);
+                    }
+                    parts.push_back(in + ")");
+                    break;
+                }
+                case ExportFilter::Op::Range:
+                    if (f.values.size() != 2 || (f.values[0].empty() && f.values[1].empty())) {
+                        cerr << "Error: Filter rentang pada '" << f.column << "' membutuhkan batas awal dan/atau akhir." << endl;
+                        return false;
+                    }
+                    if (!f.values[0].empty()) {
+                        parts.push_back(col + " >= ?");
+                        params.push_back(f.values[0]);
+                    }
+                    if (!f.values[1].empty()) {
+                        parts.push_back(col + " < ?");
+                        params.push_back(f.values[1]);
+                    }
+                    break;
+            }
+        }
+        for (size_t i = 0; i < parts.size(); ++i) {
+            clause += (i == 0 ? " WHERE " : " AND ") + parts[i];
+        }
+        return true;
+    }
+
+
+public:
+    DatabaseManager(const string& host, const string& user, const string& pass) : driver(nullptr), connInfo{host, user, pass} {
+        try {
+            driver = sql::mysql::get_mysql_driver_instance();
+            conn.reset(driver->connect(host, user, pass));
+            conn->setAutoCommit(true);
+        } catch (sql::SQLException& e) {
+            cerr << "Koneksi ke MySQL gagal: " << e.what() << endl;
+            throw runtime_error(string("Koneksi ke MySQL gagal: ") + e.what());
+        }
+        logFile.open("db_operations.log", ios::app);
+        if (!logFile.is_open()) {
+            cerr << "Gagal membuka file log db_operations.log" << endl;
+        }
+        writeLog("DatabaseManager diinisialisasi.");
+    }
+
+    ~DatabaseManager() {
+        writeLog("DatabaseManager ditutup.");
+        if (logFile.is_open()) logFile.close();
+    }
+
+    string getCurrentDB() const {
+        return currentDB;
+    }
+
+    const ConnectionInfo& connectionInfo() const {
+        return connInfo;
+    }
+
+    /**
+     * @brief Membuang cache hasil untuk tulis yang dilakukan lewat koneksi lain
+     * (job dengan koneksi sendiri, AsyncDatabase). Tabel kosong = seluruh cache.
+     */
+    void invalidateResultCache(const string& tableName = "") {
+        lock_guard<TracedMutex> lock(dbMutex);
+        if (tableName.empty()) resultCache.clear();
+        else invalidateCachedTable(tableName);
+    }
+
+    void showResultCache() {
+        resultCache.printStats();
+    }
+
+    /**
+     * @brief Menjalankan satu statement berparameter secara non-interaktif dan
+     * mengumpulkan hasilnya ke 'result'. Dipakai oleh API async.
+     * Peringatan: 'sql' dieksekusi apa adanya; hanya nilai yang di-bind.
+     */
+    bool runStatement(const string& sql, const vector<string>& params, QueryResult& result) {
+        result = QueryResult();
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(sql));
+            CaptureZone capture(captureSession, sql);
+            if (capture.recording()) capture.params().assign(params.begin(), params.end());
+            for (size_t i = 0; i < params.size(); ++i) {
+                pstmt->setString(i + 1, params[i]);
+            }
+            if (!isReadOnlyStatement(sql)) resultCache.clear();
+            bool hasResult = pstmt->execute();
+            capture.done();
+            if (hasResult) {
+                unique_ptr<sql::ResultSet> res(pstmt->getResultSet());
+                sql::ResultSetMetaData* meta = res->getMetaData();
+                unsigned int cols = meta->getColumnCount();
+                for (unsigned int i = 1; i <= cols; ++i) result.columns.push_back(meta->getColumnLabel(i));
+                while (res->next()) {
+                    vector<optional<string>> row;
+                    row.reserve(cols);
+                    for (unsigned int i = 1; i <= cols; ++i) {
+                        if (res->isNull(i)) row.emplace_back(nullopt);
+                        else row.emplace_back(string(res->getString(i)));
+                    }
+                    result.rows.push_back(std::move(row));
+                }
+            } else {
+                result.affectedRows = pstmt->getUpdateCount();
+            }
+            return true;
+        } catch (sql::SQLException& e) {
+            writeLog(string("Error runStatement: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Menjalankan ulang satu statement dari file capture (lihat replayWorkload).
+     * Tanpa parameter dijalankan sebagai statement biasa (START TRANSACTION, DDL,
+     * query bebas); parameter di-bind sebagai teks, NULL tetap NULL. Hasil SELECT
+     * dihabiskan tanpa disimpan. 'elapsedUs' = bind + eksekusi, sama seperti capture.
+     */
+    bool replayStatement(const string& sql, const vector<optional<string>>& params, int64_t& elapsedUs) {
+        lock_guard<TracedMutex> lock(dbMutex);
+        auto start = chrono::steady_clock::now();
+        try {
+            unique_ptr<sql::Statement> stmt;
+            unique_ptr<sql::PreparedStatement> pstmt;
+            bool hasResult;
+            if (params.empty()) {
+                stmt.reset(conn->createStatement());
+                start = chrono::steady_clock::now();
+                hasResult = stmt->execute(sql);
+            } else {
+                pstmt.reset(conn->prepareStatement(sql));
+                start = chrono::steady_clock::now();
+                unsigned int idx = 1;
+                bindRecord(pstmt.get(), idx, params);
+                hasResult = pstmt->execute();
+            }
+            elapsedUs = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+            if (hasResult) {
+                unique_ptr<sql::ResultSet> res(stmt ? stmt->getResultSet() : pstmt->getResultSet());
+                while (res && res->next()) {}
+            }
+            if (!isReadOnlyStatement(sql)) resultCache.clear();
+            return true;
+        } catch (sql::SQLException& e) {
+            elapsedUs = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+            writeLog(string("Error replay statement: ") + e.what());
+            return false;
+        }
+    }
+
+    // --- OPERASI DATABASE ---
+
+    bool createDatabase(const string& name) {
+        if (!isValidIdentifier(name)) return false; // Keamanan
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (!conn) {
+                cerr << "Belum terhubung ke server." << endl;
+                return false;
+            }
+            if (databaseExistsUnlocked(name)) {
+                cout << "Database '" << name << "' sudah ada. Tidak dapat membuat duplikat." << endl;
+                writeLog("Gagal membuat database (duplikat): " + name);
+                return false;
+            }
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            // Aman karena 'name' sudah divalidasi
+            stmt->execute("CREATE DATABASE `" + name + "`");
+            cout << "Database '" << name << "' berhasil dibuat." << endl;
+            writeLog("Membuat database: " + name);
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error membuat database: " << e.what() << endl;
+            writeLog(string("Error membuat database: ") + e.what());
+            return false;
+        }
+    }
+
+    bool listDatabases() {
+        try {
+            unique_ptr<sql::Statement> stmt;
+            unique_ptr<sql::ResultSet> res;
+            {
+                lock_guard<TracedMutex> lock(dbMutex);
+                if (!conn) {
+                    cerr << "Belum terhubung ke server." << endl;
+                    return false;
+                }
+                stmt.reset(conn->createStatement());
+                res.reset(stmt->executeQuery("SHOW DATABASES"));
+            }
+            cout << "\nDaftar Database:\n";
+            cout << string(20, '-') << "\n";
+            bool found = false;
+            while (res->next()) {
+                cout << " - " << res->getString(1) << "\n";
+                found = true;
+            }
+            if (!found) cout << "(tidak ada database)\n";
+            cout << string(20, '-') << "\n";
+            writeLog("Mendaftar database.");
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Gagal menampilkan daftar database. (" << e.what() << ")\n";
+            writeLog(string("Gagal menampilkan daftar database: ") + e.what());
+            return false;
+        }
+    }
+
+    /** @brief Nama semua database di server (SHOW DATABASES); kosong jika gagal. */
+    vector<string> databaseNames() {
+        vector<string> names;
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            unique_ptr<sql::ResultSet> res(stmt->executeQuery("SHOW DATABASES"));
+            while (res->next()) names.push_back(res->getString(1));
+        } catch (sql::SQLException& e) {
+            writeLog(string("Gagal membaca daftar database: ") + e.what());
+        }
+        return names;
+    }
+
+    bool dropDatabase(const string& name) {
+        if (!isValidIdentifier(name)) return false; // Keamanan
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (!conn) {
+                cerr << "Belum terhubung ke server." << endl;
+                return false;
+            }
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            // Aman karena 'name' sudah divalidasi
+            stmt->execute("DROP DATABASE IF EXISTS `" + name + "`");
+            resultCache.clear();
+            cout << "Database '" << name << "' dihapus (jika ada)." << endl;
+            writeLog("Menghapus database: " + name);
+            if (currentDB == name) currentDB.clear();
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error menghapus database: " << e.what() << endl;
+            writeLog(string("Error menghapus database: ") + e.what());
+            return false;
+        }
+    }
+
+    bool useDatabase(const string& name) {
+        if (!isValidIdentifier(name)) return false; // Keamanan
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (!conn) {
+                cerr << "Belum terhubung ke server." << endl;
+                return false;
+            }
+            // 'databaseExistsUnlocked' menggunakan prepared statement, jadi aman
+            if (!databaseExistsUnlocked(name)) {
+                cout << "Database '" << name << "' tidak ditemukan." << endl;
+                return false;
+            }
+            conn->setSchema(name);
+            currentDB = name;
+            cout << "Berhasil menggunakan database: " << name << endl;
+            writeLog("Menggunakan database: " + name);
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error menggunakan database: " << e.what() << endl;
+            writeLog(string("Error menggunakan database: ") + e.what());
+            return false;
+        }
+    }
+
+    // --- OPERASI TABEL ---
+
+    bool createTable(const string& tableName, const string& columnsDef) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+        if (columnsDef.empty()) {
+            cout << "Definisi kolom kosong." << endl;
+            return false;
+        }
+        
+        // Peringatan: columnsDef masih rentan, tapi sulit divalidasi
+        // Ini adalah risiko yang harus diterima pengguna fitur ini.
+        if (columnsDef.find_first_of(";'\"") != string::npos) {
+             cout << "Peringatan: Definisi kolom mungkin mengandung karakter tidak aman. Lanjutkan? (y/n): ";
+             char c;
+             cin >> c;
+             cin.ignore(numeric_limits<streamsize>::max(), '\n');
+             if (c != 'y' && c != 'Y') {
+                cout << "Pembuatan tabel dibatalkan." << endl;
+                return false;
+             }
+        }
+
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            // Aman untuk tableName, tapi columnsDef masih berisiko
+            string query = "CREATE TABLE `" + tableName + "` (" + columnsDef + ")";
+            stmt->execute(query);
+            cout << "Tabel '" << tableName << "' berhasil dibuat." << endl;
+            writeLog("Membuat tabel: " + tableName + " di " + currentDB);
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error membuat tabel: " << e.what() << endl;
+            writeLog(string("Error membuat tabel: ") + e.what());
+            return false;
+        }
+    }
+
+    bool listTables() {
+        unique_ptr<sql::ResultSet> res;
+        {
+            lock_guard<TracedMutex> lock(dbMutex);
+            try {
+                if (currentDB.empty()) {
+                    cout << "Pilih database terlebih dahulu!" << endl;
+                    return false;
+                }
+                unique_ptr<sql::Statement> stmt(conn->createStatement());
+                res.reset(stmt->executeQuery("SHOW TABLES"));
+            } catch (sql::SQLException& e) {
+                cerr << "Error mendaftar tabel: " << e.what() << endl;
+                writeLog(string("Error mendaftar tabel: ") + e.what());
+                return false;
+            }
+        }
+
+        cout << "\nDaftar tabel di " << currentDB << ":" << endl;
+        cout << string(20, '-') << "\n";
+        bool any = false;
+        while (res->next()) {
+            cout << " - " << res->getString(1) << endl;
+            any = true;
+        }
+        if (!any) cout << "(tidak ada tabel)\n";
+        cout << string(20, '-') << "\n";
+        writeLog("Mendaftar tabel di " + currentDB);
+        return true;
+    }
+
+    bool dropTable(const string& name) {
+        if (!isValidIdentifier(name)) return false; // Keamanan
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            // Aman karena 'name' sudah divalidasi
+            stmt->execute("DROP TABLE IF EXISTS `" + name + "`");
+            invalidateCachedTable(name);
+            cout << "Tabel '" << name << "' dihapus." << endl;
+            writeLog("Menghapus tabel: " + name + " di " + currentDB);
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error menghapus tabel: " << e.what() << endl;
+            writeLog(string("Error menghapus tabel: ") + e.what());
+            return false;
+        }
+    }
+
+    bool describeTable(const string& tableName) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+
+        unique_ptr<sql::ResultSet> res;
+        {
+            lock_guard<TracedMutex> lock(dbMutex);
+            try {
+                if (currentDB.empty()) {
+                    cout << "Pilih database terlebih dahulu!" << endl;
+                    return false;
+                }
+                unique_ptr<sql::Statement> stmt(conn->createStatement());
+                // Aman karena 'tableName' sudah divalidasi
+                res.reset(stmt->executeQuery("DESCRIBE `" + tableName + "`"));
+            } catch (sql::SQLException& e) {
+                cerr << "Error mendeskripsikan tabel: " << e.what() << endl;
+                writeLog(string("Error mendeskripsikan tabel: ") + e.what());
+                return false;
+            }
+        }
+
+        cout << "\nSkema tabel '" << tableName << "':" << endl;
+        cout << left << setw(20) << "Kolom" << setw(20) << "Tipe" << setw(10) << "Null" << setw(10) << "Kunci" << "Default" << "Extra" << endl;
+        cout << string(80, '-') << endl;
+        while (res->next()) {
+            cout << left << setw(20) << res->getString("Field")
+                 << setw(20) << res->getString("Type")
+                 << setw(10) << res->getString("Null")
+                 << setw(10) << res->getString("Key")
+                 << setw(10) << (res->isNull("Default") ? "NULL" : res->getString("Default"))
+                 << res->getString("Extra") << endl;
+        }
+        writeLog("Mendeskripsikan tabel: " + tableName);
+        return true;
+    }
+
+    bool truncateTable(const string& tableName) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            // Aman karena 'tableName' sudah divalidasi
+            stmt->execute("TRUNCATE TABLE `" + tableName + "`");
+            invalidateCachedTable(tableName);
+            cout << "Tabel '" << tableName << "' dipotong." << endl;
+            writeLog("Memotong tabel: " + tableName);
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error memotong tabel: " << e.what() << endl;
+            writeLog(string("Error memotong tabel: ") + e.what());
+            return false;
+        }
+    }
+
+    // --- OPERASI DATA (INTERAKTIF & AMAN) ---
+
+    bool insertData(const string& tableName) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (currentDB.empty()) {
+                cout << "Gunakan database terlebih dahulu!\n";
+                return false;
+            }
 
             map<string, string> columnsMap = getTableColumns(tableName);
             if (columnsMap.empty()) {
@@ -463,958 +5386,4415 @@ public:
                 return false;
             }
 
-            vector<string> columns;
-            vector<string> values;
-            cout << "\nMasukkan nilai untuk kolom-kolom tabel '" << tableName << "':\n";
-            
-            unique_ptr<sql::Statement> stmt(conn->createStatement());
-            unique_ptr<sql::ResultSet> res(stmt->executeQuery("DESCRIBE `" + tableName + "`"));
+            vector<string> columns;
+            vector<string> values;
+            cout << "\nMasukkan nilai untuk kolom-kolom tabel '" << tableName << "':\n";
+            
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            unique_ptr<sql::ResultSet> res(stmt->executeQuery("DESCRIBE `" + tableName + "`"));
+
+            while (res->next()) {
+                string colName = res->getString("Field");
+                string extra = res->getString("Extra");
+                if (extra.find("auto_increment") == string::npos) {
+                    columns.push_back(colName);
+                    cout << colName << " (" << res->getString("Type") << "): ";
+                    string val;
+                    if (cin.peek() == '\n') cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    getline(cin, val);
+                    
+                    values.push_back(val);
+                }
+            }
+
+            if (columns.empty()) {
+                cout << "Tidak ditemukan kolom untuk dimasukkan (mungkin hanya auto_increment?).\n";
+                return false;
+            }
+
+            string query = "INSERT INTO `" + tableName + "` (";
+            string valuePlaceholders = ") VALUES (";
+            for (size_t i = 0; i < columns.size(); ++i) {
+                query += "`" + columns[i] + "`";
+                valuePlaceholders += "?";
+                if (i < columns.size() - 1) {
+                    query += ",";
+                    valuePlaceholders += ",";
+                }
+            }
+            query += valuePlaceholders + ");";
+            
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(query));
+            CaptureZone capture(captureSession, query);
+            for (size_t i = 0; i < values.size(); ++i) {
+                bool isNull = values[i] == "NULL" || values[i] == "null";
+                if (isNull) {
+                    pstmt->setNull(i + 1, sql::DataType::VARCHAR); // Lebih baik setNull
+                } else {
+                    pstmt->setString(i + 1, values[i]);
+                }
+                if (capture.recording()) capture.params().push_back(isNull ? nullopt : optional<string>(values[i]));
+            }
+
+            pstmt->executeUpdate();
+            capture.done();
+            invalidateCachedTable(tableName);
+            cout << "Data berhasil dimasukkan ke tabel '" << tableName << "'.\n";
+            writeLog("Insert otomatis ke tabel: " + tableName);
+            return true;
+        }
+        catch (sql::SQLException& e) {
+            cerr << "Error saat insert otomatis: " << e.what() << endl;
+            writeLog(string("Error insert otomatis: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Versi non-interaktif dari insertData (digunakan oleh generateRandomData).
+     * Ini sudah aman menggunakan prepared statements.
+     */
+    bool insertData(const string& tableName, const vector<string>& columns, const vector<string>& values) {
+        // Asumsi: tableName dan columns divalidasi oleh pemanggil jika perlu
+        if (columns.empty() || columns.size() != values.size()) {
+            writeLog("Error insert non-interaktif: Kolom dan nilai tidak cocok.");
+            return false;
+        }
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (currentDB.empty()) {
+                writeLog("Error insert non-interaktif: DB tidak dipilih.");
+                return false;
+            }
+
+            string query = "INSERT INTO `" + tableName + "` (";
+            string valuePlaceholders = ") VALUES (";
+            for (size_t i = 0; i < columns.size(); ++i) {
+                query += "`" + columns[i] + "`"; // Asumsi nama kolom aman dari internal
+                valuePlaceholders += "?";
+                if (i < columns.size() - 1) {
+                    query += ",";
+                    valuePlaceholders += ",";
+                }
+            }
+            query += valuePlaceholders + ");";
+
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(query));
+            CaptureZone capture(captureSession, query);
+            if (capture.recording()) capture.params().assign(values.begin(), values.end());
+            for (size_t i = 0; i < values.size(); ++i) {
+                pstmt->setString(i + 1, values[i]);
+            }
+            pstmt->executeUpdate();
+            capture.done();
+            invalidateCachedTable(tableName);
+            return true;
+        }
+        catch (sql::SQLException& e) {
+            writeLog(string("Error insert non-interaktif (") + tableName + "): " + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Memasukkan beberapa RowSet (boleh berbeda tabel) dalam SATU transaksi
+     * memakai INSERT multi-baris, diakhiri satu commit. Semua-atau-tidak-sama-sekali:
+     * error apa pun me-rollback seluruh set. Dipakai untuk group commit ingest.
+     * 'merge' mengatur bentrok kunci (Staging diperlakukan seperti Upsert).
+     * RowSet bertipe (records) di-bind lewat RecordSchema: angka sebagai DOUBLE/BIGINT.
+     */
+    bool insertRowSets(const vector<RowSet>& sets, const MergeOptions& merge = MergeOptions()) {
+        for (const RowSet& s : sets) {
+            if (!isValidIdentifier(s.table)) return false; // Keamanan
+            if (s.columns.empty()) return false;
+            for (const string& c : s.columns) {
+                if (!isValidIdentifier(c)) return false; // Keamanan
+            }
+            if (!unknownMergeColumn(s.columns, merge).empty()) {
+                writeLog("Error insertRowSets (" + s.table + "): kebijakan merge untuk kolom di luar RowSet.");
+                return false;
+            }
+            for (const auto& row : s.rows) {
+                if (row.size() != s.columns.size()) {
+                    writeLog("Error insertRowSets (" + s.table + "): jumlah nilai tidak sesuai kolom.");
+                    return false;
+                }
+            }
+        }
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        if (currentDB.empty()) {
+            writeLog("Error insertRowSets: DB tidak dipilih.");
+            return false;
+        }
+        static const string beginSQL = "START TRANSACTION", commitSQL = "COMMIT", rollbackSQL = "ROLLBACK";
+        uint64_t inserted = 0;
+        try {
+            {
+                CaptureZone capture(captureSession, beginSQL);
+                conn->setAutoCommit(false);
+                capture.done();
+            }
+            for (const RowSet& s : sets) {
+                const size_t cols = s.columns.size();
+                const size_t chunk = max<size_t>(1, min(MULTI_INSERT_MAX_ROWS, MULTI_INSERT_MAX_PARAMS / cols));
+                const size_t total = s.rowCount();
+                unique_ptr<sql::PreparedStatement> full; // Dipakai ulang untuk setiap potongan penuh
+                string fullSQL, partialSQL;
+                for (size_t start = 0; start < total; start += chunk) {
+                    size_t n = min(chunk, total - start);
+                    unique_ptr<sql::PreparedStatement> partial;
+                    sql::PreparedStatement* pstmt;
+                    const string* query;
+                    if (n == chunk) {
+                        if (!full) {
+                            fullSQL = multiRowInsertSQL(s.table, s.columns, n, merge);
+                            full.reset(conn->prepareStatement(fullSQL));
+                        }
+                        pstmt = full.get();
+                        query = &fullSQL;
+                    } else {
+                        partialSQL = multiRowInsertSQL(s.table, s.columns, n, merge);
+                        partial.reset(conn->prepareStatement(partialSQL));
+                        pstmt = partial.get();
+                        query = &partialSQL;
+                    }
+                    CaptureZone capture(captureSession, *query);
+                    unsigned int idx = 1;
+                    visitRows(s, [&](const auto& rows) {
+                        for (size_t r = start; r < start + n; ++r) {
+                            bindRecord(pstmt, idx, rows[r]);
+                            if (capture.recording()) captureRecord(capture.params(), rows[r]);
+                        }
+                    });
+                    pstmt->executeUpdate();
+                    capture.done();
+                    inserted += n;
+                }
+                invalidateCachedTable(s.table);
+            }
+            {
+                CaptureZone capture(captureSession, commitSQL);
+                conn->commit();
+                capture.done();
+            }
+            conn->setAutoCommit(true);
+        } catch (sql::SQLException& e) {
+            {
+                CaptureZone capture(captureSession, rollbackSQL);
+                try { conn->rollback(); capture.done(); } catch (sql::SQLException&) {}
+            }
+            try { conn->setAutoCommit(true); } catch (sql::SQLException&) {}
+            writeLog(string("Error insertRowSets: ") + e.what());
+            return false;
+        }
+        jobAddProgress(inserted);
+        return true;
+    }
+
+    /** @brief Mencetak judul dan header kolom hasil selectData; mengembalikan lebar kolom. */
+    static vector<int> printSelectHeader(const string& tableName, const vector<string>& columns) {
+        cout << "\nData dari '" << tableName << "':" << endl;
+        int totalWidth = 0;
+        vector<int> colWidths;
+        for (const string& name : columns) {
+            int width = max((int)name.length(), 15);
+            colWidths.push_back(width);
+            cout << left << setw(width) << name << " | ";
+            totalWidth += width + 3;
+        }
+        cout << endl << string(totalWidth, '-') << endl;
+        return colWidths;
+    }
+
+    static void printSelectRow(const vector<optional<string>>& row, const vector<int>& colWidths) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            string val = row[i] ? *row[i] : "NULL";
+            if (val.length() > (size_t)colWidths[i]) {
+                val = val.substr(0, colWidths[i] - 3) + "...";
+            }
+            cout << left << setw(colWidths[i]) << val << " | ";
+        }
+        cout << endl;
+    }
+
+    /**
+     * @brief [REWRITE] Menampilkan data dengan filter WHERE interaktif dan aman.
+     * Hasil disimpan di cache
+     * per manager; filter yang sama dijawab dari memori sampai tabel ditulis
+     * lewat manager ini (atau entri kedaluwarsa, untuk tulis dari luar).
+     */
+    bool selectData(const string& tableName) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+        MemoryScope memory("select");
+
+        try {
+            vector<string> whereColumns;
+            vector<string> whereValues;
+            map<string, string> columns;
+
+            // 1. Dapatkan kolom dan tanyakan filter
+            {
+                lock_guard<TracedMutex> lock(dbMutex);
+                if (currentDB.empty()) {
+                    cout << "Pilih database terlebih dahulu!" << endl;
+                    return false;
+                }
+                columns = getTableColumns(tableName);
+                if (columns.empty()) {
+                    cerr << "Gagal mendapatkan kolom untuk '" << tableName << "'." << endl;
+                    return false;
+                }
+            }
+
+            cout << "Kolom yang tersedia: ";
+            for(auto const& [key, val] : columns) cout << key << " ";
+            cout << "\n";
+
+            string colName;
+            while (true) {
+                cout << "Filter WHERE berdasarkan kolom (atau 'selesai'): ";
+                getline(cin, colName);
+                if (colName == "selesai" || colName.empty()) break;
+
+                if (columns.find(colName) == columns.end()) {
+                    cout << "Kolom '" << colName << "' tidak ditemukan." << endl;
+                    continue;
+                }
+
+                cout << "Nilai untuk " << colName << " = ";
+                string val;
+                getline(cin, val);
+                whereColumns.push_back(colName);
+                whereValues.push_back(val);
+            }
+
+            // 2. Cache hasil: filter yang sama pada tabel yang belum ditulis sejak itu
+            string scope;
+            string cacheKey;
+            uint64_t cacheGeneration;
+            {
+                lock_guard<TracedMutex> lock(dbMutex);
+                scope = ResultCache::scopeOf(currentDB, tableName);
+                cacheKey = ResultCache::makeKey(currentDB, tableName, whereColumns, whereValues);
+                cacheGeneration = resultCache.generation();
+            }
+            QueryResult cached;
+            if (resultCache.get(cacheKey, cached)) {
+                vector<int> colWidths = printSelectHeader(tableName, cached.columns);
+                for (const auto& row : cached.rows) printSelectRow(row, colWidths);
+                cout << "(dari cache, " << cached.rows.size() << " baris)" << endl;
+                writeLog("Memilih data dari tabel (interaktif, cache): " + tableName);
+                return true;
+            }
+
+            // 3. Build & Eksekusi Query
+            unique_ptr<sql::PreparedStatement> pstmt;
+            unique_ptr<sql::ResultSet> res;
+            double queryMs = 0;
+            {
+                lock_guard<TracedMutex> lock(dbMutex);
+                string query = "SELECT * FROM `" + tableName + "`";
+                if (!whereColumns.empty()) {
+                    query += " WHERE ";
+                    for (size_t i = 0; i < whereColumns.size(); ++i) {
+                        query += "`" + whereColumns[i] + "` = ?";
+                        if (i < whereColumns.size() - 1) query += " AND ";
+                    }
+                }
+                
+                pstmt.reset(conn->prepareStatement(query));
+                CaptureZone capture(captureSession, query);
+                if (capture.recording()) capture.params().assign(whereValues.begin(), whereValues.end());
+                for (size_t i = 0; i < whereValues.size(); ++i) {
+                    pstmt->setString(i + 1, whereValues[i]);
+                }
+                auto queryStart = chrono::steady_clock::now();
+                res.reset(pstmt->executeQuery());
+                capture.done();
+                queryMs = chrono::duration<double, milli>(chrono::steady_clock::now() - queryStart).count();
+            }
+
+            // 4. Tampilkan Hasil sambil mengisi cache (berhenti mengisi jika melewati batas entri)
+            sql::ResultSetMetaData* meta = res->getMetaData();
+            int cols = meta->getColumnCount();
+            QueryResult result;
+            for (int i = 1; i <= cols; ++i) result.columns.push_back(meta->getColumnName(i));
+            vector<int> colWidths = printSelectHeader(tableName, result.columns);
+            size_t resultBytes = 0;
+            bool cacheable = true;
+            while (res->next()) {
+                vector<optional<string>> row;
+                row.reserve(cols);
+                for (int i = 1; i <= cols; ++i) {
+                    if (res->isNull(i)) row.emplace_back(nullopt);
+                    else row.emplace_back(string(res->getString(i)));
+                }
+                printSelectRow(row, colWidths);
+                if (!cacheable) continue;
+                resultBytes += ResultCache::rowBytes(row);
+                if (resultBytes > resultCache.entryLimit()) {
+                    cacheable = false;
+                    vector<vector<optional<string>>>().swap(result.rows);
+                    continue;
+                }
+                result.rows.push_back(std::move(row));
+            }
+            if (cacheable) resultCache.put(scope, cacheKey, std::move(result), resultBytes, cacheGeneration);
+            {
+                lock_guard<TracedMutex> lock(dbMutex);
+                recordFilterUnlocked(tableName, whereColumns, whereValues, queryMs);
+            }
+            writeLog("Memilih data dari tabel (interaktif): " + tableName);
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error memilih data: " << e.what() << endl;
+            writeLog(string("Error memilih data: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief [REWRITE] Update data dengan panduan interaktif dan aman.
+     * Input operator dikumpulkan tanpa lock; dbMutex hanya dipegang saat
+     * DESCRIBE, pratinjau, dan UPDATE itu sendiri.
+     */
+    bool updateData(const string& tableName) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+
+        // 1. Kumpulkan input (tanpa lock)
+        map<string, string> columns;
+        if (!columnsForPrompt(tableName, columns)) return false;
+
+        vector<string> setColumns;
+        vector<string> setValues;
+        promptColumnValues(columns, "Masukkan nama kolom untuk di-SET (atau 'selesai'): ", "Nilai BARU untuk", setColumns, setValues);
+        if (setColumns.empty()) {
+            cout << "Tidak ada kolom yang di-SET. Operasi dibatalkan." << endl;
+            return false;
+        }
+        vector<string> whereColumns;
+        vector<string> whereValues;
+        promptColumnValues(columns, "Filter WHERE berdasarkan kolom (atau 'selesai'): ", "Nilai WHERE (=) untuk", whereColumns, whereValues);
+
+        // 2. Pratinjau, lalu konfirmasi (tanpa lock)
+        int64_t preview = previewAffectedRows(tableName, whereColumns, whereValues);
+        if (preview < 0) return false;
+        if (preview == 0) {
+            cout << "Tidak ada baris yang cocok. Update dibatalkan." << endl;
+            return true;
+        }
+        if (!confirmAffected(!whereColumns.empty(), "LANJUTKAN", "Update")) {
+            cout << "Update dibatalkan." << endl;
+            return false;
+        }
+
+        // 3. Eksekusi
+        string query = "UPDATE `" + tableName + "` SET ";
+        for (size_t i = 0; i < setColumns.size(); ++i) {
+            query += "`" + setColumns[i] + "` = ?";
+            if (i < setColumns.size() - 1) query += ", ";
+        }
+        query += whereEqualsClause(whereColumns);
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(query));
+            CaptureZone capture(captureSession, query);
+            if (capture.recording()) {
+                capture.params().assign(setValues.begin(), setValues.end());
+                capture.params().insert(capture.params().end(), whereValues.begin(), whereValues.end());
+            }
+            int paramIndex = 1;
+            for (const string& val : setValues) {
+                pstmt->setString(paramIndex++, val);
+            }
+            for (const string& val : whereValues) {
+                pstmt->setString(paramIndex++, val);
+            }
+            
+            auto queryStart = chrono::steady_clock::now();
+            int rowsAffected = pstmt->executeUpdate();
+            capture.done();
+            double queryMs = chrono::duration<double, milli>(chrono::steady_clock::now() - queryStart).count();
+            invalidateCachedTable(tableName);
+            cout << rowsAffected << " baris diperbarui di '" << tableName << "'." << endl;
+            recordFilterUnlocked(tableName, whereColumns, whereValues, queryMs);
+            writeLog("Memperbarui data di tabel (interaktif): " + tableName);
+            return true;
+
+        } catch (sql::SQLException& e) {
+            cerr << "Error memperbarui data: " << e.what() << endl;
+            writeLog(string("Error memperbarui data: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief [REWRITE] Menghapus data dengan panduan interaktif dan aman.
+     * Sama seperti updateData: input dan konfirmasi dikumpulkan tanpa dbMutex.
+     */
+    bool deleteData(const string& tableName) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+
+        // 1. Kumpulkan input (tanpa lock)
+        map<string, string> columns;
+        if (!columnsForPrompt(tableName, columns)) return false;
+
+        vector<string> whereColumns;
+        vector<string> whereValues;
+        promptColumnValues(columns, "Filter WHERE berdasarkan kolom (atau 'selesai'): ", "Nilai WHERE (=) untuk", whereColumns, whereValues);
+
+        // 2. Pratinjau, lalu konfirmasi (tanpa lock)
+        int64_t preview = previewAffectedRows(tableName, whereColumns, whereValues);
+        if (preview < 0) return false;
+        if (preview == 0) {
+            cout << "Tidak ada baris yang cocok. Delete dibatalkan." << endl;
+            return true;
+        }
+        if (!confirmAffected(!whereColumns.empty(), "HAPUS SEMUA", "Delete")) {
+            cout << "Delete dibatalkan." << endl;
+            return false;
+        }
+
+        // 3. Eksekusi
+        string query = "DELETE FROM `" + tableName + "`" + whereEqualsClause(whereColumns);
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(query));
+            CaptureZone capture(captureSession, query);
+            if (capture.recording()) capture.params().assign(whereValues.begin(), whereValues.end());
+            for (size_t i = 0; i < whereValues.size(); ++i) {
+                pstmt->setString(i + 1, whereValues[i]);
+            }
+            
+            auto queryStart = chrono::steady_clock::now();
+            int rowsAffected = pstmt->executeUpdate();
+            capture.done();
+            double queryMs = chrono::duration<double, milli>(chrono::steady_clock::now() - queryStart).count();
+            invalidateCachedTable(tableName);
+            cout << rowsAffected << " baris dihapus dari '" << tableName << "'." << endl;
+            recordFilterUnlocked(tableName, whereColumns, whereValues, queryMs);
+            writeLog("Menghapus data dari tabel (interaktif): " + tableName);
+            return true;
+
+        } catch (sql::SQLException& e) {
+            cerr << "Error menghapus data: " << e.what() << endl;
+            writeLog(string("Error menghapus data: ") + e.what());
+            return false;
+        }
+    }
+
+
+    // --- PROFILING QUERY ---
+
+    void setQueryProfiling(const QueryProfileOptions& options) {
+        lock_guard<TracedMutex> lock(dbMutex);
+        profileOptions = options;
+    }
+
+    QueryProfileOptions queryProfiling() {
+        lock_guard<TracedMutex> lock(dbMutex);
+        return profileOptions;
+    }
+
+    /**
+     * @brief Ringkasan statement yang diprofil, dikelompokkan per sidik jari dan
+     * diurutkan menurut total waktu. 'limit' = jumlah baris teratas.
+     */
+    bool showQueryProfile(size_t limit = 20) {
+        vector<StatementStats> stats = profiler.ranked();
+        if (stats.empty()) {
+            cout << "Belum ada statement yang diprofil (aktifkan profiling lalu jalankan query)." << endl;
+            return true;
+        }
+        double grandTotal = 0;
+        for (const StatementStats& s : stats) grandTotal += s.totalMs;
+        cout << "\nRingkasan profiling: " << stats.size() << " sidik jari." << endl;
+        cout << left << setw(4) << "#" << setw(8) << "Panggil" << setw(12) << "Total ms" << setw(7) << "%" << setw(10) << "Rata ms"
+             << setw(10) << "Maks ms" << setw(7) << "Lambat" << setw(12) << "Baca/pgl" << setw(11) << "Hasil/pgl" << "Sidik jari" << endl;
+        cout << string(110, '-') << endl;
+        for (size_t i = 0; i < stats.size() && i < limit; ++i) {
+            const StatementStats& s = stats[i];
+            string fp = s.fingerprint.size() > 60 ? s.fingerprint.substr(0, 57) + "..." : s.fingerprint;
+            ostringstream row;
+            row << fixed << setprecision(1) << left << setw(4) << (i + 1) << setw(8) << s.calls << setw(12) << s.totalMs
+                << setw(7) << (grandTotal > 0 ? 100.0 * s.totalMs / grandTotal : 0.0) << setw(10) << s.totalMs / s.calls
+                << setw(10) << s.maxMs << setw(7) << s.slowCalls << setw(12) << s.rowsExamined / s.calls
+                << setw(11) << s.rowsReturned / s.calls << fp;
+            cout << row.str() << endl;
+        }
+        return true;
+    }
+
+    void resetQueryProfile() {
+        profiler.reset();
+    }
+
+    // --- INDEX ADVISOR ---
+
+    /**
+     * @brief Menyusun rekomendasi indeks dari pola filter yang teramati: hanya pola
+     * yang di-EXPLAIN sebagai scan penuh (ALL/index) dan belum tercakup indeks yang
+     * kolom awalnya sama. Diurutkan menurut total waktu query (paling mahal dulu).
+     * 'ignored' diisi pola scan penuh yang sebenarnya sudah punya indeks.
+     */
+    vector<IndexRecommendation> indexRecommendations(vector<FilterObservation>* ignored = nullptr) {
+        vector<IndexRecommendation> recs;
+        map<string, vector<vector<string>>> indexes;   // "db.tabel" -> kolom tiap indeks
+        map<string, map<string, string>> columnTypes;  // "db.tabel" -> kolom -> DATA_TYPE
+        lock_guard<TracedMutex> lock(dbMutex);
+        for (const FilterObservation& o : indexAdvisor.snapshot()) {
+            if (!o.explained || (o.accessType != "ALL" && o.accessType != "index")) continue;
+            const string scope = o.db + "." + o.table;
+            if (!indexes.count(scope)) {
+                try {
+                    map<string, vector<pair<int, string>>> parts;
+                    unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+                        "SELECT INDEX_NAME, SEQ_IN_INDEX, COLUMN_NAME FROM information_schema.STATISTICS"
+                        " WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ?"));
+                    pstmt->setString(1, o.db);
+                    pstmt->setString(2, o.table);
+                    unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+                    while (res->next()) parts[res->getString("INDEX_NAME")].emplace_back(res->getInt("SEQ_IN_INDEX"), res->getString("COLUMN_NAME"));
+                    for (auto& [name, cols] : parts) {
+                        sort(cols.begin(), cols.end());
+                        vector<string> ordered;
+                        for (auto& c : cols) ordered.push_back(c.second);
+                        indexes[scope].push_back(ordered);
+                    }
+                    indexes[scope]; // Tandai sudah dibaca walau tanpa indeks
+                    unique_ptr<sql::PreparedStatement> types(conn->prepareStatement(
+                        "SELECT COLUMN_NAME, DATA_TYPE FROM information_schema.COLUMNS WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ?"));
+                    types->setString(1, o.db);
+                    types->setString(2, o.table);
+                    unique_ptr<sql::ResultSet> typeRes(types->executeQuery());
+                    while (typeRes->next()) columnTypes[scope][typeRes->getString("COLUMN_NAME")] = typeRes->getString("DATA_TYPE");
+                } catch (sql::SQLException& e) {
+                    writeLog(string("Error membaca indeks untuk advisor: ") + e.what());
+                    continue;
+                }
+            }
+
+            // Tercakup jika k kolom awal suatu indeks = himpunan kolom filter (urutan bebas untuk '=')
+            set<string> wanted(o.columns.begin(), o.columns.end());
+            bool covered = false;
+            for (const vector<string>& idx : indexes[scope]) {
+                if (idx.size() >= wanted.size() && set<string>(idx.begin(), idx.begin() + wanted.size()) == wanted) {
+                    covered = true;
+                    break;
+                }
+            }
+            if (covered) {
+                if (ignored) ignored->push_back(o);
+                continue;
+            }
+
+            IndexRecommendation r;
+            r.db = o.db;
+            r.table = o.table;
+            r.columns = o.columns;
+            r.indexName = IndexAdvisor::indexNameFor(o.columns);
+            string cols;
+            for (const string& c : o.columns) {
+                const string& type = columnTypes[scope][c];
+                bool needsPrefix = type.find("text") != string::npos || type.find("blob") != string::npos;
+                cols += (cols.empty() ? "`" : ", `") + c + "`" + (needsPrefix ? "(64)" : ""); // TEXT/BLOB wajib prefix
+            }
+            r.ddl = "CREATE INDEX `" + r.indexName + "` ON `" + o.db + "`.`" + o.table + "` (" + cols + ") ALGORITHM=INPLACE LOCK=NONE";
+            r.calls = o.calls;
+            r.totalMs = o.totalMs;
+            r.avgMs = o.calls ? o.totalMs / o.calls : 0;
+            r.accessType = o.accessType;
+            r.estimatedRows = o.estimatedRows;
+            recs.push_back(r);
+        }
+        sort(recs.begin(), recs.end(), [](const IndexRecommendation& a, const IndexRecommendation& b) {
+            if (a.totalMs != b.totalMs) return a.totalMs > b.totalMs;
+            return a.estimatedRows > b.estimatedRows;
+        });
+        return recs;
+    }
+
+    /**
+     * @brief Mencetak laporan index advisor; 'recs' diisi rekomendasi berperingkat
+     * agar pemanggil dapat menerapkan salah satunya.
+     */
+    bool showIndexAdvice(vector<IndexRecommendation>& recs) {
+        vector<FilterObservation> observed = indexAdvisor.snapshot();
+        vector<FilterObservation> ignored;
+        recs = indexRecommendations(&ignored);
+
+        uint64_t fullScans = 0;
+        for (const FilterObservation& o : observed) fullScans += o.fullScans;
+        cout << "\nIndex Advisor: " << observed.size() << " pola filter teramati, " << fullScans << " eksekusi dengan full scan." << endl;
+        if (recs.empty()) {
+            cout << "Tidak ada rekomendasi indeks." << endl;
+        } else {
+            cout << left << setw(4) << "#" << setw(20) << "Tabel" << setw(28) << "Kolom" << setw(8) << "Panggil"
+                 << setw(12) << "Total ms" << setw(10) << "Rata ms" << setw(7) << "Akses" << "Est. baris" << endl;
+            cout << string(100, '-') << endl;
+            for (size_t i = 0; i < recs.size(); ++i) {
+                const IndexRecommendation& r = recs[i];
+                ostringstream total, avg;
+                total << fixed << setprecision(1) << r.totalMs;
+                avg << fixed << setprecision(1) << r.avgMs;
+                cout << left << setw(4) << (i + 1) << setw(20) << r.table << setw(28) << joinList(r.columns, ", ")
+                     << setw(8) << r.calls << setw(12) << total.str() << setw(10) << avg.str() << setw(7) << r.accessType
+                     << r.estimatedRows << endl;
+                cout << "    " << r.ddl << ";" << endl;
+            }
+        }
+        for (const FilterObservation& o : ignored) {
+            cout << "Catatan: " << o.table << " (" << joinList(o.columns, ", ") << ") sudah punya indeks yang cocok, tetapi optimizer"
+                 << " memilih scan penuh (selektivitas rendah?)." << endl;
+        }
+        writeLog("Laporan index advisor: " + to_string(recs.size()) + " rekomendasi");
+        return true;
+    }
+
+    /**
+     * @brief Menjalankan CREATE INDEX dari rekomendasi advisor (online, ALGORITHM=INPLACE),
+     * lalu membuang rencana EXPLAIN tabel itu agar pola berikutnya dinilai ulang.
+     */
+    bool applyIndexRecommendation(const IndexRecommendation& rec) {
+        if (!isValidIdentifier(rec.db) || !isValidIdentifier(rec.table) || !isValidIdentifier(rec.indexName)) return false; // Keamanan
+        for (const string& c : rec.columns) {
+            if (!isValidIdentifier(c)) return false;
+        }
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            auto start = chrono::steady_clock::now();
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            stmt->execute(rec.ddl);
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            indexAdvisor.forgetPlans(rec.db, rec.table);
+            cout << "Indeks '" << rec.indexName << "' dibuat pada '" << rec.table << "' (" << fixed << setprecision(1)
+                 << seconds << " dtk)." << defaultfloat << endl;
+            writeLog("Index advisor membuat indeks: " + rec.ddl);
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error membuat indeks: " << e.what() << endl;
+            writeLog(string("Error membuat indeks: ") + e.what());
+            return false;
+        }
+    }
+
+    // --- FUNGSI UTILITAS (Backup, CSV, dll.) ---
+
+    bool backupDatabase(const string& dbName, const string& filePath) {
+        if (!isValidIdentifier(dbName)) return false; // Keamanan
+        if (filePath.empty()) {
+            cout << "Path file backup kosong." << endl;
+            return false;
+        }
+        MemoryScope memory("backup");
+
+        vector<string> tables;
+        {
+            lock_guard<TracedMutex> lock(dbMutex);
+            try {
+                if (!conn) {
+                    cerr << "Belum terhubung ke server." << endl;
+                    return false;
+                }
+                if (!databaseExistsUnlocked(dbName)) {
+                    cout << "Database '" << dbName << "' tidak ditemukan." << endl;
+                    writeLog("Gagal backup: database tidak ditemukan: " + dbName);
+                    return false;
+                }
+                conn->setSchema(dbName);
+                unique_ptr<sql::Statement> stmt(conn->createStatement());
+                unique_ptr<sql::ResultSet> res(stmt->executeQuery("SHOW TABLES"));
+                while (res->next()) {
+                    tables.push_back(res->getString(1)); // Nama tabel dari DB aman
+                }
+                // Kembalikan ke DB sebelumnya jika ada
+                if (!currentDB.empty() && currentDB != dbName) {
+                    conn->setSchema(currentDB);
+                }
+            } catch (sql::SQLException& e) {
+                cerr << "Error saat menyiapkan backup: " << e.what() << endl;
+                writeLog(string("Error saat menyiapkan backup: ") + e.what());
+                return false;
+            }
+        } // Lock dilepas
+
+        CompressedOFStream backupFile(filePath);
+        if (!backupFile.is_open()) {
+            cout << "Gagal membuka file backup: " << filePath << endl;
+            writeLog("Gagal membuka file backup: " + filePath);
+            return false;
+        }
+
+        try {
+            auto now = chrono::system_clock::now();
+            time_t t = chrono::system_clock::to_time_t(now);
+            backupFile << "-- Backup database: " << dbName << "\n";
+            backupFile << "-- Tanggal: " << ctime(&t);
+            
+            RowBatch rows; // Dipakai ulang untuk semua tabel
+            string out;
+            for (const string& table : tables) {
+                backupFile << "\n-- Data untuk tabel: " << table << "\n";
+                unique_ptr<sql::ResultSet> tableRes;
+                sql::ResultSetMetaData* meta;
+                int cols = 0;
+                {
+                    TraceZone selectZone("backup.select", "db");
+                    lock_guard<TracedMutex> lock(dbMutex);
+                    conn->setSchema(dbName); // Pastikan kita menggunakan DB yang benar
+                    unique_ptr<sql::Statement> stmt(conn->createStatement());
+                    tableRes.reset(stmt->executeQuery("SELECT * FROM `" + table + "`"));
+                    meta = tableRes->getMetaData();
+                    cols = meta->getColumnCount();
+                } // Lock dilepas
+
+                // Tulis header (nama kolom)
+                for (int i = 1; i <= cols; ++i) {
+                    backupFile << meta->getColumnName(i);
+                    if (i < cols) backupFile << ",";
+                }
+                backupFile << "\n";
+                // Tulis data (CSV-like), per RowBatch
+                rows.reset(cols);
+                TraceZone rowsZone("backup.write_rows", "backup");
+                int64_t rowCount = 0, escapeUs = 0;
+                while (fetchRowBatch(tableRes.get(), rows, EXPORT_BATCH_ROWS, "NULL")) {
+                    if (jobCancelled()) {
+                        cout << "Backup dibatalkan." << endl;
+                        writeLog("Backup dibatalkan: " + dbName);
+                        lock_guard<TracedMutex> lock(dbMutex);
+                        if (!currentDB.empty()) conn->setSchema(currentDB);
+                        return false;
+                    }
+                    int64_t t0 = rowsZone.active() ? tracer().nowUs() : 0;
+                    out.clear();
+                    appendCSVRows(rows, out);
+                    if (rowsZone.active()) escapeUs += tracer().nowUs() - t0;
+                    backupFile.write(out.data(), (streamsize)out.size());
+                    jobAddProgress(rows.size(), out.size());
+                    rowCount += rows.size();
+                }
+                rowsZone.arg("rows", rowCount);
+                rowsZone.arg("escape_us", escapeUs);
+            }
+            
+            { // Kembalikan koneksi ke DB yang sedang digunakan
+                lock_guard<TracedMutex> lock(dbMutex);
+                if (!currentDB.empty()) {
+                    conn->setSchema(currentDB);
+                }
+            }
+
+            if (!backupFile.close()) {
+                cerr << "Gagal menulis file backup: " << filePath << endl;
+                writeLog("Gagal menulis file backup: " + filePath);
+                return false;
+            }
+            cout << "Backup '" << dbName << "' disimpan ke " << filePath << "." << endl;
+            cout << MemoryScope::summary(memory.usage()) << endl;
+            writeLog("Membackup database: " + dbName + " ke " + filePath);
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error membackup database: " << e.what() << endl;
+            writeLog(string("Error membackup database: ") + e.what());
+            if (backupFile.is_open()) backupFile.close();
+            return false;
+        } catch (exception& e) {
+            cerr << "Error membackup database: " << e.what() << endl;
+            writeLog(string("Error membackup database (std): ") + e.what());
+            if (backupFile.is_open()) backupFile.close();
+            return false;
+        }
+    }
+
+    bool executeQuery(const string& query) {
+        if (query.empty()) {
+            cout << "Query kosong." << endl;
+            return false;
+        }
+        
+        // Peringatan: Ini adalah fungsi yang SANGAT BERBAHAYA
+        // Peringatkan pengguna
+        string upperQuery = query;
+        transform(upperQuery.begin(), upperQuery.end(), upperQuery.begin(), ::toupper);
+        
+        if (upperQuery.find("DROP") != string::npos || upperQuery.find("DELETE") != string::npos || upperQuery.find("TRUNCATE") != string::npos) {
+             cout << "PERINGATAN: Query Anda mengandung operasi destruktif (DROP/DELETE/TRUNCATE)." << endl;
+             cout << "Ketik 'YA' untuk melanjutkan: ";
+             string confirm;
+             getline(cin, confirm);
+             if (confirm != "YA") {
+                cout << "Eksekusi dibatalkan." << endl;
+                return false;
+             }
+        }
+
+
+        MemoryScope memory("query");
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            if (!isReadOnlyStatement(query)) resultCache.clear(); // Tabel yang ditulis tidak diketahui
+            
+            StatementProfile profile = beginProfileUnlocked();
+            uint64_t profiledRows = 0;
+
+            // Coba eksekusi. Jika itu SELECT, tangani hasilnya.
+            CaptureZone capture(captureSession, query);
+            bool hasResult = stmt->execute(query);
+            capture.done();
+            if (hasResult) {
+                profile.stop();
+                unique_ptr<sql::ResultSet> res(stmt->getResultSet());
+                if (res) {
+                    cout << "Hasil Query (SELECT):" << endl;
+                    sql::ResultSetMetaData* meta = res->getMetaData();
+                    int cols = meta->getColumnCount();
+                    
+                    int totalWidth = 0;
+                    vector<int> colWidths;
+                    for (int i = 1; i <= cols; ++i) {
+                        int width = max((int)meta->getColumnName(i).length(), 15);
+                        colWidths.push_back(width);
+                        cout << left << setw(width) << meta->getColumnName(i) << " | ";
+                        totalWidth += width + 3;
+                    }
+                    cout << endl << string(totalWidth, '-') << endl;
+                    while (res->next()) {
+                        for (int i = 1; i <= cols; ++i) {
+                            string val = res->getString(i);
+                            if (val.length() > colWidths[i-1]) {
+                                val = val.substr(0, colWidths[i-1] - 3) + "...";
+                            }
+                            cout << left << setw(colWidths[i-1]) << (res->isNull(i) ? "NULL" : val) << " | ";
+                        }
+                        cout << endl;
+                        profiledRows++;
+                    }
+                } else {
+                     cout << "Query (non-SELECT) berhasil dieksekusi." << endl;
+                }
+            } else {
+                profile.stop();
+                profiledRows = stmt->getUpdateCount();
+                cout << "Query (non-SELECT) berhasil dieksekusi. Baris terpengaruh: " << stmt->getUpdateCount() << endl;
+            }
+            endProfileUnlocked(profile, query, profiledRows);
+            
+            writeLog("Mengeksekusi query kustom: " + query);
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error mengeksekusi query: " << e.what() << endl;
+            writeLog(string("Error mengeksekusi query: ") + e.what());
+            return false;
+        }
+    }
+
+    bool executeQueryFromFile(const string& filePath) {
+        if (filePath.empty()) {
+            cout << "Path file kosong." << endl;
+            return false;
+        }
+        
+        ifstream file(filePath);
+        if (!file.is_open()) {
+            cout << "Gagal membuka file: " << filePath << endl;
+            return false;
+        }
+        MemoryScope memory("query_file");
+
+        {
+            lock_guard<TracedMutex> lock(dbMutex);
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+        }
+
+        string line, query;
+        int queryCount = 0;
+        try {
+            while (getline(file, line)) {
+                size_t commentPos = line.find("--");
+                if (commentPos != string::npos) line = line.substr(0, commentPos);
+    
+                line.erase(line.begin(), find_if(line.begin(), line.end(), [](int ch) { return !isspace(ch); }));
+                line.erase(find_if(line.rbegin(), line.rend(), [](int ch) { return !isspace(ch); }).base(), line.end());
+
+                if (line.empty()) continue;
+                
+                query += line + " ";
+
+                size_t pos;
+                while ((pos = query.find(';')) != string::npos) {
+                    string execQ = query.substr(0, pos);
+                    if (!execQ.empty()) {
+                        {
+                            lock_guard<TracedMutex> lock(dbMutex);
+                            executeScriptStatementUnlocked(execQ);
+                        }
+                        queryCount++;
+                    }
+                    query.erase(0, pos + 1);
+                    query.erase(query.begin(), find_if(query.begin(), query.end(), [](int ch) { return !isspace(ch); }));
+                }
+            }
+            
+            if (!query.empty()) {
+                 lock_guard<TracedMutex> lock(dbMutex);
+                 executeScriptStatementUnlocked(query);
+                 queryCount++;
+            }
+
+            file.close();
+            cout << queryCount << " query dari file berhasil dieksekusi." << endl;
+            writeLog("Mengeksekusi query dari file: " + filePath);
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error mengeksekusi query dari file: " << e.what() << endl;
+            cerr << "Query terakhir yang gagal (mungkin): " << query << endl;
+            writeLog(string("Error mengeksekusi query dari file: ") + e.what());
+            file.close();
+            return false;
+        }
+    }
+
+    bool generateRandomData(const string& tableName, int numRows) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+        if (numRows <= 0) {
+            cout << "Jumlah baris harus > 0." << endl;
+            return false;
+        }
+        
+        // Periksa apakah tabel punya 'name' dan 'age'
+        {
+             lock_guard<TracedMutex> lock(dbMutex);
+             map<string, string> cols = getTableColumns(tableName);
+             if (cols.find("name") == cols.end() || cols.find("age") == cols.end()) {
+                cerr << "Error: Tabel '" << tableName << "' harus memiliki kolom 'name' DAN 'age' untuk fitur ini." << endl;
+                return false;
+             }
+        }
+
+
+        try {
+            random_device rd;
+            mt19937 gen(rd());
+            uniform_int_distribution<> ageDist(18, 80);
+            vector<string> names = {"Alice","Bob","Charlie","Diana","Eve","Frank","Grace","Hank", "Ivan", "Judy", "Kyle", "Liam"};
+            uniform_int_distribution<> nameDist(0, (int)names.size()-1);
+
+            cout << "Mulai menghasilkan " << numRows << " baris..." << endl;
+            jobSetTotal((uint64_t)numRows);
+            for (int i = 0; i < numRows; ++i) {
+                if (jobCancelled()) {
+                    cout << "Pembuatan data acak dibatalkan setelah " << i << " baris." << endl;
+                    writeLog("Pembuatan data acak dibatalkan: " + tableName);
+                    return false;
+                }
+                string name = names[nameDist(gen)];
+                string age = to_string(ageDist(gen));
+                // Gunakan insertData non-interaktif yang aman
+                if (!insertData(tableName, {"name","age"}, {name, age})) {
+                    // Log error sudah dilakukan di dalam insertData
+                    cerr << "Gagal memasukkan data acak ke " << tableName << " pada baris " << i << endl;
+                    return false;
+                }
+                jobAddProgress(1, name.size() + age.size());
+            }
+            cout << "Selesai menghasilkan " << numRows << " baris acak di '" << tableName << "'." << endl;
+            writeLog("Menghasilkan data acak di tabel: " + tableName);
+            return true;
+        } catch (exception& e) {
+            cerr << "Error menghasilkan data acak: " << e.what() << endl;
+            writeLog(string("Error menghasilkan data acak: ") + e.what());
+            return false;
+        }
+    }
+
+    bool stressTest(int numThreads, int queriesPerThread) {
+        if (numThreads <= 0 || queriesPerThread <= 0) {
+            cout << "Parameter tes stres harus > 0." << endl;
+            return false;
+        }
+        
+        {
+            lock_guard<TracedMutex> lock(dbMutex);
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+        }
+
+        try {
+            vector<thread> threads;
+            auto startTime = chrono::high_resolution_clock::now();
+            jobSetTotal((uint64_t)numThreads * queriesPerThread);
+            Job* job = currentJob; // Diteruskan ke thread tes agar progres & pembatalan tetap tercatat
+
+            for (int i = 0; i < numThreads; ++i) {
+                threads.emplace_back([this, queriesPerThread, job]() {
+                    currentJob = job;
+                    for (int j = 0; j < queriesPerThread; ++j) {
+                        if (jobCancelled()) break;
+                        try {
+                             lock_guard<TracedMutex> lock(dbMutex); // Lock per query
+                            unique_ptr<sql::Statement> stmt(conn->createStatement());
+                            unique_ptr<sql::ResultSet> r(stmt->executeQuery("SELECT 1"));
+                            jobAddProgress(1);
+                        } catch (sql::SQLException& e) {
+                            writeLog(string("Error tes stres thread: ") + e.what());
+                        }
+                    }
+                });
+            }
+            
+            for (auto &t : threads) {
+                if (t.joinable()) t.join();
+            }
+
+            auto endTime = chrono::high_resolution_clock::now();
+            auto duration = chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count();
+            int totalQueries = numThreads * queriesPerThread;
+
+            if (jobCancelled()) {
+                cout << "Tes stres dibatalkan." << endl;
+                writeLog("Tes stres dibatalkan setelah " + to_string(duration) + " ms.");
+                return false;
+            }
+            cout << "Tes stres selesai." << endl;
+            cout << "Total Query: " << totalQueries << endl;
+            cout << "Durasi: " << duration << " ms" << endl;
+            if (duration > 0) {
+                 cout << "QPS (Queries Per Second): " << (totalQueries * 1000.0 / duration) << endl;
+            }
+            writeLog("Melakukan tes stres: " + to_string(totalQueries) + " queries selesai dalam " + to_string(duration) + " ms.");
+            return true;
+        } catch (exception& e) {
+            cerr << "Error tes stres: " << e.what() << endl;
+            writeLog(string("Error tes stres: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Mengubah tabel menjadi PARTITION BY RANGE COLUMNS(timeColumn) per hari/bulan,
+     * mulai dari periode data tertua hingga 'precreate' periode ke depan, plus partisi
+     * MAXVALUE sebagai jaring pengaman. Operasi ini menyalin ulang tabel (ALTER).
+     * MySQL mensyaratkan setiap PRIMARY/UNIQUE KEY memuat kolom partisi.
+     */
+    bool partitionByRange(const string& tableName, const PartitionOptions& options) {
+        if (!isValidIdentifier(tableName) || !isValidIdentifier(options.timeColumn)) return false; // Keamanan
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+            map<string, string> columns = getTableColumns(tableName);
+            if (columns.find(options.timeColumn) == columns.end()) {
+                cerr << "Error: Kolom waktu '" << options.timeColumn << "' tidak ditemukan di tabel '" << tableName << "'." << endl;
+                return false;
+            }
+            vector<PartitionInfo> parts;
+            string method, expression;
+            if (!loadPartitionsUnlocked(tableName, parts, method, expression)) return false;
+            if (!parts.empty()) {
+                cerr << "Tabel '" << tableName << "' sudah dipartisi (" << method << "). Gunakan pemeliharaan partisi." << endl;
+                return false;
+            }
+
+            // Setiap PRIMARY/UNIQUE KEY harus memuat kolom waktu
+            map<string, vector<string>> uniqueKeys;
+            {
+                unique_ptr<sql::Statement> stmt(conn->createStatement());
+                unique_ptr<sql::ResultSet> res(stmt->executeQuery("SHOW KEYS FROM `" + tableName + "` WHERE Non_unique = 0"));
+                while (res->next()) uniqueKeys[res->getString("Key_name")].push_back(res->getString("Column_name"));
+            }
+            for (const auto& [key, cols] : uniqueKeys) {
+                if (find(cols.begin(), cols.end(), options.timeColumn) != cols.end()) continue;
+                string list;
+                for (const string& c : cols) list += (list.empty() ? "`" : ", `") + c + "`";
+                cerr << "Error: Key '" << key << "' (" << list << ") tidak memuat '" << options.timeColumn << "'." << endl;
+                if (key == "PRIMARY") {
+                    cerr << "Ubah dulu, mis.: ALTER TABLE `" << tableName << "` DROP PRIMARY KEY, ADD PRIMARY KEY ("
+                         << list << ", `" << options.timeColumn << "`);" << endl;
+                }
+                return false;
+            }
+
+            CivilDate today, first;
+            if (!serverTodayUnlocked(today)) return false;
+            first = today;
+            {
+                unique_ptr<sql::Statement> stmt(conn->createStatement());
+                unique_ptr<sql::ResultSet> res(stmt->executeQuery(
+                    "SELECT DATE_FORMAT(MIN(`" + options.timeColumn + "`), '%Y-%m-%d') FROM `" + tableName + "`"));
+                if (res->next() && !res->isNull(1)) parseCivilDate(res->getString(1), first);
+            }
+            CivilDate from = periodStart(first, options.granularity);
+            CivilDate to = addPeriods(periodStart(today, options.granularity), options.granularity, max(0, options.precreate) + 1);
+            int64_t count = options.granularity == PartitionOptions::Granularity::Daily
+                                ? daysFromCivil(to.y, to.m, to.d) - daysFromCivil(from.y, from.m, from.d)
+                                : (to.y * 12 + to.m) - (from.y * 12 + from.m);
+            if (count > 1024) {
+                cerr << "Error: " << count << " partisi akan dibuat (data sejak " << civilDateString(first)
+                     << "). Gunakan granularitas bulanan atau purge data lama dulu." << endl;
+                return false;
+            }
+
+            string sql = "ALTER TABLE `" + tableName + "` PARTITION BY RANGE COLUMNS(`" + options.timeColumn + "`) ("
+                         + partitionDefinitions(from, to, options.granularity)
+                         + ", PARTITION `pmax` VALUES LESS THAN (MAXVALUE))";
+            cout << "Mempartisi '" << tableName << "' menjadi " << count << " partisi + pmax (tabel disalin ulang)..." << endl;
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            stmt->execute(sql);
+            cout << "Tabel '" << tableName << "' dipartisi per " << (options.granularity == PartitionOptions::Granularity::Daily ? "hari" : "bulan")
+                 << " (" << civilDateString(from) << " s/d " << civilDateString(to) << ")." << endl;
+            writeLog("Mempartisi tabel " + tableName + " per periode, " + to_string(count) + " partisi");
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error mempartisi tabel: " << e.what() << endl;
+            writeLog(string("Error mempartisi tabel: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Pemeliharaan rutin tabel berpartisi: menyiapkan partisi hingga 'precreate'
+     * periode ke depan (memecah pmax yang biasanya kosong, atau ADD PARTITION) dan,
+     * jika retain > 0, men-drop partisi yang lebih tua dari 'retain' periode.
+     * Aman dijalankan berulang (mis. dari cron lewat --partition-maintain).
+     */
+    bool maintainPartitions(const string& tableName, const PartitionOptions& options) {
+        if (!isValidIdentifier(tableName) || !isValidIdentifier(options.timeColumn)) return false; // Keamanan
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+            vector<PartitionInfo> parts;
+            string method, expression;
+            if (!loadPartitionsUnlocked(tableName, parts, method, expression)) return false;
+            if (parts.empty() || method != "RANGE COLUMNS" || expression != options.timeColumn) {
+                cerr << "Error: Tabel '" << tableName << "' tidak dipartisi RANGE COLUMNS(" << options.timeColumn
+                     << "). Buat layout partisi terlebih dahulu." << endl;
+                return false;
+            }
+            CivilDate today;
+            if (!serverTodayUnlocked(today)) return false;
+            CivilDate current = periodStart(today, options.granularity);
+
+            // 1. Pre-create: pastikan batas tertinggi mencakup 'precreate' periode ke depan
+            CivilDate target = addPeriods(current, options.granularity, max(0, options.precreate) + 1);
+            CivilDate from = current;
+            bool hasMax = false;
+            for (const PartitionInfo& p : parts) {
+                CivilDate bound;
+                if (p.bound.empty()) hasMax = true;
+                else if (parseCivilDate(p.bound, bound) && daysFromCivil(bound.y, bound.m, bound.d) > daysFromCivil(from.y, from.m, from.d)) from = bound;
+            }
+            int created = 0;
+            if (daysFromCivil(from.y, from.m, from.d) < daysFromCivil(target.y, target.m, target.d)) {
+                string defs = partitionDefinitions(from, target, options.granularity);
+                created = static_cast<int>(count(defs.begin(), defs.end(), '(')); // Satu '(' per VALUES LESS THAN
+                string sql = hasMax
+                    ? "ALTER TABLE `" + tableName + "` REORGANIZE PARTITION `" + parts.back().name + "` INTO (" + defs
+                          + ", PARTITION `" + parts.back().name + "` VALUES LESS THAN (MAXVALUE))"
+                    : "ALTER TABLE `" + tableName + "` ADD PARTITION (" + defs + ")";
+                if (hasMax && parts.back().rows > 0) {
+                    cout << "Peringatan: partisi MAXVALUE berisi ~" << parts.back().rows << " baris; REORGANIZE akan menyalinnya." << endl;
+                }
+                unique_ptr<sql::Statement> stmt(conn->createStatement());
+                stmt->execute(sql);
+            }
+            cout << created << " partisi baru disiapkan hingga " << civilDateString(target) << "." << endl;
+
+            // 2. Retensi: drop partisi yang seluruhnya lebih tua dari 'retain' periode
+            int dropped = 0;
+            if (options.retain > 0) {
+                CivilDate cutoff = addPeriods(current, options.granularity, -options.retain);
+                dropped = dropExpiredPartitionsUnlocked(tableName, options.timeColumn, civilDateString(cutoff) + " 00:00:00");
+                if (dropped < 0) return false;
+            }
+            writeLog("Pemeliharaan partisi " + tableName + ": +" + to_string(created) + " / -" + to_string(dropped));
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error pemeliharaan partisi: " << e.what() << endl;
+            writeLog(string("Error pemeliharaan partisi: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Laporan partisi: nama, batas atas, perkiraan baris dan ukuran (data + indeks).
+     */
+    bool showPartitions(const string& tableName) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        if (currentDB.empty()) {
+            cout << "Pilih database terlebih dahulu!" << endl;
+            return false;
+        }
+        vector<PartitionInfo> parts;
+        string method, expression;
+        if (!loadPartitionsUnlocked(tableName, parts, method, expression)) return false;
+        if (parts.empty()) {
+            cout << "Tabel '" << tableName << "' tidak dipartisi." << endl;
+            return true;
+        }
+        cout << "Partisi '" << tableName << "' (" << method << " " << expression << "):" << endl;
+        cout << left << setw(14) << "Partisi" << setw(24) << "Kurang dari" << right << setw(14) << "~Baris" << setw(14) << "Ukuran" << endl;
+        uint64_t totalRows = 0, totalBytes = 0;
+        for (const PartitionInfo& p : parts) {
+            cout << left << setw(14) << p.name << setw(24) << (p.bound.empty() ? "MAXVALUE" : p.bound)
+                 << right << setw(14) << p.rows << setw(14) << formatBytes(p.bytes) << endl;
+            totalRows += p.rows;
+            totalBytes += p.bytes;
+        }
+        cout << left << setw(38) << "Total" << right << setw(14) << totalRows << setw(14) << formatBytes(totalBytes) << endl;
+        cout << left; // Kembalikan perataan default
+        return true;
+    }
+
+    /**
+     * @brief Mendaftarkan rollup dan membuat tabel agregat menit/jam/hari-nya.
+     * Pendaftaran ulang dengan definisi sama tidak mengubah apa pun (watermark tetap).
+     */
+    bool createRollup(const RollupSpec& spec) {
+        if (!isValidIdentifier(spec.sourceTable) || !isValidIdentifier(spec.timeColumn) || !isValidIdentifier(spec.idColumn)) return false; // Keamanan
+        for (const string& c : spec.groupColumns) if (!isValidIdentifier(c)) return false;
+        for (const string& c : spec.measures) if (!isValidIdentifier(c)) return false;
+        if (spec.measures.empty()) {
+            cerr << "Error: Rollup membutuhkan minimal satu kolom ukuran." << endl;
+            return false;
+        }
+        if (rollupTableName(spec.sourceTable, "minute").length() > 64) {
+            cerr << "Error: Nama tabel '" << spec.sourceTable << "' terlalu panjang untuk nama tabel rollup." << endl;
+            return false;
+        }
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+            map<string, pair<string, bool>> columns; // nama -> (tipe, nullable)
+            {
+                unique_ptr<sql::Statement> stmt(conn->createStatement());
+                unique_ptr<sql::ResultSet> res(stmt->executeQuery("SHOW COLUMNS FROM `" + spec.sourceTable + "`"));
+                while (res->next()) columns[res->getString("Field")] = {res->getString("Type"), res->getString("Null") == "YES"};
+            }
+            vector<string> required = {spec.timeColumn, spec.idColumn};
+            required.insert(required.end(), spec.groupColumns.begin(), spec.groupColumns.end());
+            required.insert(required.end(), spec.measures.begin(), spec.measures.end());
+            for (const string& c : required) {
+                if (columns.find(c) == columns.end()) {
+                    cerr << "Error: Kolom '" << c << "' tidak ditemukan di tabel '" << spec.sourceTable << "'." << endl;
+                    return false;
+                }
+            }
+            for (const string& g : spec.groupColumns) {
+                if (columns[g].second) {
+                    cerr << "Error: Kolom grup '" << g << "' boleh NULL; rollup membutuhkan kolom grup NOT NULL." << endl;
+                    return false;
+                }
+            }
+
+            ensureRollupRegistryUnlocked();
+            vector<RollupSpec> existing = loadRollupsUnlocked(spec.sourceTable);
+            if (!existing.empty()) {
+                const RollupSpec& e = existing.front();
+                if (e.timeColumn == spec.timeColumn && e.idColumn == spec.idColumn
+                    && e.groupColumns == spec.groupColumns && e.measures == spec.measures) {
+                    cout << "Rollup untuk '" << spec.sourceTable << "' sudah terdaftar." << endl;
+                    return true;
+                }
+                cerr << "Error: Rollup '" << spec.sourceTable << "' sudah terdaftar dengan definisi lain (ukuran: "
+                     << joinList(e.measures, ", ") << "). Hapus baris registri dan tabel _dbm_rollup_"
+                     << spec.sourceTable << "_* untuk membangun ulang." << endl;
+                return false;
+            }
+
+            unique_ptr<sql::Statement> stmt(conn->createStatement());
+            for (const char* granularity : ROLLUP_GRANULARITIES) {
+                string sql = "CREATE TABLE IF NOT EXISTS `" + rollupTableName(spec.sourceTable, granularity) + "` (`bucket` DATETIME NOT NULL";
+                string key = "`bucket`";
+                for (const string& g : spec.groupColumns) {
+                    sql += ", `" + g + "` " + columns[g].first + " NOT NULL";
+                    key += ", `" + g + "`";
+                }
+                sql += ", `row_count` BIGINT UNSIGNED NOT NULL";
+                for (const string& m : spec.measures) {
+                    sql += ", `" + m + "_count` BIGINT UNSIGNED NOT NULL, `" + m + "_sum` DOUBLE NOT NULL, `"
+                           + m + "_min` DOUBLE NULL, `" + m + "_max` DOUBLE NULL";
+                }
+                stmt->execute(sql + ", PRIMARY KEY (" + key + "))");
+            }
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+                "INSERT INTO `_dbm_rollups` (`source_table`, `time_column`, `id_column`, `group_columns`, `measures`) VALUES (?, ?, ?, ?, ?)"));
+            pstmt->setString(1, spec.sourceTable);
+            pstmt->setString(2, spec.timeColumn);
+            pstmt->setString(3, spec.idColumn);
+            pstmt->setString(4, joinList(spec.groupColumns));
+            pstmt->setString(5, joinList(spec.measures));
+            pstmt->executeUpdate();
+            cout << "Rollup menit/jam/hari untuk '" << spec.sourceTable << "' dibuat. Jalankan refresh untuk melipat data yang ada." << endl;
+            writeLog("Membuat rollup untuk tabel: " + spec.sourceTable);
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error membuat rollup: " << e.what() << endl;
+            writeLog(string("Error membuat rollup: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Melipat baris baru (id > watermark) ke semua tabel rollup terdaftar,
+     * atau hanya rollup milik sourceTable. Setiap rentang 'foldIds' id dilipat ke
+     * ketiga granularitas dan watermark dimajukan dalam satu transaksi; watermark
+     * dikunci (FOR UPDATE) sehingga beberapa proses refresh tidak melipat dua kali.
+     * Transaksi sengaja pendek karena INSERT ... SELECT mengunci rentang sumber yang dibaca.
+     * Baris sumber yang diubah/dihapus setelah terlipat tidak dikoreksi.
+     */
+    bool refreshRollups(const string& sourceTable = "", const RollupOptions& options = RollupOptions()) {
+        if (!sourceTable.empty() && !isValidIdentifier(sourceTable)) return false; // Keamanan
+
+        static MetricCounter& foldedTotal = metrics().counter("dbm_rollup_rows_folded_total", "Baris sumber yang dilipat ke tabel rollup");
+        static MetricHistogram& foldMs = metrics().histogram("dbm_rollup_fold_ms", "Durasi satu transaksi lipat rollup (ms)",
+                                                             {5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000});
+
+        vector<RollupSpec> specs;
+        try {
+            lock_guard<TracedMutex> lock(dbMutex);
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+            specs = loadRollupsUnlocked(sourceTable);
+        } catch (sql::SQLException& e) {
+            cerr << "Error membaca registri rollup: " << e.what() << endl;
+            writeLog(string("Error registri rollup: ") + e.what());
+            return false;
+        }
+
+        for (const RollupSpec& spec : specs) {
+            uint64_t maxId = 0, folded = 0;
+            try {
+                lock_guard<TracedMutex> lock(dbMutex);
+                unique_ptr<sql::Statement> stmt(conn->createStatement());
+                unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT MAX(`" + spec.idColumn + "`) FROM `" + spec.sourceTable + "`"));
+                if (res->next() && !res->isNull(1)) maxId = res->getUInt64(1);
+            } catch (sql::SQLException& e) {
+                cerr << "Error membaca sumber rollup '" << spec.sourceTable << "': " << e.what() << endl;
+                writeLog(string("Error sumber rollup: ") + e.what());
+                return false;
+            }
+            if (options.settleMs > 0) this_thread::sleep_for(chrono::milliseconds(options.settleMs));
+
+            while (!jobCancelled()) {
+                lock_guard<TracedMutex> lock(dbMutex);
+                auto start = chrono::steady_clock::now();
+                try {
+                    conn->setAutoCommit(false);
+                    uint64_t lo = 0;
+                    {
+                        unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+                            "SELECT `last_id` FROM `_dbm_rollups` WHERE `source_table` = ? FOR UPDATE"));
+                        pstmt->setString(1, spec.sourceTable);
+                        unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+                        if (res->next()) lo = res->getUInt64(1);
+                    }
+                    if (lo >= maxId) {
+                        conn->commit();
+                        conn->setAutoCommit(true);
+                        break;
+                    }
+                    uint64_t hi = maxId - lo > options.foldIds ? lo + max<uint64_t>(1, options.foldIds) : maxId;
+                    uint64_t rows = 0;
+                    {
+                        unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+                            "SELECT COUNT(*) FROM `" + spec.sourceTable + "` WHERE `" + spec.idColumn + "` > ? AND `"
+                            + spec.idColumn + "` <= ? AND `" + spec.timeColumn + "` IS NOT NULL"));
+                        pstmt->setUInt64(1, lo);
+                        pstmt->setUInt64(2, hi);
+                        unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+                        if (res->next()) rows = res->getUInt64(1);
+                    }
+                    if (rows > 0) {
+                        for (const char* granularity : ROLLUP_GRANULARITIES) {
+                            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(rollupFoldSQL(spec, granularity)));
+                            pstmt->setUInt64(1, lo);
+                            pstmt->setUInt64(2, hi);
+                            pstmt->executeUpdate();
+                        }
+                    }
+                    unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+                        "UPDATE `_dbm_rollups` SET `last_id` = ?, `rows_folded` = `rows_folded` + ? WHERE `source_table` = ?"));
+                    pstmt->setUInt64(1, hi);
+                    pstmt->setUInt64(2, rows);
+                    pstmt->setString(3, spec.sourceTable);
+                    pstmt->executeUpdate();
+                    if (rows > 0) {
+                        for (const char* granularity : ROLLUP_GRANULARITIES) invalidateCachedTable(rollupTableName(spec.sourceTable, granularity));
+                    }
+                    conn->commit();
+                    conn->setAutoCommit(true);
+                    folded += rows;
+                    foldedTotal.add(rows);
+                    foldMs.observe(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+                    jobAddProgress(rows);
+                } catch (sql::SQLException& e) {
+                    try { conn->rollback(); } catch (sql::SQLException&) {}
+                    try { conn->setAutoCommit(true); } catch (sql::SQLException&) {}
+                    cerr << "Error melipat rollup '" << spec.sourceTable << "': " << e.what() << endl;
+                    writeLog(string("Error melipat rollup (") + spec.sourceTable + "): " + e.what());
+                    return false;
+                }
+            }
+            if (folded > 0) writeLog("Rollup " + spec.sourceTable + ": " + to_string(folded) + " baris dilipat");
+        }
+        return !jobCancelled();
+    }
+
+    /**
+     * @brief Menampilkan 'limit' bucket terbaru dari tabel rollup satu granularitas
+     * ("minute", "hour", "day") dengan rata-rata dihitung dari sum / count.
+     * 'groupBy' = subset groupColumns yang dipertahankan (kosong = semua); kolom
+     * grup lain dijumlahkan, mis. usage per "category" saja = total layar per kategori.
+     */
+    bool showRollup(const string& sourceTable, const string& granularity, int limit = 24, const vector<string>& groupBy = {}) {
+        if (!isValidIdentifier(sourceTable)) return false; // Keamanan
+        if (granularity != "minute" && granularity != "hour" && granularity != "day") {
+            cerr << "Error: Granularitas harus minute, hour, atau day." << endl;
+            return false;
+        }
+
+        lock_guard<TracedMutex> lock(dbMutex);
+        try {
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+            vector<RollupSpec> specs = loadRollupsUnlocked(sourceTable);
+            if (specs.empty()) {
+                cout << "Belum ada rollup untuk '" << sourceTable << "'." << endl;
+                return false;
+            }
+            const RollupSpec& spec = specs.front();
+            for (const string& g : groupBy) {
+                if (find(spec.groupColumns.begin(), spec.groupColumns.end(), g) == spec.groupColumns.end()) {
+                    cerr << "Error: '" << g << "' bukan kolom grup rollup (" << joinList(spec.groupColumns, ", ") << ")." << endl;
+                    return false;
+                }
+            }
+            const vector<string>& groups = groupBy.empty() ? spec.groupColumns : groupBy;
+            string sql = "SELECT `bucket`", groupSql = "`bucket`";
+            for (const string& g : groups) {
+                sql += ", `" + g + "`";
+                groupSql += ", `" + g + "`";
+            }
+            sql += ", SUM(`row_count`) AS `row_count`";
+            for (const string& m : spec.measures) {
+                sql += ", SUM(`" + m + "_sum`) AS `" + m + "_sum`, ROUND(SUM(`" + m + "_sum`) / NULLIF(SUM(`" + m + "_count`), 0), 3) AS `"
+                     + m + "_avg`, MIN(`" + m + "_min`) AS `" + m + "_min`, MAX(`" + m + "_max`) AS `" + m + "_max`";
+            }
+            sql += " FROM `" + rollupTableName(sourceTable, granularity) + "` GROUP BY " + groupSql + " ORDER BY `bucket` DESC LIMIT ?";
+            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(sql));
+            pstmt->setInt(1, max(1, limit));
+            unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+
+            cout << "\nRollup '" << sourceTable << "' per " << granularity << ":" << endl;
+            sql::ResultSetMetaData* meta = res->getMetaData();
+            int cols = meta->getColumnCount();
+            int totalWidth = 0;
+            vector<int> colWidths;
+            for (int i = 1; i <= cols; ++i) {
+                int width = max((int)meta->getColumnName(i).length(), i == 1 ? 19 : 10);
+                colWidths.push_back(width);
+                cout << left << setw(width) << meta->getColumnName(i) << " | ";
+                totalWidth += width + 3;
+            }
+            cout << endl << string(totalWidth, '-') << endl;
+            while (res->next()) {
+                for (int i = 1; i <= cols; ++i) {
+                    cout << left << setw(colWidths[i-1]) << (res->isNull(i) ? "NULL" : string(res->getString(i))) << " | ";
+                }
+                cout << endl;
+            }
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error membaca rollup: " << e.what() << endl;
+            writeLog(string("Error membaca rollup: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Purge retensi bertahap: menghapus baris dengan timeColumn < cutoff
+     * per potongan berurutan primary key, masing-masing transaksi autocommit
+     * sendiri (undo kecil, kunci singkat). dbMutex hanya dipegang selama satu
+     * statement, dengan jeda antar potongan. Ukuran potongan menyesuaikan durasi
+     * DELETE terhadap targetChunkMs; lock wait/deadlock memperkecil potongan
+     * lalu mencoba ulang. Dapat dibatalkan lewat job.
+     */
+    bool purgeOlderThan(const string& tableName, const RetentionOptions& options) {
+        if (!isValidIdentifier(tableName) || !isValidIdentifier(options.timeColumn)) return false; // Keamanan
+
+        static MetricCounter& deletedTotal = metrics().counter("dbm_retention_rows_deleted_total", "Baris yang dihapus oleh purge retensi");
+        static MetricHistogram& chunkMs = metrics().histogram("dbm_retention_chunk_ms", "Durasi satu DELETE potongan retensi (ms)",
+                                                              {5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000});
+        static MetricGauge& chunkGauge = metrics().gauge("dbm_retention_chunk_rows", "Ukuran potongan retensi saat ini");
+
+        string cutoff = options.cutoff;
+        vector<string> pk;
+        {
+            lock_guard<TracedMutex> lock(dbMutex);
+            if (currentDB.empty()) {
+                cout << "Pilih database terlebih dahulu!" << endl;
+                return false;
+            }
+            map<string, string> columns = getTableColumns(tableName);
+            if (columns.empty()) {
+                cerr << "Error: Tabel '" << tableName << "' tidak ditemukan." << endl;
+                return false;
+            }
+            if (columns.find(options.timeColumn) == columns.end()) {
+                cerr << "Error: Kolom waktu '" << options.timeColumn << "' tidak ditemukan di tabel." << endl;
+                return false;
+            }
+            pk = getPrimaryKeyUnlocked(tableName);
+            if (pk.empty()) {
+                cerr << "Error: Tabel '" << tableName << "' tidak memiliki PRIMARY KEY; purge bertahap membutuhkannya." << endl;
+                return false;
+            }
+            if (cutoff.empty()) {
+                try {
+                    // Cutoff dibekukan sekali di awal dengan jam server
+                    unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(
+                        "SELECT DATE_FORMAT(NOW() - INTERVAL ? DAY, '%Y-%m-%d %H:%i:%s')"));
+                    pstmt->setInt(1, options.keepDays);
+                    unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+                    if (res->next()) cutoff = res->getString(1);
+                } catch (sql::SQLException& e) {
+                    cerr << "Error menghitung cutoff retensi: " << e.what() << endl;
+                    writeLog(string("Error cutoff retensi: ") + e.what());
+                    return false;
+                }
+            }
+            // Tabel berpartisi per waktu: partisi yang seluruhnya < cutoff di-drop seketika,
+            // sisanya (partisi batas) dihapus bertahap di bawah.
+            if (!cutoff.empty() && dropExpiredPartitionsUnlocked(tableName, options.timeColumn, cutoff) < 0) return false;
+        }
+        if (cutoff.empty()) return false;
+
+        const string table = "`" + tableName + "`";
+        const string timeCol = "`" + options.timeColumn + "`";
+        // Jalan per rentang kolom PK terdepan, tanpa memindai ulang baris yang sudah terhapus.
+        // Untuk PK komposit (mis. id, timestamp) satu potongan bisa sedikit melebar bila nilai terdepan berulang.
+        const string pkCol = "`" + pk[0] + "`";
+
+        size_t minChunk = max<size_t>(1, options.minChunkRows);
+        size_t maxChunk = max(minChunk, options.maxChunkRows);
+        size_t chunk = min(maxChunk, max(minChunk, options.chunkRows));
+        optional<string> lowerKey; // Nilai PK terdepan terakhir yang sudah diproses
+        uint64_t deleted = 0, chunks = 0;
+        int retries = 0;
+        double totalMs = 0;
+        auto started = chrono::steady_clock::now();
+
+        cout << "Purge '" << tableName << "': " << options.timeColumn << " < " << cutoff << " (per rentang " << pk[0] << ")" << endl;
+        writeLog("Mulai purge retensi " + tableName + " < " + cutoff);
+        while (!jobCancelled()) {
+            uint64_t affected = 0;
+            bool finished = false;
+            auto t0 = chrono::steady_clock::now();
+            try {
+                lock_guard<TracedMutex> lock(dbMutex);
+                // Batas atas potongan: PK ke-'chunk' yang memenuhi cutoff setelah lowerKey
+                string boundarySql = "SELECT " + pkCol + " FROM " + table + " WHERE " + timeCol + " < ?"
+                                     + (lowerKey ? " AND " + pkCol + " > ?" : string())
+                                     + " ORDER BY " + pkCol + " LIMIT 1 OFFSET ?";
+                unique_ptr<sql::PreparedStatement> boundary(conn->prepareStatement(boundarySql));
+                int idx = 1;
+                boundary->setString(idx++, cutoff);
+                if (lowerKey) boundary->setString(idx++, *lowerKey);
+                boundary->setInt(idx++, static_cast<int>(chunk - 1));
+                unique_ptr<sql::ResultSet> res(boundary->executeQuery());
+                optional<string> upperKey;
+                if (res->next()) upperKey = string(res->getString(1));
+
+                string deleteSql = "DELETE FROM " + table + " WHERE " + timeCol + " < ?"
+                                   + (lowerKey ? " AND " + pkCol + " > ?" : string())
+                                   + (upperKey ? " AND " + pkCol + " <= ?" : string());
+                unique_ptr<sql::PreparedStatement> del(conn->prepareStatement(deleteSql));
+                idx = 1;
+                del->setString(idx++, cutoff);
+                if (lowerKey) del->setString(idx++, *lowerKey);
+                if (upperKey) del->setString(idx++, *upperKey);
+                affected = del->executeUpdate();
+                if (affected > 0) invalidateCachedTable(tableName);
+                if (upperKey) lowerKey = upperKey;
+                else finished = true; // Kurang dari satu potongan tersisa: sudah terhapus semua
+            } catch (sql::SQLException& e) {
+                // 1205 lock wait timeout, 1213 deadlock: kecilkan potongan lalu coba lagi
+                int code = e.getErrorCode();
+                if ((code == 1205 || code == 1213) && ++retries <= 5) {
+                    chunk = max(minChunk, chunk / 2);
+                    writeLog("Purge retensi " + tableName + ": konflik kunci, potongan diperkecil ke " + to_string(chunk));
+                    this_thread::sleep_for(chrono::milliseconds(max(options.pauseMs, 100)));
+                    continue;
+                }
+                cerr << "Error purge retensi: " << e.what() << endl;
+                writeLog(string("Error purge retensi (") + tableName + "): " + e.what());
+                return false;
+            }
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            retries = 0;
+            chunks++;
+            deleted += affected;
+            totalMs += ms;
+            deletedTotal.add(affected);
+            chunkMs.observe(ms);
+            jobAddProgress(affected);
+            if (finished) break;
+
+            // Adaptasi: skala ukuran potongan menuju targetChunkMs (maks. 2x per langkah)
+            double factor = ms > 0 ? options.targetChunkMs / ms : 2.0;
+            factor = min(2.0, max(0.5, factor));
+            chunk = min(maxChunk, max(minChunk, static_cast<size_t>(chunk * factor)));
+            chunkGauge.set(static_cast<int64_t>(chunk));
+            if (options.pauseMs > 0) this_thread::sleep_for(chrono::milliseconds(options.pauseMs));
+        }
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        ostringstream summary;
+        summary << fixed << setprecision(1) << deleted << " baris dihapus dalam " << chunks << " potongan, "
+                << seconds << " s (rata-rata DELETE " << (chunks ? totalMs / chunks : 0.0)
+                << " ms, potongan akhir " << chunk << " baris)";
+        if (jobCancelled()) {
+            cout << "Purge retensi dibatalkan: " << summary.str() << endl;
+            writeLog("Purge retensi dibatalkan " + tableName + ": " + summary.str());
+            return false;
+        }
+        cout << "Purge retensi selesai: " << summary.str() << endl;
+        writeLog("Purge retensi " + tableName + ": " + summary.str());
+        return true;
+    }
+
+    /**
+     * @brief Loop ekspor generik: ambil -> format -> tulis per RowBatch; batch dan
+     * buffer keluaran dipakai ulang. False jika job dibatalkan.
+     */
+    static bool writeRowsCSV(sql::ResultSet* res, size_t cols, ostream& csvFile) {
+        RowBatch rows(cols);
+        string out;
+        while (fetchRowBatch(res, rows, EXPORT_BATCH_ROWS, "")) {
+            if (jobCancelled()) return false;
+            out.clear();
+            appendCSVRows(rows, out);
+            csvFile.write(out.data(), (streamsize)out.size());
+            jobAddProgress(rows.size(), out.size());
+        }
+        return true;
+    }
+
+    /**
+     * @brief Loop ekspor bertipe (kolom = recordColumnNames): nilai dibaca langsung
+     * ke Record lalu ditulis dengan appendRecordCSV, tanpa salinan teks per field.
+     */
+    template <typename Record>
+    static bool writeRecordsCSV(sql::ResultSet* res, ostream& csvFile) {
+        Record rec;
+        string out;
+        size_t rows = 0;
+        auto flush = [&]() {
+            csvFile.write(out.data(), (streamsize)out.size());
+            jobAddProgress(rows, out.size());
+            out.clear();
+            rows = 0;
+        };
+        while (res->next()) {
+            readRecordRow(res, rec);
+            appendRecordCSV(out, rec);
+            if (++rows < EXPORT_BATCH_ROWS) continue;
+            if (jobCancelled()) return false;
+            flush();
+        }
+        flush();
+        return true;
+    }
+
+    /**
+     * @brief Mengekspor tabel ke CSV dengan proyeksi kolom dan filter opsional.
+     * Kolom dan filter divalidasi terhadap skema tabel, lalu dieksekusi sebagai
+     * prepared statement sehingga server hanya memindai dan mengirim baris yang diminta.
+     * Proyeksi yang persis kolom record sensor_data/usage_events memakai writeRecordsCSV.
+     * @param selectColumns Kolom yang diekspor (kosong = semua kolom).
+     * @param filters Predikat WHERE (digabung dengan AND).
+     */
+    bool exportToCSV(const string& tableName, const string& filePath,
+                     const vector<string>& selectColumns = {}, const vector<ExportFilter>& filters = {}) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+        if (filePath.empty()) {
+            cout << "Path file kosong." << endl;
+            return false;
+        }
+
+        MemoryScope memory("export_csv");
+        CompressedOFStream csvFile(filePath);
+        if (!csvFile.is_open()) {
+            cout << "Gagal membuka file CSV: " << filePath << endl;
+            return false;
+        }
+        try {
+            unique_ptr<sql::PreparedStatement> pstmt;
+            unique_ptr<sql::ResultSet> res;
+            {
+                lock_guard<TracedMutex> lock(dbMutex);
+                if (currentDB.empty()) {
+                    cout << "Pilih database terlebih dahulu!" << endl;
+                    csvFile.close();
+                    return false;
+                }
+
+                string selectList = "*";
+                string whereClause;
+                vector<string> params;
+                if (!selectColumns.empty() || !filters.empty()) {
+                    map<string, string> actualColumns = getTableColumns(tableName);
+                    if (actualColumns.empty()) {
+                        cerr << "Gagal memverifikasi kolom tabel '" << tableName << "'." << endl;
+                        csvFile.close();
+                        return false;
+                    }
+                    if (!selectColumns.empty()) {
+                        selectList.clear();
+                        for (size_t i = 0; i < selectColumns.size(); ++i) {
+                            if (!isValidIdentifier(selectColumns[i])) { // Keamanan
+                                csvFile.close();
+                                return false;
+                            }
+                            if (actualColumns.find(selectColumns[i]) == actualColumns.end()) {
+                                cerr << "Error: Kolom '" << selectColumns[i] << "' tidak ditemukan di tabel '" << tableName << "'." << endl;
+                                csvFile.close();
+                                return false;
+                            }
+                            selectList += "`" + selectColumns[i] + "`";
+                            if (i < selectColumns.size() - 1) selectList += ",";
+                        }
+                    }
+                    if (!buildFilterClause(filters, actualColumns, whereClause, params)) {
+                        csvFile.close();
+                        return false;
+                    }
+                }
+
+                // Aman karena 'tableName' dan semua kolom sudah divalidasi
+                pstmt.reset(conn->prepareStatement("SELECT " + selectList + " FROM `" + tableName + "`" + whereClause));
+                for (size_t i = 0; i < params.size(); ++i) {
+                    pstmt->setString(i + 1, params[i]);
+                }
+                res.reset(pstmt->executeQuery());
+            } 
+            sql::ResultSetMetaData* meta = res->getMetaData();
+            int cols = meta->getColumnCount();
+            vector<string> columnNames;
+            for (int i = 1; i <= cols; ++i) {
+                columnNames.push_back(meta->getColumnName(i));
+                csvFile << columnNames.back();
+                if (i < cols) csvFile << ",";
+            }
+            csvFile << "\n";
+            bool completed;
+            switch (csvRecordKind(tableName, columnNames)) {
+                case CSVRecordKind::Sensor: completed = writeRecordsCSV<SensorReading>(res.get(), csvFile); break;
+                case CSVRecordKind::Usage: completed = writeRecordsCSV<AppUsage>(res.get(), csvFile); break;
+                default: completed = writeRowsCSV(res.get(), (size_t)cols, csvFile); break;
+            }
+            if (!completed) {
+                cout << "Ekspor dibatalkan." << endl;
+                writeLog("Ekspor dibatalkan: " + tableName);
+                csvFile.close();
+                return false;
+            }
+            if (!csvFile.close()) {
+                cerr << "Gagal menulis file CSV: " << filePath << endl;
+                writeLog("Gagal menulis file CSV: " + filePath);
+                return false;
+            }
+            cout << "Data dari '" << tableName << "' diekspor ke " << filePath << "." << endl;
+            cout << MemoryScope::summary(memory.usage()) << endl;
+            writeLog("Mengekspor tabel: " + tableName + " ke CSV: " + filePath +
+                     " (kolom: " + (selectColumns.empty() ? string("semua") : to_string(selectColumns.size())) +
+                     ", filter: " + to_string(filters.size()) + ")");
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error mengekspor ke CSV: " << e.what() << endl;
+            writeLog(string("Error mengekspor ke CSV: ") + e.what());
+            csvFile.close();
+            return false;
+        }
+    }
+
+    /**
+     * @brief Mengimpor CSV dengan commit per batch dan checkpoint yang dapat dilanjutkan.
+     * Jika impor sebelumnya terhenti, impor ulang file yang sama (identitas cocok)
+     * dilanjutkan dari batch terakhir yang sudah di-commit tanpa menggandakan baris.
+     */
+    bool importFromCSV(const string& tableName, const string& filePath, const ImportOptions& options = ImportOptions()) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+        if (filePath.empty()) {
+            cout << "Path file kosong." << endl;
+            return false;
+        }
 
-            while (res->next()) {
-                string colName = res->getString("Field");
-                string extra = res->getString("Extra");
-                if (extra.find("auto_increment") == string::npos) {
-                    columns.push_back(colName);
-                    cout << colName << " (" << res->getString("Type") << "): ";
-                    string val;
-                    if (cin.peek() == '\n') cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                    getline(cin, val);
-                    
-                    values.push_back(val);
+        MemoryScope memory("import_csv");
+        CompressedIFStream csvFile(filePath);
+        if (!csvFile.is_open()) {
+            cout << "Gagal membuka file CSV: " << filePath << endl;
+            return false;
+        }
+        string line;
+        try {
+            if (!getline(csvFile, line)) {
+                cout << "File CSV kosong atau gagal dibaca." << endl;
+                csvFile.close();
+                return false;
+            }
+            vector<string> columns = parseCSVLine(line);
+            if (columns.empty()) {
+                cout << "Header CSV kosong." << endl;
+                csvFile.close();
+                return false;
+            }
+
+            string query;
+            MergeOptions merge = options.merge;
+            if (!buildCSVInsertQuery(tableName, columns, query, merge)) {
+                csvFile.close();
+                return false;
+            }
+            unique_ptr<RowDeduper> deduper;
+            if (!options.dedupe.keyColumns.empty()) {
+                deduper = make_unique<RowDeduper>(options.dedupe, columns);
+                if (!deduper->missingColumn().empty()) {
+                    cerr << "Error: Kolom dedupe '" << deduper->missingColumn() << "' tidak ada di header CSV." << endl;
+                    csvFile.close();
+                    return false;
                 }
             }
 
-            if (columns.empty()) {
-                cout << "Tidak ditemukan kolom untuk dimasukkan (mungkin hanya auto_increment?).\n";
+            unique_ptr<sql::PreparedStatement> pstmt;
+            ImportCheckpoint cp;
+            bool resumed = false;
+            if (!readFileIdentity(filePath, cp)) {
+                cerr << "Gagal membaca identitas file untuk checkpoint: " << filePath << endl;
+                csvFile.close();
                 return false;
             }
+            {
+                lock_guard<TracedMutex> lock(dbMutex);
+                pstmt.reset(conn->prepareStatement(query));
+                ensureCheckpointTableUnlocked();
+                if (!options.restart) resumed = loadCheckpointUnlocked(tableName, cp);
+            }
+            if (resumed && cp.completed) {
+                cout << "File ini sudah pernah diimpor penuh ke '" << tableName << "' (" << cp.rowsCommitted
+                     << " baris). Pilih mode 'mulai ulang' untuk mengimpor lagi." << endl;
+                writeLog("Impor CSV dilewati (checkpoint selesai): " + tableName + " dari " + filePath);
+                csvFile.close();
+                return true;
+            }
+            if (resumed && merge.mode == MergeMode::Staging) {
+                cout << "Mode staging tidak melanjutkan per batch; file dimuat ulang dari awal." << endl;
+                resumed = false;
+            }
+            if (!resumed) {
+                cp.byteOffset = -1;
+                cp.lineNumber = 0;
+                cp.rowsCommitted = 0;
+                cp.completed = false;
+            }
 
-            string query = "INSERT INTO `" + tableName + "` (";
-            string valuePlaceholders = ") VALUES (";
-            for (size_t i = 0; i < columns.size(); ++i) {
-                query += "`" + columns[i] + "`";
-                valuePlaceholders += "?";
-                if (i < columns.size() - 1) {
-                    query += ",";
-                    valuePlaceholders += ",";
+            bool seekable = csvFile.compression() == Compression::None;
+            if (seekable) jobSetTotal(0, cp.fileSize);
+
+            uint64_t lineCount = 0;
+            if (merge.mode == MergeMode::Staging) {
+                bool ok = importCSVViaStaging(tableName, csvFile, columns, cp, options, merge, lineCount, deduper.get());
+                csvFile.close();
+                if (ok) writeLog("Impor CSV (staging + merge) ke tabel: " + tableName + " dari " + filePath + " (" + to_string(cp.rowsCommitted) + " baris)");
+                return ok;
+            }
+            if (resumed) {
+                if (seekable && cp.byteOffset >= 0) {
+                    csvFile.seekg(cp.byteOffset);
+                    lineCount = cp.lineNumber;
+                    jobAddProgress(0, (uint64_t)cp.byteOffset);
+                } else {
+                    while (lineCount < cp.lineNumber && getline(csvFile, line)) lineCount++;
                 }
+                cout << "Melanjutkan impor dari checkpoint: baris " << lineCount << ", " << cp.rowsCommitted
+                     << " baris sudah di-commit sebelumnya." << endl;
+                writeLog("Melanjutkan impor CSV dari baris " + to_string(lineCount) + ": " + filePath);
             }
-            query += valuePlaceholders + ");";
-            
-            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(query));
-            for (size_t i = 0; i < values.size(); ++i) {
-                if (values[i] == "NULL" || values[i] == "null") {
-                    pstmt->setNull(i + 1, sql::DataType::VARCHAR); // Lebih baik setNull
+
+            size_t batchSize = max<size_t>(1, options.batchSize);
+            RowBatch batch(columns.size()); // Dipakai ulang antar batch: arena tidak dialokasikan ulang
+            bool cancelled = false;
+            bool eof = false;
+            double sendSeconds = 0;
+            uint64_t rowsSent = 0;
+            TraceZone readZone; // Satu zona per batch; waktu baca/parse per baris dijumlahkan sebagai argumen
+            int64_t readUs = 0, parseUs = 0;
+            while (!eof) {
+                if (jobCancelled()) {
+                    cancelled = true;
+                }
+                if (!readZone.active()) readZone.begin("import.read_parse", "import");
+                int64_t t0 = readZone.active() ? tracer().nowUs() : 0;
+                if (!cancelled && getline(csvFile, line)) {
+                    lineCount++;
+                    jobAddProgress(0, line.size() + 1);
+                    if (readZone.active()) readUs += tracer().nowUs() - t0;
+                    if (!line.empty() && line.find_first_not_of(" \t\r\n") != string::npos) {
+                        t0 = readZone.active() ? tracer().nowUs() : 0;
+                        size_t fields = batch.appendCSVLine(line, lineCount);
+                        if (readZone.active()) parseUs += tracer().nowUs() - t0;
+                        if (fields != columns.size()) {
+                            cout << "Peringatan: Melewatkan baris " << lineCount << " (jumlah kolom tidak cocok: " << fields << " vs " << columns.size() << ")" << endl;
+                        } else if (deduper && deduper->seen(batch, batch.size() - 1, line.size() + 1)) {
+                            batch.popRow(); // Duplikat di file ini: tidak dikirim
+                        }
+                    }
+                    if (batch.size() < batchSize) continue;
                 } else {
-                    pstmt->setString(i + 1, values[i]);
+                    eof = true;
+                }
+
+                // Commit batch + checkpoint (posisi setelah baris terakhir yang dibaca)
+                cp.lineNumber = lineCount;
+                cp.byteOffset = -1;
+                if (seekable && !eof) {
+                    streampos pos = csvFile.tellg();
+                    if (pos != streampos(-1)) cp.byteOffset = (int64_t)pos;
+                }
+                cp.completed = eof && !cancelled && !csvFile.hasError();
+                readZone.arg("read_us", readUs);
+                readZone.arg("parse_us", parseUs);
+                readZone.end();
+                readUs = parseUs = 0;
+                auto sendStart = chrono::steady_clock::now();
+                commitImportBatch(pstmt.get(), tableName, batch, cp, columns, merge);
+                sendSeconds += chrono::duration<double>(chrono::steady_clock::now() - sendStart).count();
+                rowsSent += batch.size();
+                batch.clear();
+            }
+            uint64_t successCount = cp.rowsCommitted;
+
+            if (csvFile.hasError()) {
+                cerr << "Peringatan: File terkompresi rusak atau terpotong; impor berhenti pada baris " << lineCount << "." << endl;
+                writeLog("File terkompresi rusak saat impor: " + filePath);
+            }
+            csvFile.close();
+            if (cancelled) {
+                cout << "Impor dibatalkan: " << successCount << " dari " << lineCount << " baris sudah di-commit ke '" << tableName
+                     << "'. Jalankan impor yang sama untuk melanjutkan dari checkpoint." << endl;
+                writeLog("Impor CSV dibatalkan: " + tableName + " dari " + filePath);
+                return false;
+            }
+            cout << "Selesai: " << successCount << " dari " << lineCount << " baris berhasil diimpor ke '" << tableName << "'." << endl;
+            if (deduper) reportDedupe(*deduper, sendSeconds, rowsSent, tableName);
+            cout << MemoryScope::summary(memory.usage()) << endl;
+            writeLog("Impor CSV ke tabel: " + tableName + " dari " + filePath + " (" + to_string(successCount) + " baris)");
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error kritis mengimpor dari CSV: " << e.what() << endl;
+            cerr << "Batch terakhir di-rollback; impor yang sama dapat dilanjutkan dari checkpoint terakhir." << endl;
+            writeLog(string("Error kritis mengimpor dari CSV: ") + e.what());
+            csvFile.close();
+            return false;
+        } catch (exception& e) {
+            cerr << "Error file saat impor CSV: " << e.what() << endl;
+            writeLog(string("Error file saat impor CSV: ") + e.what());
+            csvFile.close();
+            return false;
+        }
+    }
+
+    /**
+     * @brief Mode follow: mengikuti CSV yang terus di-append (mis. Server/sensor_data.csv)
+     * dan memasukkan hanya byte baru ke tabel. Baris dikumpulkan menjadi micro-batch
+     * yang di-flush setiap 'flushRows' baris atau paling lambat 'flushMs' ms setelah
+     * baris pertama masuk. Posisi file disimpan di transaksi yang sama dengan batch
+     * (tabel _dbm_import_checkpoints, kunci "follow:<path>"), jadi restart melanjutkan
+     * tanpa duplikasi. Berjalan sampai job dibatalkan.
+     */
+    bool followCSV(const string& tableName, const string& filePath, const FollowOptions& options = FollowOptions()) {
+        if (!isValidIdentifier(tableName)) return false; // Keamanan
+        if (filePath.empty()) {
+            cout << "Path file kosong." << endl;
+            return false;
+        }
+        if (!currentJob) {
+            cout << "Mode follow berjalan terus-menerus dan harus dijalankan sebagai job background." << endl;
+            return false;
+        }
+
+        MemoryScope memory("follow_csv");
+        try {
+            FileWatcher watcher(filePath);
+            ifstream in;
+            string header;
+            uint64_t headerBytes = 0;
+
+            // 1. Tunggu sampai file ada dan header lengkap tersedia
+            while (true) {
+                if (jobCancelled()) return false;
+                in.open(filePath, ios::binary);
+                if (in.is_open() && getline(in, header) && !in.eof()) {
+                    headerBytes = header.size() + 1;
+                    break;
+                }
+                in.close();
+                in.clear();
+                watcher.wait(500);
+            }
+            vector<string> columns = parseCSVLine(header);
+            string query;
+            if (columns.empty() || !buildCSVInsertQuery(tableName, columns, query)) return false;
+
+            ImportCheckpoint cp;
+            error_code ec;
+            filesystem::path canonical = filesystem::weakly_canonical(filesystem::path(filePath), ec);
+            cp.fileKey = "follow:" + (ec ? filePath : canonical.string());
+            if (cp.fileKey.size() > 255) cp.fileKey = cp.fileKey.substr(cp.fileKey.size() - 255);
+            cp.headHash = fnv1a64(header.data(), header.size());
+
+            unique_ptr<sql::PreparedStatement> pstmt;
+            bool resumed = false;
+            {
+                lock_guard<TracedMutex> lock(dbMutex);
+                pstmt.reset(conn->prepareStatement(query));
+                ensureCheckpointTableUnlocked();
+                resumed = loadCheckpointUnlocked(tableName, cp);
+            }
+            uint64_t fileSize = filesystem::file_size(filePath, ec);
+            if (!resumed || cp.byteOffset < (int64_t)headerBytes || (uint64_t)cp.byteOffset > fileSize) {
+                cp.byteOffset = (int64_t)headerBytes;
+                cp.lineNumber = 1;
+                cp.rowsCommitted = 0;
+            }
+            cout << "Follow '" << filePath << "' -> '" << tableName << "' mulai dari byte " << cp.byteOffset << "." << endl;
+            writeLog("Follow CSV dimulai: " + filePath + " -> " + tableName + " dari byte " + to_string(cp.byteOffset));
+
+            uint64_t readPos = (uint64_t)cp.byteOffset; // posisi byte berikutnya yang belum dibaca
+            uint64_t lineNumber = cp.lineNumber;
+            string carry;                                // record parsial yang belum diakhiri newline
+            RowBatch batch(columns.size());
+            auto firstPending = chrono::steady_clock::now();
+            vector<char> chunk(1 << 20);
+
+            while (true) {
+                bool cancelled = jobCancelled();
+
+                // 2. Baca byte baru (file dipotong/dirotasi -> mulai lagi setelah header)
+                uint64_t size = filesystem::file_size(filePath, ec);
+                if (!ec && size < readPos) {
+                    cout << "File '" << filePath << "' dipotong/dirotasi; mengikuti dari awal." << endl;
+                    writeLog("Follow CSV: file dipotong/dirotasi: " + filePath);
+                    in.close();
+                    in.clear();
+                    in.open(filePath, ios::binary);
+                    readPos = headerBytes;
+                    carry.clear();
+                }
+                while (!cancelled && !ec && size > readPos && in.is_open()) {
+                    in.clear();
+                    in.seekg((streamoff)readPos);
+                    size_t want = (size_t)min<uint64_t>(chunk.size(), size - readPos);
+                    in.read(chunk.data(), (streamsize)want);
+                    size_t got = (size_t)in.gcount();
+                    if (got == 0) break;
+                    readPos += got;
+                    carry.append(chunk.data(), got);
+                    jobAddProgress(0, got);
+
+                    // Pisahkan record lengkap (newline di luar tanda kutip)
+                    size_t start = 0;
+                    bool inQuotes = false;
+                    for (size_t i = 0; i < carry.size(); ++i) {
+                        char c = carry[i];
+                        if (c == '"') inQuotes = !inQuotes;
+                        else if (c == '\n' && !inQuotes) {
+                            string_view record(carry.data() + start, i - start);
+                            start = i + 1;
+                            lineNumber++;
+                            if (record.find_first_not_of(" \t\r\n") == string_view::npos) continue;
+                            bool wasEmpty = batch.empty();
+                            size_t fields = batch.appendCSVLine(record, lineNumber);
+                            if (fields != columns.size()) {
+                                cout << "Peringatan: Melewatkan baris " << lineNumber << " (jumlah kolom tidak cocok: " << fields << " vs " << columns.size() << ")" << endl;
+                                continue;
+                            }
+                            if (wasEmpty) firstPending = chrono::steady_clock::now();
+                        }
+                    }
+                    carry.erase(0, start);
+                    if (batch.size() >= options.flushRows) break;
+                }
+
+                // 3. Flush micro-batch jika penuh, melewati deadline, atau job dibatalkan
+                auto pendingMs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - firstPending).count();
+                if (!batch.empty() && (batch.size() >= options.flushRows || pendingMs >= options.flushMs || cancelled)) {
+                    cp.byteOffset = (int64_t)(readPos - carry.size());
+                    cp.lineNumber = lineNumber;
+                    commitImportBatch(pstmt.get(), tableName, batch, cp, columns);
+                    batch.clear();
+                    memory.publish(); // Job berjalan terus: metrik harus terlihat tanpa menunggu selesai
                 }
+                if (cancelled) break;
+
+                // 4. Tunggu perubahan file (inotify) atau deadline flush berikutnya
+                int timeoutMs = options.flushMs;
+                if (!batch.empty()) timeoutMs = (int)max<int64_t>(0, options.flushMs - pendingMs);
+                if (ec || size <= readPos) watcher.wait(min(timeoutMs, 500));
+            }
+
+            cout << "Follow '" << filePath << "' dihentikan. " << cp.rowsCommitted << " baris tercatat di checkpoint." << endl;
+            writeLog("Follow CSV dihentikan: " + filePath + " (" + to_string(cp.rowsCommitted) + " baris)");
+            return true;
+        } catch (sql::SQLException& e) {
+            cerr << "Error follow CSV: " << e.what() << endl;
+            writeLog(string("Error follow CSV: ") + e.what());
+            return false;
+        } catch (exception& e) {
+            cerr << "Error file saat follow CSV: " << e.what() << endl;
+            writeLog(string("Error file saat follow CSV: ") + e.what());
+            return false;
+        }
+    }
+};
+
+// --- API ASYNC (MULTI-KONEKSI) ---
+
+/**
+ * @struct AsyncResult
+ * Hasil operasi async: status, jumlah baris/byte yang diproses, dan waktu.
+ * 'result' hanya terisi untuk query().
+ */
+struct AsyncResult {
+    bool ok = false;
+    string error;
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    double queueMs = 0;   // menunggu worker/koneksi bebas
+    double elapsedMs = 0; // eksekusi operasi
+    QueryResult result;
+};
+
+/**
+ * @class AsyncDatabase
+ * Lapisan async di atas beberapa DatabaseManager independen (satu koneksi
+ * dan satu dbMutex per instance). Setiap operasi mengembalikan future<AsyncResult>
+ * dan dijalankan di ThreadPool berukuran sama dengan jumlah koneksi, sehingga
+ * mis. ekspor satu tabel dan impor tabel lain berjalan bersamaan.
+ * Koneksi dipinjam per operasi; schema diatur ke 'schema' saat dibuat.
+ */
+class AsyncDatabase {
+public:
+    AsyncDatabase(const ConnectionInfo& info, size_t connections, const string& schema)
+        : pool(max<size_t>(1, connections)) {
+        for (size_t i = 0; i < pool.size(); ++i) {
+            auto mgr = make_unique<DatabaseManager>(info.host, info.user, info.pass);
+            if (!schema.empty() && !mgr->useDatabase(schema)) {
+                throw runtime_error("Gagal memilih database '" + schema + "' untuk koneksi async.");
+            }
+            idle.push_back(mgr.get());
+            managers.push_back(std::move(mgr));
+        }
+    }
+
+    size_t connections() const { return managers.size(); }
+
+    /**
+     * @brief Menjalankan operasi apa pun terhadap satu DatabaseManager bebas.
+     * Baris/byte dikumpulkan lewat hook progres job (jobAddProgress) dan ikut
+     * ditambahkan ke job pemanggil; membatalkan job pemanggil menghentikan
+     * operasi yang sedang berjalan. Job pemanggil harus menunggu semua future.
+     */
+    future<AsyncResult> submit(function<bool(DatabaseManager&)> op) {
+        auto queuedAt = chrono::steady_clock::now();
+        Job* parent = currentJob;
+        return pool.submit([this, op = std::move(op), queuedAt, parent]() {
+            AsyncResult r;
+            Lease lease(*this);
+            auto start = chrono::steady_clock::now();
+            Job stats; // Penampung progres; tidak terdaftar di JobManager
+            stats.parent = parent;
+            Job* previous = currentJob;
+            currentJob = &stats;
+            try {
+                r.ok = op(*lease.mgr);
+                if (!r.ok) r.error = "operasi gagal (lihat db_operations.log)";
+            } catch (exception& e) {
+                r.ok = false;
+                r.error = e.what();
+            }
+            currentJob = previous;
+            auto end = chrono::steady_clock::now();
+            r.rows = stats.rows;
+            r.bytes = stats.bytes;
+            r.queueMs = chrono::duration<double, milli>(start - queuedAt).count();
+            r.elapsedMs = chrono::duration<double, milli>(end - start).count();
+            return r;
+        });
+    }
+
+    future<AsyncResult> query(const string& sql, const vector<string>& params = {}) {
+        auto queuedAt = chrono::steady_clock::now();
+        return pool.submit([this, sql, params, queuedAt]() {
+            AsyncResult r;
+            Lease lease(*this);
+            auto start = chrono::steady_clock::now();
+            r.ok = lease.mgr->runStatement(sql, params, r.result);
+            if (!r.ok) r.error = "query gagal (lihat db_operations.log)";
+            r.rows = r.result.rows.empty() ? r.result.affectedRows : r.result.rows.size();
+            auto end = chrono::steady_clock::now();
+            r.queueMs = chrono::duration<double, milli>(start - queuedAt).count();
+            r.elapsedMs = chrono::duration<double, milli>(end - start).count();
+            return r;
+        });
+    }
+
+    future<AsyncResult> exportToCSV(const string& tableName, const string& filePath,
+                                    const vector<string>& selectColumns = {}, const vector<ExportFilter>& filters = {}) {
+        return submit([=](DatabaseManager& m) { return m.exportToCSV(tableName, filePath, selectColumns, filters); });
+    }
+
+    future<AsyncResult> importFromCSV(const string& tableName, const string& filePath, const ImportOptions& options = ImportOptions()) {
+        return submit([=](DatabaseManager& m) { return m.importFromCSV(tableName, filePath, options); });
+    }
+
+    future<AsyncResult> backupDatabase(const string& dbName, const string& filePath) {
+        return submit([=](DatabaseManager& m) { return m.backupDatabase(dbName, filePath); });
+    }
+
+private:
+    vector<unique_ptr<DatabaseManager>> managers;
+    vector<DatabaseManager*> idle;
+    mutex idleMutex;
+    condition_variable idleCv;
+    ThreadPool pool; // Dideklarasikan terakhir: dihancurkan (dan ditunggu) sebelum managers
+
+    struct Lease {
+        AsyncDatabase& owner;
+        DatabaseManager* mgr;
+        explicit Lease(AsyncDatabase& o) : owner(o) {
+            unique_lock<mutex> lock(owner.idleMutex);
+            owner.idleCv.wait(lock, [this]() { return !owner.idle.empty(); });
+            mgr = owner.idle.back();
+            owner.idle.pop_back();
+        }
+        ~Lease() {
+            {
+                lock_guard<mutex> lock(owner.idleMutex);
+                owner.idle.push_back(mgr);
+            }
+            owner.idleCv.notify_one();
+        }
+    };
+};
+
+// --- IMPOR DIREKTORI ---
+
+/**
+ * @struct DirectoryImportOptions
+ * Impor banyak file sekaligus: setiap file di 'directory' yang namanya cocok
+ * dengan pola glob (*, ?) di 'rules' diimpor ke tabel pasangannya; aturan
+ * pertama yang cocok menang. Opsi 'import' (merge, dedupe, checkpoint) berlaku
+ * per file, jadi menjalankan ulang impor direktori melewati file yang sudah selesai.
+ */
+struct DirectoryImportOptions {
+    string directory;
+    vector<pair<string, string>> rules; // (pola glob nama file, tabel tujuan)
+    bool recursive = false;
+    size_t connections = 4;
+    ImportOptions import;
+};
+
+struct DirectoryImportFile {
+    string path;
+    string table;
+    uint64_t size = 0;
+};
+
+/**
+ * @brief Pencocokan glob sederhana: '*' = nol atau lebih karakter, '?' = satu karakter.
+ */
+static bool globMatch(const string& pattern, const string& name) {
+    size_t p = 0, n = 0, starP = string::npos, starN = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            p++;
+            n++;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starN = n;
+        } else if (starP != string::npos) {
+            p = starP + 1;
+            n = ++starN;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') p++;
+    return p == pattern.size();
+}
+
+/**
+ * @brief Membaca aturan "pola=tabel,pola=tabel". Mengembalikan false jika format salah.
+ */
+static bool parseImportRules(const string& text, vector<pair<string, string>>& rules) {
+    for (const string& item : splitList(text)) {
+        size_t eq = item.rfind('=');
+        if (eq == string::npos || eq == 0 || eq + 1 == item.size()) return false;
+        rules.emplace_back(item.substr(0, eq), item.substr(eq + 1));
+    }
+    return !rules.empty();
+}
+
+/**
+ * @brief File yang cocok dengan aturan, diurutkan dari yang terbesar: dengan
+ * penjadwalan FIFO di pool, file besar mulai lebih dulu dan file kecil mengisi
+ * sisa waktu koneksi lain (longest-processing-time first).
+ */
+static vector<DirectoryImportFile> collectImportFiles(const DirectoryImportOptions& opts) {
+    vector<DirectoryImportFile> files;
+    error_code ec;
+    auto consider = [&](const filesystem::directory_entry& entry) {
+        if (!entry.is_regular_file(ec)) return;
+        string name = entry.path().filename().string();
+        for (const auto& [pattern, table] : opts.rules) {
+            if (globMatch(pattern, name)) {
+                files.push_back({entry.path().string(), table, entry.file_size(ec)});
+                return;
             }
+        }
+    };
+    if (opts.recursive) {
+        for (filesystem::recursive_directory_iterator it(opts.directory, ec), end; !ec && it != end; it.increment(ec)) consider(*it);
+    } else {
+        for (filesystem::directory_iterator it(opts.directory, ec), end; !ec && it != end; it.increment(ec)) consider(*it);
+    }
+    if (ec) cerr << "Peringatan: gagal membaca direktori '" << opts.directory << "': " << ec.message() << endl;
+    stable_sort(files.begin(), files.end(), [](const DirectoryImportFile& a, const DirectoryImportFile& b) { return a.size > b.size; });
+    return files;
+}
+
+/**
+ * @brief Mengimpor semua file yang cocok secara paralel lewat AsyncDatabase:
+ * setiap file berjalan di satu koneksi pinjaman dengan transaksi per batch
+ * (checkpoint) miliknya sendiri. Mencetak ringkasan per file (baris, waktu,
+ * status) dan total. Pembatalan job menghentikan file yang belum mulai;
+ * file yang sedang berjalan selesai dan dapat dilanjutkan dari checkpoint.
+ */
+static bool importDirectory(const ConnectionInfo& info, const string& schema, const DirectoryImportOptions& opts) {
+    for (const auto& rule : opts.rules) {
+        if (!isSafeIdentifier(rule.second)) {
+            cerr << "Error: Nama tabel tujuan '" << rule.second << "' tidak valid." << endl;
+            return false;
+        }
+    }
+    vector<DirectoryImportFile> files = collectImportFiles(opts);
+    if (files.empty()) {
+        cout << "Tidak ada file yang cocok di '" << opts.directory << "'." << endl;
+        return false;
+    }
+    uint64_t totalBytes = 0;
+    for (const auto& f : files) totalBytes += f.size;
+    size_t connections = max<size_t>(1, min(opts.connections, files.size()));
+    cout << files.size() << " file (" << formatBytes(totalBytes) << ") diimpor dengan " << connections << " koneksi..." << endl;
+    // Progres byte impor = byte hasil dekompresi: total ukuran file hanya cocok jika tidak ada yang terkompresi
+    bool anyCompressed = any_of(files.begin(), files.end(), [](const DirectoryImportFile& f) {
+        return compressionFromPath(f.path) != Compression::None;
+    });
+    jobSetTotal(0, anyCompressed ? 0 : totalBytes);
+
+    auto start = chrono::steady_clock::now();
+    vector<AsyncResult> results(files.size());
+    {
+        AsyncDatabase async(info, connections, schema);
+        vector<future<AsyncResult>> pending;
+        for (const auto& f : files) {
+            ImportOptions importOptions = opts.import;
+            pending.push_back(async.submit([f, importOptions](DatabaseManager& m) {
+                if (jobCancelled()) throw runtime_error("dibatalkan sebelum mulai");
+                return m.importFromCSV(f.table, f.path, importOptions);
+            }));
+        }
+        for (size_t i = 0; i < pending.size(); ++i) results[i] = pending[i].get(); // Progres sudah diteruskan per baris
+    }
+    double wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << "\n=== Ringkasan Impor Direktori ===" << endl;
+    uint64_t rows = 0;
+    size_t failed = 0;
+    double sumMs = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        const AsyncResult& r = results[i];
+        rows += r.rows;
+        sumMs += r.elapsedMs;
+        if (!r.ok) failed++;
+        ostringstream oss;
+        oss << fixed << setprecision(1) << "[" << (i + 1) << "] " << (r.ok ? "OK   " : "GAGAL") << " | " << files[i].table << " | "
+            << r.rows << " baris | " << formatBytes(files[i].size) << " | antre " << r.queueMs << " ms | " << r.elapsedMs
+            << " ms | " << files[i].path;
+        cout << oss.str() << endl;
+        if (!r.ok) cout << "    " << r.error << endl;
+    }
+    ostringstream oss;
+    oss << fixed << setprecision(1) << "Total: " << files.size() - failed << " berhasil, " << failed << " gagal, " << rows
+        << " baris, " << formatBytes(totalBytes) << " dalam " << wallMs / 1000.0 << " s ("
+        << (wallMs > 0 ? totalBytes / (1024.0 * 1024.0) / (wallMs / 1000.0) : 0.0) << " MB/s; jumlah waktu per file "
+        << sumMs / 1000.0 << " s di " << connections << " koneksi).";
+    cout << oss.str() << endl;
+    return failed == 0;
+}
+
+// --- FAN-OUT MULTI-DATABASE ---
+
+/**
+ * @struct FanOutRequest
+ * Operasi yang dijalankan di setiap database target. Path ekspor/backup boleh
+ * memuat "{db}" yang diganti nama database (wajib bila target lebih dari satu,
+ * agar file tidak saling menimpa).
+ */
+struct FanOutRequest {
+    enum class Kind { Query, Truncate, Purge, Export, Backup };
+    Kind kind = Kind::Query;
+    string sql;                 // Query
+    string table;               // Truncate, Purge, Export
+    string path;                // Export, Backup
+    RetentionOptions retention; // Purge
+    size_t connections = 4;     // Koneksi paralel (dibatasi jumlah database)
+};
+
+/** @brief Schema bawaan server; hanya ikut fan-out bila disebut persis, bukan lewat pola. */
+static bool isSystemSchema(const string& name) {
+    return name == "information_schema" || name == "mysql" || name == "performance_schema" || name == "sys";
+}
+
+/**
+ * @brief Mencocokkan daftar nama/pola glob (*, ?) dengan database di server.
+ * Hasil unik dan terurut; nama persis yang tidak ada dilaporkan lalu dilewati.
+ */
+static vector<string> resolveFanOutDatabases(const vector<string>& available, const vector<string>& patterns) {
+    set<string> picked;
+    for (const string& pattern : patterns) {
+        if (pattern.find_first_of("*?") == string::npos) {
+            if (find(available.begin(), available.end(), pattern) != available.end()) picked.insert(pattern);
+            else cerr << "Database '" << pattern << "' tidak ditemukan, dilewati." << endl;
+            continue;
+        }
+        for (const string& db : available) {
+            if (!isSystemSchema(db) && globMatch(pattern, db)) picked.insert(db);
+        }
+    }
+    return vector<string>(picked.begin(), picked.end());
+}
+
+static string fanOutPath(const string& pattern, const string& database) {
+    string path = pattern;
+    for (size_t pos = path.find("{db}"); pos != string::npos; pos = path.find("{db}", pos + database.size())) {
+        path.replace(pos, 4, database);
+    }
+    return path;
+}
 
-            pstmt->executeUpdate();
-            cout << "Data berhasil dimasukkan ke tabel '" << tableName << "'.\n";
-            writeLog("Insert otomatis ke tabel: " + tableName);
-            return true;
+static string fanOutLabel(const FanOutRequest& req) {
+    switch (req.kind) {
+        case FanOutRequest::Kind::Query: return "Query";
+        case FanOutRequest::Kind::Truncate: return "Truncate " + req.table;
+        case FanOutRequest::Kind::Purge: return "Purge " + req.table;
+        case FanOutRequest::Kind::Export: return "Ekspor " + req.table;
+        case FanOutRequest::Kind::Backup: return "Backup";
+    }
+    return "?";
+}
+
+/** @brief Memeriksa parameter request terhadap jumlah target sebelum koneksi dibuka. */
+static bool validateFanOutRequest(const FanOutRequest& req, size_t targets) {
+    bool needsTable = req.kind == FanOutRequest::Kind::Truncate || req.kind == FanOutRequest::Kind::Purge ||
+                      req.kind == FanOutRequest::Kind::Export;
+    bool needsPath = req.kind == FanOutRequest::Kind::Export || req.kind == FanOutRequest::Kind::Backup;
+    if (req.kind == FanOutRequest::Kind::Query && req.sql.empty()) {
+        cerr << "Query kosong." << endl;
+        return false;
+    }
+    if (needsTable && !isSafeIdentifier(req.table)) {
+        cerr << "Error: Nama tabel '" << req.table << "' tidak valid." << endl;
+        return false;
+    }
+    if (needsPath && (req.path.empty() || (targets > 1 && req.path.find("{db}") == string::npos))) {
+        cerr << "Path file harus memuat {db} bila target lebih dari satu database (cth: backup_{db}.sql.gz)." << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Menjalankan 'req' di setiap database secara paralel pada 'connections'
+ * koneksi independen (AsyncDatabase tanpa schema awal). Setiap operasi memilih
+ * database-nya sendiri di koneksi pinjaman, jadi koneksi pemanggil tidak
+ * berpindah schema. Hasil, waktu, dan kegagalan per database diringkas di akhir.
+ */
+static bool fanOut(const ConnectionInfo& info, const vector<string>& databases, const FanOutRequest& req) {
+    if (databases.empty()) {
+        cout << "Tidak ada database target." << endl;
+        return false;
+    }
+    if (!validateFanOutRequest(req, databases.size())) return false;
+    size_t connections = max<size_t>(1, min(req.connections, databases.size()));
+    string label = fanOutLabel(req);
+    cout << label << " di " << databases.size() << " database dengan " << connections << " koneksi..." << endl;
+
+    auto start = chrono::steady_clock::now();
+    vector<AsyncResult> results(databases.size());
+    {
+        AsyncDatabase async(info, connections, "");
+        vector<future<AsyncResult>> pending;
+        for (const string& db : databases) {
+            pending.push_back(async.submit([db, req](DatabaseManager& m) {
+                if (jobCancelled()) throw runtime_error("dibatalkan sebelum mulai");
+                if (!m.useDatabase(db)) throw runtime_error("gagal memilih database");
+                switch (req.kind) {
+                    case FanOutRequest::Kind::Query: {
+                        QueryResult r;
+                        if (!m.runStatement(req.sql, {}, r)) return false;
+                        jobAddProgress(r.rows.empty() ? r.affectedRows : r.rows.size());
+                        return true;
+                    }
+                    case FanOutRequest::Kind::Truncate: return m.truncateTable(req.table);
+                    case FanOutRequest::Kind::Purge: return m.purgeOlderThan(req.table, req.retention);
+                    case FanOutRequest::Kind::Export: return m.exportToCSV(req.table, fanOutPath(req.path, db));
+                    case FanOutRequest::Kind::Backup: return m.backupDatabase(db, fanOutPath(req.path, db));
+                }
+                return false;
+            }));
         }
-        catch (sql::SQLException& e) {
-            cerr << "Error saat insert otomatis: " << e.what() << endl;
-            writeLog(string("Error insert otomatis: ") + e.what());
-            return false;
+        for (size_t i = 0; i < pending.size(); ++i) results[i] = pending[i].get(); // Progres sudah diteruskan per baris
+    }
+    double wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << "\n=== Ringkasan Fan-Out: " << label << " ===" << endl;
+    uint64_t rows = 0, bytes = 0;
+    double sumMs = 0, slowestMs = 0;
+    string slowest;
+    vector<string> failed;
+    for (size_t i = 0; i < databases.size(); ++i) {
+        const AsyncResult& r = results[i];
+        rows += r.rows;
+        bytes += r.bytes;
+        sumMs += r.elapsedMs;
+        if (r.elapsedMs >= slowestMs) {
+            slowestMs = r.elapsedMs;
+            slowest = databases[i];
         }
+        if (!r.ok) failed.push_back(databases[i]);
+        ostringstream oss;
+        oss << fixed << setprecision(1) << "[" << (i + 1) << "] " << (r.ok ? "OK   " : "GAGAL") << " | " << databases[i] << " | "
+            << r.rows << " baris";
+        if (r.bytes) oss << " | " << formatBytes(r.bytes);
+        oss << " | antre " << r.queueMs << " ms | " << r.elapsedMs << " ms";
+        cout << oss.str() << endl;
+        if (!r.ok) cout << "    " << r.error << endl;
     }
+    ostringstream oss;
+    oss << fixed << setprecision(1) << "Total: " << databases.size() - failed.size() << " berhasil, " << failed.size()
+        << " gagal, " << rows << " baris";
+    if (bytes) oss << ", " << formatBytes(bytes);
+    oss << " dalam " << wallMs / 1000.0 << " s (jumlah waktu per database " << sumMs / 1000.0 << " s di " << connections
+        << " koneksi; terlama " << slowest << " " << slowestMs << " ms).";
+    cout << oss.str() << endl;
+    if (!failed.empty()) cout << "Database gagal (untuk dijalankan ulang): " << joinList(failed) << endl;
+    return failed.empty();
+}
 
-    /**
-     * @brief Versi non-interaktif dari insertData (digunakan oleh generateRandomData).
-     * Ini sudah aman menggunakan prepared statements.
-     */
-    bool insertData(const string& tableName, const vector<string>& columns, const vector<string>& values) {
-        // Asumsi: tableName dan columns divalidasi oleh pemanggil jika perlu
-        if (columns.empty() || columns.size() != values.size()) {
-            writeLog("Error insert non-interaktif: Kolom dan nilai tidak cocok.");
-            return false;
-        }
+// --- REPLAY WORKLOAD ---
 
-        lock_guard<mutex> lock(dbMutex);
-        try {
-            if (currentDB.empty()) {
-                writeLog("Error insert non-interaktif: DB tidak dipilih.");
-                return false;
-            }
+/**
+ * @struct ReplayOptions
+ * connections = 0: satu koneksi per sesi capture (batas transaksi dan urutan
+ * per sesi terjaga persis). Lebih sedikit koneksi: sesi dibagi round-robin dan
+ * statement sesi yang berbagi koneksi bisa masuk ke transaksi sesi lain.
+ * speed: 1 = kecepatan asli, 2 = dua kali lebih cepat, 0 = secepatnya.
+ */
+struct ReplayOptions {
+    size_t connections = 0;
+    double speed = 1.0;
+};
 
-            string query = "INSERT INTO `" + tableName + "` (";
-            string valuePlaceholders = ") VALUES (";
-            for (size_t i = 0; i < columns.size(); ++i) {
-                query += "`" + columns[i] + "`"; // Asumsi nama kolom aman dari internal
-                valuePlaceholders += "?";
-                if (i < columns.size() - 1) {
-                    query += ",";
-                    valuePlaceholders += ",";
-                }
-            }
-            query += valuePlaceholders + ");";
+/**
+ * @struct CapturedStatement
+ * Satu baris 'Q' file capture beserta hasil replay-nya.
+ */
+struct CapturedStatement {
+    int64_t offsetUs = 0;
+    uint32_t session = 0;
+    int64_t elapsedUs = 0;
+    bool ok = true;
+    uint32_t sqlId = 0;
+    vector<optional<string>> params;
+    int64_t replayUs = 0;
+    int64_t lagUs = 0; // Keterlambatan mulai dibanding jadwal
+    bool replayed = false;
+    bool replayOk = false;
+};
 
-            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(query));
-            for (size_t i = 0; i < values.size(); ++i) {
-                pstmt->setString(i + 1, values[i]);
-            }
-            pstmt->executeUpdate();
-            return true;
+/** @brief Membaca file capture (boleh .gz/.zst) dan mengurutkan statement menurut offset. */
+static bool loadWorkloadCapture(const string& path, vector<string>& sqls, vector<CapturedStatement>& statements) {
+    CompressedIFStream in(path);
+    if (!in.is_open() || in.fail()) {
+        cerr << "Gagal membuka file capture: " << path << endl;
+        return false;
+    }
+    string line;
+    vector<optional<string>> fields;
+    size_t lineNo = 0;
+    auto number = [](const optional<string>& f) { return f ? strtoll(f->c_str(), nullptr, 10) : 0LL; };
+    while (getline(in, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        if (lineNo == 1 && line.rfind("#dbm-capture\t", 0) != 0) {
+            cerr << "Bukan file capture workload: " << path << endl;
+            return false;
         }
-        catch (sql::SQLException& e) {
-            writeLog(string("Error insert non-interaktif (") + tableName + "): " + e.what());
+        if (line[0] == '#') continue;
+        splitCaptureLine(line, fields);
+        bool valid = fields[0] && ((*fields[0] == "S" && fields.size() == 3 && fields[2]) || (*fields[0] == "Q" && fields.size() >= 6));
+        if (valid && *fields[0] == "S") {
+            size_t id = static_cast<size_t>(number(fields[1]));
+            if (id != sqls.size()) valid = false;
+            else sqls.push_back(*fields[2]);
+        } else if (valid) {
+            CapturedStatement st;
+            st.offsetUs = number(fields[1]);
+            st.session = static_cast<uint32_t>(number(fields[2]));
+            st.elapsedUs = number(fields[3]);
+            st.ok = fields[4] && *fields[4] == "1";
+            st.sqlId = static_cast<uint32_t>(number(fields[5]));
+            if (st.sqlId >= sqls.size()) valid = false;
+            st.params.assign(make_move_iterator(fields.begin() + 6), make_move_iterator(fields.end()));
+            statements.push_back(std::move(st));
+        }
+        if (!valid) {
+            cerr << "Baris capture " << lineNo << " tidak valid." << endl;
             return false;
         }
     }
+    if (in.hasError()) {
+        cerr << "File capture rusak: " << path << endl;
+        return false;
+    }
+    stable_sort(statements.begin(), statements.end(),
+                [](const CapturedStatement& a, const CapturedStatement& b) { return a.offsetUs < b.offsetUs; });
+    return true;
+}
 
-    /**
-     * @brief [REWRITE] Menampilkan data dengan filter WHERE interaktif dan aman.
-     */
-    bool selectData(const string& tableName) {
-        if (!isValidIdentifier(tableName)) return false; // Keamanan
+/**
+ * @brief Memutar ulang file capture ke 'schema' dengan jadwal (offset / speed)
+ * dan melaporkan perbedaan latensi per sidik jari SQL terhadap capture.
+ * Setiap sesi capture diputar berurutan pada satu koneksi.
+ */
+static bool replayWorkload(const ConnectionInfo& info, const string& schema, const string& path, const ReplayOptions& opts) {
+    vector<string> sqls;
+    vector<CapturedStatement> statements;
+    if (!loadWorkloadCapture(path, sqls, statements)) return false;
+    if (statements.empty()) {
+        cout << "File capture tidak berisi statement." << endl;
+        return false;
+    }
 
-        try {
-            vector<string> whereColumns;
-            vector<string> whereValues;
-            map<string, string> columns;
+    // Sesi -> koneksi; setiap koneksi memutar antreannya sendiri menurut offset
+    unordered_map<uint32_t, size_t> sessionSlot;
+    for (const CapturedStatement& st : statements) sessionSlot.emplace(st.session, sessionSlot.size());
+    size_t connections = opts.connections ? min(opts.connections, sessionSlot.size()) : sessionSlot.size();
+    vector<vector<size_t>> queues(connections);
+    for (size_t i = 0; i < statements.size(); ++i) queues[sessionSlot[statements[i].session] % connections].push_back(i);
+
+    vector<unique_ptr<DatabaseManager>> managers;
+    for (size_t i = 0; i < connections; ++i) {
+        auto mgr = make_unique<DatabaseManager>(info.host, info.user, info.pass);
+        if (!mgr->useDatabase(schema)) return false;
+        managers.push_back(std::move(mgr));
+    }
 
-            // 1. Dapatkan kolom dan tanyakan filter
-            {
-                lock_guard<mutex> lock(dbMutex);
-                if (currentDB.empty()) {
-                    cout << "Pilih database terlebih dahulu!" << endl;
-                    return false;
-                }
-                columns = getTableColumns(tableName);
-                if (columns.empty()) {
-                    cerr << "Gagal mendapatkan kolom untuk '" << tableName << "'." << endl;
-                    return false;
-                }
+    int64_t capturedSpanUs = statements.back().offsetUs + statements.back().elapsedUs;
+    cout << "Replay " << statements.size() << " statement dari " << sessionSlot.size() << " sesi ("
+         << fixed << setprecision(1) << capturedSpanUs / 1e6 << " s asli) dengan " << connections << " koneksi, kecepatan "
+         << (opts.speed > 0 ? to_string(opts.speed) + "x" : string("maksimum")) << "..." << endl;
+    jobSetTotal(statements.size(), 0);
+
+    auto replayStart = chrono::steady_clock::now();
+    auto worker = [&](size_t slot) {
+        tracer().setThreadName("replay-" + to_string(slot));
+        DatabaseManager& mgr = *managers[slot];
+        for (size_t i : queues[slot]) {
+            if (jobCancelled()) return;
+            CapturedStatement& st = statements[i];
+            auto due = replayStart;
+            if (opts.speed > 0) {
+                due += chrono::microseconds(static_cast<int64_t>(st.offsetUs / opts.speed));
+                this_thread::sleep_until(due);
             }
+            st.lagUs = max<int64_t>(0, chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - due).count());
+            st.replayOk = mgr.replayStatement(sqls[st.sqlId], st.params, st.replayUs);
+            st.replayed = true;
+        }
+    };
+    Job* outer = currentJob;
+    vector<thread> threads;
+    for (size_t i = 0; i < connections; ++i) {
+        threads.emplace_back([&, i]() {
+            currentJob = outer; // Pembatalan job ikut terlihat dari thread replay
+            worker(i);
+        });
+    }
+    for (thread& t : threads) t.join();
+    double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - replayStart).count();
+    jobAddProgress(statements.size());
+
+    // Ringkasan per sidik jari: latensi capture vs replay
+    struct Group {
+        string fingerprint;
+        vector<double> captured, replayed;
+        uint64_t failed = 0;
+    };
+    unordered_map<string, Group> groups;
+    vector<double> allCaptured, allReplayed, lags;
+    uint64_t capturedFailed = 0, replayFailed = 0, skipped = 0;
+    vector<string> fingerprints(sqls.size());
+    for (size_t i = 0; i < sqls.size(); ++i) fingerprints[i] = fingerprintSQL(sqls[i]);
+    for (const CapturedStatement& st : statements) {
+        if (!st.ok) capturedFailed++;
+        if (!st.replayed) {
+            skipped++; // Tidak sempat diputar (dibatalkan)
+            continue;
+        }
+        Group& g = groups[fingerprints[st.sqlId]];
+        g.fingerprint = fingerprints[st.sqlId];
+        g.captured.push_back(st.elapsedUs / 1000.0);
+        g.replayed.push_back(st.replayUs / 1000.0);
+        if (!st.replayOk) {
+            g.failed++;
+            replayFailed++;
+        }
+        allCaptured.push_back(st.elapsedUs / 1000.0);
+        allReplayed.push_back(st.replayUs / 1000.0);
+        lags.push_back(st.lagUs / 1000.0);
+    }
+    auto percentile = [](vector<double>& v, double p) {
+        if (v.empty()) return 0.0;
+        size_t k = min(v.size() - 1, static_cast<size_t>(p * v.size()));
+        nth_element(v.begin(), v.begin() + static_cast<ptrdiff_t>(k), v.end());
+        return v[k];
+    };
+    auto sum = [](const vector<double>& v) { return accumulate(v.begin(), v.end(), 0.0); };
+    auto change = [](double before, double after) { return before > 0 ? 100.0 * (after - before) / before : 0.0; };
+
+    ostringstream oss;
+    oss << fixed << setprecision(2);
+    oss << "\n=== Ringkasan Replay Workload ===\n"
+        << "Statement: " << allReplayed.size() << " diputar, " << replayFailed << " gagal saat replay (" << capturedFailed
+        << " gagal di capture)";
+    if (skipped) oss << ", " << skipped << " tidak diputar (dibatalkan)";
+    oss << "\nDurasi: asli " << capturedSpanUs / 1e6 << " s, replay " << wallSeconds << " s\n"
+        << "Keterlambatan jadwal ms: p50 " << percentile(lags, 0.50) << "  p99 " << percentile(lags, 0.99)
+        << "  maks " << (lags.empty() ? 0.0 : *max_element(lags.begin(), lags.end())) << "\n";
+    double capturedTotal = sum(allCaptured), replayedTotal = sum(allReplayed);
+    oss << "Latensi ms (capture -> replay): p50 " << percentile(allCaptured, 0.50) << " -> " << percentile(allReplayed, 0.50)
+        << "  p95 " << percentile(allCaptured, 0.95) << " -> " << percentile(allReplayed, 0.95)
+        << "  p99 " << percentile(allCaptured, 0.99) << " -> " << percentile(allReplayed, 0.99)
+        << "  total " << capturedTotal << " -> " << replayedTotal << " (" << showpos << change(capturedTotal, replayedTotal)
+        << noshowpos << "%)";
+    cout << oss.str() << endl;
+
+    vector<Group*> ranked;
+    for (auto& [fp, g] : groups) ranked.push_back(&g);
+    sort(ranked.begin(), ranked.end(), [&](Group* a, Group* b) { return sum(a->captured) > sum(b->captured); });
+    cout << "\n" << left << setw(4) << "#" << setw(8) << "Panggil" << setw(11) << "Rata asli" << setw(12) << "Rata replay"
+         << setw(9) << "Selisih" << setw(10) << "p95 asli" << setw(11) << "p95 replay" << setw(7) << "Gagal" << "Sidik jari" << endl;
+    cout << string(110, '-') << endl;
+    for (size_t i = 0; i < ranked.size() && i < 20; ++i) {
+        Group& g = *ranked[i];
+        double n = static_cast<double>(g.captured.size());
+        string fp = g.fingerprint.size() > 50 ? g.fingerprint.substr(0, 47) + "..." : g.fingerprint;
+        ostringstream row;
+        row << fixed << setprecision(2) << left << setw(4) << (i + 1) << setw(8) << g.captured.size() << setw(11)
+            << sum(g.captured) / n << setw(12) << sum(g.replayed) / n << setw(9)
+            << (to_string(static_cast<int>(change(sum(g.captured), sum(g.replayed)))) + "%") << setw(10)
+            << percentile(g.captured, 0.95) << setw(11) << percentile(g.replayed, 0.95) << setw(7) << g.failed << fp;
+        cout << row.str() << endl;
+    }
+    return replayFailed == 0 && skipped == 0;
+}
 
-            cout << "Kolom yang tersedia: ";
-            for(auto const& [key, val] : columns) cout << key << " ";
-            cout << "\n";
-
-            string colName;
-            while (true) {
-                cout << "Filter WHERE berdasarkan kolom (atau 'selesai'): ";
-                getline(cin, colName);
-                if (colName == "selesai" || colName.empty()) break;
-
-                if (columns.find(colName) == columns.end()) {
-                    cout << "Kolom '" << colName << "' tidak ditemukan." << endl;
-                    continue;
-                }
+// --- GROUP COMMIT ---
 
-                cout << "Nilai untuk " << colName << " = ";
-                string val;
-                getline(cin, val);
-                whereColumns.push_back(colName);
-                whereValues.push_back(val);
-            }
+/**
+ * @struct GroupCommitOptions
+ * Tradeoff latensi vs. throughput untuk GroupCommitBuffer:
+ * flush terjadi saat antrean mencapai 'maxBatchRows' (ukuran) atau saat baris
+ * tertua sudah menunggu 'maxDelayMs' (deadline). maxDelayMs = 0 berarti flush
+ * secepatnya (batch hanya terbentuk dari baris yang antre selama commit sebelumnya).
+ */
+struct GroupCommitOptions {
+    size_t connections = 1;        // Flusher paralel, masing-masing dengan koneksi sendiri
+    size_t maxBatchRows = 500;
+    int maxDelayMs = 5;
+    size_t maxQueuedRows = 100000; // Backpressure: batas baris yang boleh antre
+};
 
-            // 2. Build & Eksekusi Query
-            unique_ptr<sql::PreparedStatement> pstmt;
-            unique_ptr<sql::ResultSet> res;
-            {
-                lock_guard<mutex> lock(dbMutex);
-                string query = "SELECT * FROM `" + tableName + "`";
-                if (!whereColumns.empty()) {
-                    query += " WHERE ";
-                    for (size_t i = 0; i < whereColumns.size(); ++i) {
-                        query += "`" + whereColumns[i] + "` = ?";
-                        if (i < whereColumns.size() - 1) query += " AND ";
-                    }
-                }
-                
-                pstmt.reset(conn->prepareStatement(query));
-                for (size_t i = 0; i < whereValues.size(); ++i) {
-                    pstmt->setString(i + 1, whereValues[i]);
-                }
-                res.reset(pstmt->executeQuery());
+/**
+ * @class GroupCommitBuffer
+ * Buffer penggabung tulis di depan jalur insert. Pemanggil mengantrekan baris
+ * dan menerima future/callback; flusher menggabungkan antrean per tabel menjadi
+ * INSERT multi-baris dalam satu transaksi (satu commit, satu fsync) lewat
+ * DatabaseManager::insertRowSets. Jika batch gabungan gagal (mis. satu baris
+ * duplikat), setiap entri dicoba ulang di transaksinya sendiri agar kegagalan
+ * tidak menular ke pemanggil lain.
+ * Metrik: kedalaman antrean, ukuran/durasi flush, pemicu flush, dan latensi antre.
+ */
+class GroupCommitBuffer {
+public:
+    using Callback = function<void(bool)>;
+
+    GroupCommitBuffer(const ConnectionInfo& info, const string& schema, const GroupCommitOptions& options = GroupCommitOptions())
+        : opts(options),
+          queueDepth(metrics().gauge("dbm_group_commit_queue_rows", "Baris yang menunggu di-flush")),
+          rowsTotal(metrics().counter("dbm_group_commit_rows_total", "Baris yang berhasil di-commit lewat group commit")),
+          flushesTotal(metrics().counter("dbm_group_commit_flushes_total", "Jumlah flush (transaksi) group commit")),
+          failuresTotal(metrics().counter("dbm_group_commit_failed_rows_total", "Baris yang gagal di-commit")),
+          retriesTotal(metrics().counter("dbm_group_commit_retries_total", "Batch gagal yang dicoba ulang per entri")),
+          rejectedTotal(metrics().counter("dbm_group_commit_rejected_total", "Entri ditolak (antrean penuh/tidak valid)")),
+          triggerSize(metrics().counter("dbm_group_commit_flush_trigger_total{reason=\"size\"}", "Penyebab flush")),
+          triggerDeadline(metrics().counter("dbm_group_commit_flush_trigger_total{reason=\"deadline\"}", "Penyebab flush")),
+          triggerExplicit(metrics().counter("dbm_group_commit_flush_trigger_total{reason=\"flush\"}", "Penyebab flush")),
+          flushRows(metrics().histogram("dbm_group_commit_flush_rows", "Baris per flush",
+                                        {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000})),
+          flushMs(metrics().histogram("dbm_group_commit_flush_ms", "Durasi insert+commit per flush (ms)",
+                                      {0.5, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000})),
+          waitMs(metrics().histogram("dbm_group_commit_wait_ms", "Waktu dari antre hingga commit selesai (ms)",
+                                     {0.5, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000})) {
+        opts.maxBatchRows = max<size_t>(1, opts.maxBatchRows);
+        opts.maxQueuedRows = max(opts.maxQueuedRows, opts.maxBatchRows);
+        opts.maxDelayMs = max(0, opts.maxDelayMs);
+        for (size_t i = 0; i < max<size_t>(1, opts.connections); ++i) {
+            auto mgr = make_unique<DatabaseManager>(info.host, info.user, info.pass);
+            if (!mgr->useDatabase(schema)) {
+                throw runtime_error("Gagal memilih database '" + schema + "' untuk group commit.");
             }
+            managers.push_back(std::move(mgr));
+        }
+        for (auto& mgr : managers) {
+            DatabaseManager* m = mgr.get();
+            flushers.emplace_back([this, m]() { flusherLoop(*m); });
+        }
+    }
 
-            // 3. Tampilkan Hasil (sama seperti sebelumnya)
-            cout << "\nData dari '" << tableName << "':" << endl;
-            sql::ResultSetMetaData* meta = res->getMetaData();
-            int cols = meta->getColumnCount();
-            
-            int totalWidth = 0;
-            vector<int> colWidths;
-            for (int i = 1; i <= cols; ++i) {
-                int width = max((int)meta->getColumnName(i).length(), 15);
-                colWidths.push_back(width);
-                cout << left << setw(width) << meta->getColumnName(i) << " | ";
-                totalWidth += width + 3;
-            }
-            cout << endl << string(totalWidth, '-') << endl;
-            while (res->next()) {
-                for (int i = 1; i <= cols; ++i) {
-                    string val = res->getString(i);
-                    if (val.length() > colWidths[i-1]) {
-                        val = val.substr(0, colWidths[i-1] - 3) + "...";
-                    }
-                    cout << left << setw(colWidths[i-1]) << (res->isNull(i) ? "NULL" : val) << " | ";
-                }
-                cout << endl;
-            }
-            writeLog("Memilih data dari tabel (interaktif): " + tableName);
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error memilih data: " << e.what() << endl;
-            writeLog(string("Error memilih data: ") + e.what());
-            return false;
+    /** @brief Mem-flush semua baris yang masih antre, lalu menghentikan flusher. */
+    ~GroupCommitBuffer() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueCv.notify_all();
+        spaceCv.notify_all();
+        for (thread& t : flushers) {
+            if (t.joinable()) t.join();
         }
     }
 
+    GroupCommitBuffer(const GroupCommitBuffer&) = delete;
+    GroupCommitBuffer& operator=(const GroupCommitBuffer&) = delete;
+
     /**
-     * @brief [REWRITE] Update data dengan panduan interaktif dan aman.
+     * @brief Padanan insertData(table, columns, values) lewat group commit.
+     * Future bernilai true setelah baris ter-commit.
      */
-    bool updateData(const string& tableName) {
-        if (!isValidIdentifier(tableName)) return false; // Keamanan
+    future<bool> insert(const string& table, const vector<string>& columns, const vector<string>& values) {
+        vector<vector<optional<string>>> rows(1);
+        rows[0].assign(values.begin(), values.end());
+        return enqueue(table, columns, std::move(rows));
+    }
 
-        lock_guard<mutex> lock(dbMutex);
-        if (currentDB.empty()) {
-            cout << "Pilih database terlebih dahulu!" << endl;
-            return false;
-        }
+    /**
+     * @brief Mengantrekan beberapa baris sebagai satu unit (selalu di-commit bersama).
+     * Memblokir bila antrean penuh (backpressure).
+     */
+    future<bool> enqueue(const string& table, const vector<string>& columns, vector<vector<optional<string>>> rows) {
+        return enqueueSet({table, columns, std::move(rows), {}});
+    }
 
-        try {
-            map<string, string> columns = getTableColumns(tableName);
-            if (columns.empty()) {
-                cerr << "Gagal mendapatkan kolom untuk '" << tableName << "'." << endl;
-                return false;
-            }
+    /** @brief Seperti enqueue(), untuk record bertipe (SensorReading/AppUsage). */
+    template <typename Record>
+    future<bool> enqueueRecords(const string& table, vector<Record> records) {
+        return enqueueSet({table, recordColumnNames<Record>(), {}, TypedRows(std::move(records))});
+    }
 
-            cout << "Kolom yang tersedia: ";
-            for(auto const& [key, val] : columns) cout << key << " ";
-            cout << "\n";
+    /**
+     * @brief Versi non-blocking untuk event loop: 'done' dipanggil dari thread
+     * flusher setelah commit. False = ditolak (antrean penuh atau data tidak
+     * valid) dan 'done' tidak akan dipanggil.
+     */
+    bool tryEnqueue(const string& table, const vector<string>& columns, vector<vector<optional<string>>> rows, Callback done) {
+        return admit({table, columns, std::move(rows), {}}, std::move(done), false);
+    }
 
-            // 1. Get SET clauses
-            vector<string> setColumns;
-            vector<string> setValues;
-            string colName;
-            while (true) {
-                cout << "Masukkan nama kolom untuk di-SET (atau 'selesai'): ";
-                getline(cin, colName);
-                if (colName == "selesai" || colName.empty()) break;
-                
-                if (columns.find(colName) == columns.end()) {
-                    cout << "Kolom '" << colName << "' tidak ditemukan." << endl;
-                    continue;
-                }
+    /** @brief Seperti tryEnqueue(), untuk record bertipe: bind angka langsung, tanpa teks perantara. */
+    template <typename Record>
+    bool tryEnqueueRecords(const string& table, vector<Record> records, Callback done) {
+        return admit({table, recordColumnNames<Record>(), {}, TypedRows(std::move(records))}, std::move(done), false);
+    }
 
-                cout << "Nilai BARU untuk '" << colName << "': ";
-                string val;
-                getline(cin, val);
-                setColumns.push_back(colName);
-                setValues.push_back(val);
-            }
-            if (setColumns.empty()) {
-                cout << "Tidak ada kolom yang di-SET. Operasi dibatalkan." << endl;
-                return false;
-            }
+    /** @brief Memaksa flush dan menunggu hingga antrean kosong dan semua commit selesai. */
+    void flush() {
+        unique_lock<mutex> lock(queueMutex);
+        flushRequested = true;
+        queueCv.notify_all();
+        idleCv.wait(lock, [this]() { return queue.empty() && inFlight == 0; });
+    }
 
-            // 2. Get WHERE clauses
-            vector<string> whereColumns;
-            vector<string> whereValues;
-            while (true) {
-                cout << "Filter WHERE berdasarkan kolom (atau 'selesai'): ";
-                getline(cin, colName);
-                if (colName == "selesai" || colName.empty()) break;
+    size_t queuedRows() const {
+        lock_guard<mutex> lock(queueMutex);
+        return queued;
+    }
 
-                if (columns.find(colName) == columns.end()) {
-                    cout << "Kolom '" << colName << "' tidak ditemukan." << endl;
-                    continue;
-                }
-                
-                cout << "Nilai WHERE untuk '" << colName << "' (=): ";
-                string val;
-                getline(cin, val);
-                whereColumns.push_back(colName);
-                whereValues.push_back(val);
-            }
+    const GroupCommitOptions& options() const { return opts; }
 
-            // 3. Build Query
-            string query = "UPDATE `" + tableName + "` SET ";
-            for (size_t i = 0; i < setColumns.size(); ++i) {
-                query += "`" + setColumns[i] + "` = ?";
-                if (i < setColumns.size() - 1) query += ", ";
-            }
-            if (!whereColumns.empty()) {
-                query += " WHERE ";
-                for (size_t i = 0; i < whereColumns.size(); ++i) {
-                    query += "`" + whereColumns[i] + "` = ?";
-                    if (i < whereColumns.size() - 1) query += " AND ";
-                }
-            } else {
-                cout << "PERINGATAN: Update tanpa WHERE akan mempengaruhi SEMUA baris!" << endl;
-                cout << "Ketik 'LANJUTKAN' untuk mengkonfirmasi: ";
-                string confirm;
-                getline(cin, confirm);
-                if (confirm != "LANJUTKAN") {
-                    cout << "Update dibatalkan." << endl;
-                    return false;
-                }
+private:
+    struct Entry {
+        RowSet data;
+        size_t rows = 0; // data.rowCount()
+        Callback done;
+        chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    GroupCommitOptions opts;
+    vector<unique_ptr<DatabaseManager>> managers;
+    vector<thread> flushers;
+
+    mutable mutex queueMutex;
+    condition_variable queueCv; // Flusher: ada baris baru / stop / flush
+    condition_variable spaceCv; // Produsen yang diblokir backpressure
+    condition_variable idleCv;  // flush(): antrean kosong dan tidak ada commit berjalan
+    deque<Entry> queue;
+    size_t queued = 0;
+    size_t inFlight = 0;
+    bool stopping = false;
+    bool flushRequested = false;
+
+    MetricGauge& queueDepth;
+    MetricCounter& rowsTotal;
+    MetricCounter& flushesTotal;
+    MetricCounter& failuresTotal;
+    MetricCounter& retriesTotal;
+    MetricCounter& rejectedTotal;
+    MetricCounter& triggerSize;
+    MetricCounter& triggerDeadline;
+    MetricCounter& triggerExplicit;
+    MetricHistogram& flushRows;
+    MetricHistogram& flushMs;
+    MetricHistogram& waitMs;
+
+    future<bool> enqueueSet(RowSet&& data) {
+        auto promise = make_shared<std::promise<bool>>();
+        future<bool> result = promise->get_future();
+        if (!admit(std::move(data), [promise](bool ok) { promise->set_value(ok); }, true)) {
+            promise->set_value(false);
+        }
+        return result;
+    }
+
+    bool admit(RowSet&& data, Callback&& done, bool block) {
+        bool valid = isSafeIdentifier(data.table) && !data.columns.empty();
+        for (const string& c : data.columns) valid = valid && isSafeIdentifier(c);
+        for (const auto& row : data.rows) valid = valid && row.size() == data.columns.size();
+        if (!valid) {
+            rejectedTotal.add();
+            return false;
+        }
+        size_t n = data.rowCount();
+        if (n == 0) {
+            done(true);
+            return true;
+        }
+        {
+            unique_lock<mutex> lock(queueMutex);
+            auto fits = [this, n]() { return queued == 0 || queued + n <= opts.maxQueuedRows; };
+            if (block) spaceCv.wait(lock, [this, &fits]() { return stopping || fits(); });
+            if (stopping || !fits()) {
+                rejectedTotal.add();
+                return false;
             }
+            queue.push_back({std::move(data), n, std::move(done), chrono::steady_clock::now()});
+            queued += n;
+            queueDepth.add(static_cast<int64_t>(n));
+        }
+        queueCv.notify_one();
+        return true;
+    }
 
-            // 4. Prepare and Execute
-            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(query));
-            int paramIndex = 1;
-            for (const string& val : setValues) {
-                pstmt->setString(paramIndex++, val);
+    void flusherLoop(DatabaseManager& mgr) {
+        unique_lock<mutex> lock(queueMutex);
+        while (true) {
+            if (queue.empty()) {
+                if (stopping) return;
+                queueCv.wait(lock);
+                continue;
             }
-            for (const string& val : whereValues) {
-                pstmt->setString(paramIndex++, val);
+            bool full = queued >= opts.maxBatchRows;
+            bool forced = stopping || flushRequested;
+            auto deadline = queue.front().enqueuedAt + chrono::milliseconds(opts.maxDelayMs);
+            if (!full && !forced && chrono::steady_clock::now() < deadline) {
+                queueCv.wait_until(lock, deadline);
+                continue; // Evaluasi ulang: antrean bisa sudah diambil flusher lain
+            }
+            (full ? triggerSize : forced ? triggerExplicit : triggerDeadline).add();
+
+            vector<Entry> taken;
+            size_t rows = 0;
+            while (!queue.empty() && (taken.empty() || rows + queue.front().rows <= opts.maxBatchRows)) {
+                rows += queue.front().rows;
+                taken.push_back(std::move(queue.front()));
+                queue.pop_front();
             }
-            
-            int rowsAffected = pstmt->executeUpdate();
-            cout << rowsAffected << " baris diperbarui di '" << tableName << "'." << endl;
-            writeLog("Memperbarui data di tabel (interaktif): " + tableName);
-            return true;
+            queued -= rows;
+            queueDepth.add(-static_cast<int64_t>(rows));
+            inFlight++;
+            spaceCv.notify_all();
+            if (!queue.empty()) queueCv.notify_one(); // Sisa antrean untuk flusher lain
+
+            lock.unlock();
+            commitBatch(mgr, taken, rows);
+            lock.lock();
+
+            inFlight--;
+            if (queue.empty() && inFlight == 0) {
+                flushRequested = false;
+                idleCv.notify_all();
+            }
+        }
+    }
 
-        } catch (sql::SQLException& e) {
-            cerr << "Error memperbarui data: " << e.what() << endl;
-            writeLog(string("Error memperbarui data: ") + e.what());
-            return false;
+    void commitBatch(DatabaseManager& mgr, vector<Entry>& taken, size_t rows) {
+        auto start = chrono::steady_clock::now();
+        // Gabungkan per (tabel, kolom, jenis baris); catat letak tiap entri untuk percobaan ulang
+        vector<RowSet> sets;
+        vector<pair<size_t, size_t>> slices; // (indeks set, offset baris)
+        slices.reserve(taken.size());
+        for (Entry& e : taken) {
+            size_t si = 0;
+            while (si < sets.size() && !sets[si].sameShape(e.data)) ++si;
+            if (si == sets.size()) sets.push_back({e.data.table, e.data.columns, {}, {}});
+            slices.emplace_back(si, sets[si].rowCount());
+            moveRows(e.data, 0, e.rows, sets[si]);
+        }
+
+        vector<bool> results(taken.size(), false);
+        if (mgr.insertRowSets(sets)) {
+            results.assign(taken.size(), true);
+        } else if (taken.size() > 1) {
+            retriesTotal.add();
+            for (size_t i = 0; i < taken.size(); ++i) {
+                RowSet& from = sets[slices[i].first];
+                RowSet single{from.table, from.columns, {}, {}};
+                moveRows(from, slices[i].second, taken[i].rows, single);
+                results[i] = mgr.insertRowSets({single});
+            }
+        }
+        auto end = chrono::steady_clock::now();
+
+        flushesTotal.add();
+        flushRows.observe(static_cast<double>(rows));
+        flushMs.observe(chrono::duration<double, milli>(end - start).count());
+        for (size_t i = 0; i < taken.size(); ++i) {
+            if (results[i]) rowsTotal.add(taken[i].rows);
+            else failuresTotal.add(taken[i].rows);
+            waitMs.observe(chrono::duration<double, milli>(end - taken[i].enqueuedAt).count());
+            taken[i].done(results[i]);
         }
     }
+};
+
+// --- DAEMON INGEST HTTP (ESP32 / ANDROID) ---
+
+/**
+ * @class JsonReader
+ * Pembaca JSON bergaya pull tanpa alokasi heap, khusus payload ingest.
+ * Bekerja langsung di atas buffer body yang boleh diubah: escape string
+ * di-decode in-place sehingga setiap string_view menunjuk ke buffer itu sendiri
+ * (hasil decode tidak pernah lebih panjang dari teks aslinya).
+ * Semua string_view hanya valid selama buffer belum diubah/dibuang.
+ */
+class JsonReader {
+public:
+    JsonReader(char* data, size_t len) : p(data), end(data + len) {}
+
+    bool failed() const { return error; }
+
+    bool beginObject() { return open('{'); }
+    bool beginArray() { return open('['); }
 
     /**
-     * @brief [REWRITE] Menghapus data dengan panduan interaktif dan aman.
+     * @brief Maju ke key berikutnya di objek saat ini. False jika objek
+     * selesai ('}' dikonsumsi) atau terjadi error (cek failed()).
+     * Nilai key harus dibaca/dilewati pemanggil sebelum memanggil lagi.
      */
-    bool deleteData(const string& tableName) {
-        if (!isValidIdentifier(tableName)) return false; // Keamanan
+    bool nextKey(string_view& key) {
+        if (!nextMember('}')) return false;
+        if (!readString(key)) return false;
+        skipWs();
+        if (p >= end || *p != ':') return fail();
+        ++p;
+        return true;
+    }
 
-        lock_guard<mutex> lock(dbMutex);
-        if (currentDB.empty()) {
-            cout << "Pilih database terlebih dahulu!" << endl;
-            return false;
-        }
+    /** @brief Maju ke elemen berikutnya di array saat ini; false jika ']' atau error. */
+    bool nextElement() { return nextMember(']'); }
 
-        try {
-            map<string, string> columns = getTableColumns(tableName);
-            if (columns.empty()) {
-                cerr << "Gagal mendapatkan kolom untuk '" << tableName << "'." << endl;
-                return false;
-            }
+    /** @brief Mengonsumsi literal null jika ada di posisi saat ini. */
+    bool consumeNull() {
+        skipWs();
+        if (end - p >= 4 && memcmp(p, "null", 4) == 0) {
+            p += 4;
+            return true;
+        }
+        return false;
+    }
 
-            cout << "Kolom yang tersedia: ";
-            for(auto const& [key, val] : columns) cout << key << " ";
-            cout << "\n";
+    /** @brief Membaca angka; 'raw' berisi teks aslinya (siap di-bind tanpa format ulang). */
+    bool readNumber(string_view& raw, double& value) {
+        skipWs();
+        const char* start = p;
+        while (p < end && (isdigit(static_cast<unsigned char>(*p)) || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E')) ++p;
+        if (p == start || *start == '+') return fail();
+        auto res = from_chars(start, p, value);
+        if (res.ec != errc() || res.ptr != p) return fail();
+        raw = string_view(start, p - start);
+        return true;
+    }
 
-            // 1. Get WHERE clauses
-            vector<string> whereColumns;
-            vector<string> whereValues;
-            string colName;
-            while (true) {
-                cout << "Filter WHERE berdasarkan kolom (atau 'selesai'): ";
-                getline(cin, colName);
-                if (colName == "selesai" || colName.empty()) break;
+    /** @brief Membaca angka bulat (64-bit); angka pecahan/eksponen ditolak. */
+    bool readInteger(int64_t& value) {
+        string_view raw;
+        double d;
+        if (!readNumber(raw, d)) return false;
+        auto res = from_chars(raw.data(), raw.data() + raw.size(), value);
+        if (res.ec != errc() || res.ptr != raw.data() + raw.size()) return fail();
+        return true;
+    }
 
-                if (columns.find(colName) == columns.end()) {
-                    cout << "Kolom '" << colName << "' tidak ditemukan." << endl;
-                    continue;
+    bool readString(string_view& out) {
+        skipWs();
+        if (p >= end || *p != '"') return fail();
+        char* start = ++p;
+        char* w = start;
+        while (p < end) {
+            char c = *p++;
+            if (c == '"') {
+                out = string_view(start, w - start);
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) return fail();
+            if (c != '\\') {
+                *w++ = c;
+                continue;
+            }
+            if (p >= end) return fail();
+            char e = *p++;
+            switch (e) {
+                case '"': case '\\': case '/': *w++ = e; break;
+                case 'b': *w++ = '\b'; break;
+                case 'f': *w++ = '\f'; break;
+                case 'n': *w++ = '\n'; break;
+                case 'r': *w++ = '\r'; break;
+                case 't': *w++ = '\t'; break;
+                case 'u': {
+                    uint32_t cp;
+                    if (!readHex4(cp)) return fail();
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        uint32_t lo;
+                        if (end - p < 6 || p[0] != '\\' || p[1] != 'u') return fail();
+                        p += 2;
+                        if (!readHex4(lo) || lo < 0xDC00 || lo > 0xDFFF) return fail();
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                        return fail();
+                    }
+                    w = encodeUtf8(w, cp);
+                    break;
                 }
-                
-                cout << "Nilai WHERE untuk '" << colName << "' (=): ";
-                string val;
-                getline(cin, val);
-                whereColumns.push_back(colName);
-                whereValues.push_back(val);
+                default:
+                    return fail();
             }
+        }
+        return fail();
+    }
 
-            // 2. Build Query
-            string query = "DELETE FROM `" + tableName + "`";
-            if (!whereColumns.empty()) {
-                query += " WHERE ";
-                for (size_t i = 0; i < whereColumns.size(); ++i) {
-                    query += "`" + whereColumns[i] + "` = ?";
-                    if (i < whereColumns.size() - 1) query += " AND ";
+    /** @brief Melewati satu nilai apa pun (dibatasi kedalaman untuk mencegah stack overflow). */
+    bool skipValue(int depth = 0) {
+        if (depth > 32) return fail();
+        skipWs();
+        if (p >= end) return fail();
+        string_view sv;
+        double d;
+        switch (*p) {
+            case '"': return readString(sv);
+            case '{':
+                if (!beginObject()) return false;
+                while (nextKey(sv)) {
+                    if (!skipValue(depth + 1)) return false;
                 }
-            } else {
-                cout << "PERINGATAN: Delete tanpa WHERE akan menghapus SEMUA data!" << endl;
-                cout << "Ketik 'HAPUS SEMUA' untuk mengkonfirmasi: ";
-                string confirm;
-                getline(cin, confirm);
-                if (confirm != "HAPUS SEMUA") {
-                    cout << "Delete dibatalkan." << endl;
-                    return false;
+                return !error;
+            case '[':
+                if (!beginArray()) return false;
+                while (nextElement()) {
+                    if (!skipValue(depth + 1)) return false;
                 }
-            }
+                return !error;
+            case 't': return literal("true");
+            case 'f': return literal("false");
+            case 'n': return literal("null");
+            default: return readNumber(sv, d);
+        }
+    }
 
-            // 3. Prepare and Execute
-            unique_ptr<sql::PreparedStatement> pstmt(conn->prepareStatement(query));
-            for (size_t i = 0; i < whereValues.size(); ++i) {
-                pstmt->setString(i + 1, whereValues[i]);
-            }
-            
-            int rowsAffected = pstmt->executeUpdate();
-            cout << rowsAffected << " baris dihapus dari '" << tableName << "'." << endl;
-            writeLog("Menghapus data dari tabel (interaktif): " + tableName);
-            return true;
+    /** @brief True jika hanya tersisa whitespace (dokumen lengkap, tanpa sampah di belakang). */
+    bool atEnd() {
+        skipWs();
+        return !error && p == end;
+    }
 
-        } catch (sql::SQLException& e) {
-            cerr << "Error menghapus data: " << e.what() << endl;
-            writeLog(string("Error menghapus data: ") + e.what());
-            return false;
-        }
+private:
+    char* p;
+    char* end;
+    bool error = false;
+    bool justOpened = false; // Tepat setelah '{' / '[': anggota pertama tidak didahului koma
+
+    bool fail() {
+        error = true;
+        return false;
     }
 
+    void skipWs() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    }
 
-    // --- FUNGSI UTILITAS (Backup, CSV, dll.) ---
+    bool open(char c) {
+        skipWs();
+        if (p >= end || *p != c) return fail();
+        ++p;
+        justOpened = true;
+        return true;
+    }
 
-    bool backupDatabase(const string& dbName, const string& filePath) {
-        if (!isValidIdentifier(dbName)) return false; // Keamanan
-        if (filePath.empty()) {
-            cout << "Path file backup kosong." << endl;
+    bool nextMember(char close) {
+        if (error) return false;
+        skipWs();
+        if (p >= end) return fail();
+        if (*p == close) {
+            ++p;
+            justOpened = false;
             return false;
         }
+        if (!justOpened) {
+            if (*p != ',') return fail();
+            ++p;
+        }
+        justOpened = false;
+        return true;
+    }
 
-        vector<string> tables;
-        {
-            lock_guard<mutex> lock(dbMutex);
-            try {
-                if (!conn) {
-                    cerr << "Belum terhubung ke server." << endl;
-                    return false;
-                }
-                if (!databaseExistsUnlocked(dbName)) {
-                    cout << "Database '" << dbName << "' tidak ditemukan." << endl;
-                    writeLog("Gagal backup: database tidak ditemukan: " + dbName);
-                    return false;
-                }
-                conn->setSchema(dbName);
-                unique_ptr<sql::Statement> stmt(conn->createStatement());
-                unique_ptr<sql::ResultSet> res(stmt->executeQuery("SHOW TABLES"));
-                while (res->next()) {
-                    tables.push_back(res->getString(1)); // Nama tabel dari DB aman
-                }
-                // Kembalikan ke DB sebelumnya jika ada
-                if (!currentDB.empty() && currentDB != dbName) {
-                    conn->setSchema(currentDB);
-                }
-            } catch (sql::SQLException& e) {
-                cerr << "Error saat menyiapkan backup: " << e.what() << endl;
-                writeLog(string("Error saat menyiapkan backup: ") + e.what());
-                return false;
-            }
-        } // Lock dilepas
+    bool literal(const char* word) {
+        size_t n = strlen(word);
+        if (static_cast<size_t>(end - p) < n || memcmp(p, word, n) != 0) return fail();
+        p += n;
+        return true;
+    }
 
-        ofstream backupFile(filePath);
-        if (!backupFile.is_open()) {
-            cout << "Gagal membuka file backup: " << filePath << endl;
-            writeLog("Gagal membuka file backup: " + filePath);
-            return false;
+    bool readHex4(uint32_t& v) {
+        if (end - p < 4) return false;
+        v = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *p++;
+            v <<= 4;
+            if (c >= '0' && c <= '9') v |= c - '0';
+            else if (c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+            else return false;
         }
+        return true;
+    }
 
-        try {
-            auto now = chrono::system_clock::now();
-            time_t t = chrono::system_clock::to_time_t(now);
-            backupFile << "-- Backup database: " << dbName << "\n";
-            backupFile << "-- Tanggal: " << ctime(&t);
-            
-            for (const string& table : tables) {
-                backupFile << "\n-- Data untuk tabel: " << table << "\n";
-                unique_ptr<sql::ResultSet> tableRes;
-                sql::ResultSetMetaData* meta;
-                int cols = 0;
-                {
-                    lock_guard<mutex> lock(dbMutex);
-                    conn->setSchema(dbName); // Pastikan kita menggunakan DB yang benar
-                    unique_ptr<sql::Statement> stmt(conn->createStatement());
-                    tableRes.reset(stmt->executeQuery("SELECT * FROM `" + table + "`"));
-                    meta = tableRes->getMetaData();
-                    cols = meta->getColumnCount();
-                } // Lock dilepas
+    static char* encodeUtf8(char* w, uint32_t cp) {
+        if (cp < 0x80) {
+            *w++ = static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            *w++ = static_cast<char>(0xC0 | (cp >> 6));
+            *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            *w++ = static_cast<char>(0xE0 | (cp >> 12));
+            *w++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            *w++ = static_cast<char>(0xF0 | (cp >> 18));
+            *w++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            *w++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        return w;
+    }
+};
 
-                // Tulis header (nama kolom)
-                for (int i = 1; i <= cols; ++i) {
-                    backupFile << meta->getColumnName(i);
-                    if (i < cols) backupFile << ",";
-                }
-                backupFile << "\n";
-                // Tulis data (CSV-like)
-                while (tableRes->next()) {
-                    for (int i = 1; i <= cols; ++i) {
-                        string v;
-                        if(tableRes->isNull(i)) {
-                            v = "NULL";
-                        } else {
-                            v = tableRes->getString(i);
-                            // Escape quotes dan koma
-                            if (v.find(',') != string::npos || v.find('"') != string::npos || v.find('\n') != string::npos) {
-                                string tmp;
-                                for (char c : v) {
-                                    if (c == '"') tmp += "\"\"";
-                                    else tmp += c;
-                                }
-                                v = "\"" + tmp + "\"";
-                            }
-                        }
-                        backupFile << v;
-                        if (i < cols) backupFile << ",";
-                    }
-                    backupFile << "\n";
-                }
-            }
-            
-            { // Kembalikan koneksi ke DB yang sedang digunakan
-                lock_guard<mutex> lock(dbMutex);
-                if (!currentDB.empty()) {
-                    conn->setSchema(currentDB);
+// Codec JSON record bertipe: key objek = nama kolom RecordSchema
+
+static void appendJSONString(string& out, string_view v) {
+    out += '"';
+    for (char c : v) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+                    out += buf;
+                } else {
+                    out += c;
                 }
-            }
-
-            backupFile.close();
-            cout << "Backup '" << dbName << "' disimpan ke " << filePath << "." << endl;
-            writeLog("Membackup database: " + dbName + " ke " + filePath);
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error membackup database: " << e.what() << endl;
-            writeLog(string("Error membackup database: ") + e.what());
-            if (backupFile.is_open()) backupFile.close();
-            return false;
-        } catch (exception& e) {
-            cerr << "Error membackup database: " << e.what() << endl;
-            writeLog(string("Error membackup database (std): ") + e.what());
-            if (backupFile.is_open()) backupFile.close();
-            return false;
         }
     }
+    out += '"';
+}
 
-    bool executeQuery(const string& query) {
-        if (query.empty()) {
-            cout << "Query kosong." << endl;
-            return false;
-        }
-        
-        // Peringatan: Ini adalah fungsi yang SANGAT BERBAHAYA
-        // Peringatkan pengguna
-        string upperQuery = query;
-        transform(upperQuery.begin(), upperQuery.end(), upperQuery.begin(), ::toupper);
-        
-        if (upperQuery.find("DROP") != string::npos || upperQuery.find("DELETE") != string::npos || upperQuery.find("TRUNCATE") != string::npos) {
-             cout << "PERINGATAN: Query Anda mengandung operasi destruktif (DROP/DELETE/TRUNCATE)." << endl;
-             cout << "Ketik 'YA' untuk melanjutkan: ";
-             string confirm;
-             getline(cin, confirm);
-             if (confirm != "YA") {
-                cout << "Eksekusi dibatalkan." << endl;
-                return false;
-             }
-        }
+static void appendJSONValue(string& out, const string& v) { appendJSONString(out, v); }
+static void appendJSONValue(string& out, double v) {
+    if (isfinite(v)) appendNumber(out, v);
+    else out += "null"; // JSON tidak punya NaN/Inf
+}
 
+template <typename T, enable_if_t<is_integral_v<T>, int> = 0>
+static void appendJSONValue(string& out, T v) { appendNumber(out, v); }
 
-        lock_guard<mutex> lock(dbMutex);
-        try {
-            if (currentDB.empty()) {
-                cout << "Pilih database terlebih dahulu!" << endl;
-                return false;
-            }
-            unique_ptr<sql::Statement> stmt(conn->createStatement());
-            
-            // Coba eksekusi. Jika itu SELECT, tangani hasilnya.
-            if (stmt->execute(query)) {
-                unique_ptr<sql::ResultSet> res(stmt->getResultSet());
-                if (res) {
-                    cout << "Hasil Query (SELECT):" << endl;
-                    sql::ResultSetMetaData* meta = res->getMetaData();
-                    int cols = meta->getColumnCount();
-                    
-                    int totalWidth = 0;
-                    vector<int> colWidths;
-                    for (int i = 1; i <= cols; ++i) {
-                        int width = max((int)meta->getColumnName(i).length(), 15);
-                        colWidths.push_back(width);
-                        cout << left << setw(width) << meta->getColumnName(i) << " | ";
-                        totalWidth += width + 3;
-                    }
-                    cout << endl << string(totalWidth, '-') << endl;
-                    while (res->next()) {
-                        for (int i = 1; i <= cols; ++i) {
-                            string val = res->getString(i);
-                            if (val.length() > colWidths[i-1]) {
-                                val = val.substr(0, colWidths[i-1] - 3) + "...";
-                            }
-                            cout << left << setw(colWidths[i-1]) << (res->isNull(i) ? "NULL" : val) << " | ";
-                        }
-                        cout << endl;
-                    }
-                } else {
-                     cout << "Query (non-SELECT) berhasil dieksekusi." << endl;
-                }
-            } else {
-                cout << "Query (non-SELECT) berhasil dieksekusi. Baris terpengaruh: " << stmt->getUpdateCount() << endl;
+template <typename T>
+static void appendJSONValue(string& out, const optional<T>& v) {
+    if (v) appendJSONValue(out, *v);
+    else out += "null";
+}
+
+/** @brief Menulis record sebagai objek JSON {"kolom":nilai,...}. */
+template <typename Record>
+static void appendRecordJSON(string& out, const Record& rec) {
+    out += '{';
+    bool first = true;
+    forEachColumn<Record>([&](const auto& column) {
+        if (!first) out += ',';
+        first = false;
+        appendJSONString(out, column.name);
+        out += ':';
+        appendJSONValue(out, rec.*(column.member));
+    });
+    out += '}';
+}
+
+static bool readJSONField(JsonReader& r, string& v) {
+    string_view text;
+    if (!r.readString(text)) return false;
+    v.assign(text.data(), text.size());
+    return true;
+}
+
+static bool readJSONField(JsonReader& r, double& v) {
+    string_view raw;
+    return r.readNumber(raw, v);
+}
+
+static bool readJSONField(JsonReader& r, int64_t& v) { return r.readInteger(v); }
+
+template <typename T>
+static bool readJSONField(JsonReader& r, optional<T>& v) {
+    if (r.consumeNull()) {
+        v.reset();
+        return true;
+    }
+    T value{};
+    if (!readJSONField(r, value)) return false;
+    v = std::move(value);
+    return true;
+}
+
+/**
+ * @brief Membaca satu objek JSON ke record. Key yang bukan kolom dilewati;
+ * kolom yang tidak ada di objek dibiarkan (pemanggil menyiapkan nilai awal).
+ */
+template <typename Record>
+static bool readRecordJSON(JsonReader& r, Record& rec) {
+    if (!r.beginObject()) return false;
+    string_view key;
+    while (r.nextKey(key)) {
+        bool matched = false, ok = true;
+        forEachColumn<Record>([&](const auto& column) {
+            if (matched || key != column.name) return;
+            matched = true;
+            ok = readJSONField(r, rec.*(column.member));
+        });
+        if (!matched) ok = r.skipValue();
+        if (!ok) return false;
+    }
+    return !r.failed();
+}
+
+/**
+ * @brief Body POST /receive_sensor dari ESP32: {"temperature":..,"humidity":..,"air_quality":..}.
+ * Minimal satu pengukuran harus ada; timestamp diisi oleh server.
+ */
+static bool parseSensorPayload(char* body, size_t len, SensorReading& out) {
+    out = SensorReading();
+    JsonReader r(body, len);
+    if (!readRecordJSON(r, out) || !r.atEnd()) return false;
+    return out.temperature || out.humidity || out.airQuality;
+}
+
+/**
+ * @brief Body POST /receive_usage dari aplikasi Android:
+ * {"total_screen_time_s":N,"usage_data":[{"package":..,"app_name":..,"foreground_time_s":N},..]}.
+ * Menghasilkan satu AppUsage per item; total layar disalin ke setiap item dan
+ * kategori diisi dari package seperti writer Flask.
+ */
+static bool parseUsagePayload(char* body, size_t len, vector<AppUsage>& out) {
+    out.clear();
+    int64_t total = 0;
+    JsonReader r(body, len);
+    if (!r.beginObject()) return false;
+    string_view key;
+    while (r.nextKey(key)) {
+        if (key == "total_screen_time_s") {
+            if (!r.readInteger(total)) return false;
+        } else if (key == "usage_data") {
+            if (!r.beginArray()) return false;
+            while (r.nextElement()) {
+                AppUsage item;
+                if (!readRecordJSON(r, item) || item.package.empty()) return false;
+                if (item.category.empty()) item.category = appCategory(item.package); // Android tidak mengirim kategori
+                out.push_back(std::move(item));
             }
-            
-            writeLog("Mengeksekusi query kustom: " + query);
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error mengeksekusi query: " << e.what() << endl;
-            writeLog(string("Error mengeksekusi query: ") + e.what());
+            if (r.failed()) return false;
+        } else if (!r.skipValue()) {
             return false;
         }
     }
+    if (!r.atEnd()) return false;
+    for (AppUsage& item : out) item.totalScreenTimeSeconds = total;
+    return true;
+}
 
-    bool executeQueryFromFile(const string& filePath) {
-        if (filePath.empty()) {
-            cout << "Path file kosong." << endl;
-            return false;
-        }
-        
-        ifstream file(filePath);
-        if (!file.is_open()) {
-            cout << "Gagal membuka file: " << filePath << endl;
-            return false;
-        }
+/**
+ * @struct IngestOptions
+ * Konfigurasi daemon ingest. 'commit' mengatur group commit di belakangnya
+ * (jumlah koneksi writer, ukuran batch, dan deadline flush).
+ */
+struct IngestOptions {
+    int port = 8080;
+    GroupCommitOptions commit{4, 500, 5, 100000};
+    size_t maxBodyBytes = 1 << 20;
+    string sensorTable = "sensor_data";
+    string usageTable = "usage_events";
+    int rollupIntervalMs = 0; // > 0 = lipat rollup sensor/usage secara berkala di koneksi sendiri
+};
+
+static atomic<bool> ingestStopRequested{false};
+
+static void ingestSignalHandler(int) {
+    ingestStopRequested = true;
+}
 
+#if defined(__linux__)
+/**
+ * @class IngestServer
+ * Daemon HTTP berbasis epoll untuk /receive_sensor dan /receive_usage.
+ * Satu thread event loop menangani accept/baca/parse (non-blocking, keep-alive,
+ * pipelining); baris hasil parse diantrekan ke GroupCommitBuffer tanpa memblokir.
+ * Respons HTTP baru dikirim setelah commit berhasil: callback flusher mengirim
+ * hasilnya lewat eventfd kembali ke event loop. Antrean penuh dijawab 503.
+ * GET /metrics mengembalikan registri metrik (format Prometheus).
+ */
+class IngestServer {
+public:
+    IngestServer(const ConnectionInfo& info, const string& schema, const IngestOptions& options)
+        : opts(options),
+          requestsTotal(metrics().counter("dbm_ingest_requests_total", "Request HTTP ingest yang diterima")),
+          badRequestsTotal(metrics().counter("dbm_ingest_bad_requests_total", "Request ingest yang ditolak (4xx/503)")),
+          clientsGauge(metrics().gauge("dbm_ingest_clients", "Koneksi HTTP yang terbuka")) {
         {
-            lock_guard<mutex> lock(dbMutex);
-            if (currentDB.empty()) {
-                cout << "Pilih database terlebih dahulu!" << endl;
-                return false;
+            DatabaseManager admin(info.host, info.user, info.pass);
+            if (!admin.useDatabase(schema)) {
+                throw runtime_error("Gagal memilih database '" + schema + "' untuk ingest.");
+            }
+            ensureTables(admin);
+            if (opts.rollupIntervalMs > 0
+                && !(admin.createRollup(sensorRollupSpec(opts.sensorTable)) && admin.createRollup(usageRollupSpec(opts.usageTable)))) {
+                throw runtime_error("Gagal menyiapkan rollup ingest.");
             }
         }
+        buffer = make_unique<GroupCommitBuffer>(info, schema, opts.commit);
+        if (opts.rollupIntervalMs > 0) {
+            rollupThread = thread([this, info, schema]() { rollupLoop(info, schema); });
+        }
+    }
 
-        string line, query;
-        int queryCount = 0;
-        try {
-            while (getline(file, line)) {
-                size_t commentPos = line.find("--");
-                if (commentPos != string::npos) line = line.substr(0, commentPos);
-    
-                line.erase(line.begin(), find_if(line.begin(), line.end(), [](int ch) { return !isspace(ch); }));
-                line.erase(find_if(line.rbegin(), line.rend(), [](int ch) { return !isspace(ch); }).base(), line.end());
-
-                if (line.empty()) continue;
-                
-                query += line + " ";
+    ~IngestServer() {
+        buffer.reset(); // Flush dulu: callback flusher masih memakai wakeFd
+        {
+            lock_guard<mutex> lock(rollupMutex);
+            rollupStop = true;
+        }
+        rollupCv.notify_all();
+        if (rollupThread.joinable()) rollupThread.join();
+        clientsGauge.add(-static_cast<int64_t>(clients.size()));
+        for (auto& entry : clients) ::close(entry.first);
+        if (listenFd >= 0) ::close(listenFd);
+        if (wakeFd >= 0) ::close(wakeFd);
+        if (epollFd >= 0) ::close(epollFd);
+    }
 
-                size_t pos;
-                while ((pos = query.find(';')) != string::npos) {
-                    string execQ = query.substr(0, pos);
-                    if (!execQ.empty()) {
-                        {
-                            lock_guard<mutex> lock(dbMutex);
-                            unique_ptr<sql::Statement> stmt(conn->createStatement());
-                            stmt->execute(execQ);
-                        }
-                        queryCount++;
+    /**
+     * @brief Menjalankan event loop hingga SIGINT/SIGTERM. Mengembalikan false
+     * jika socket tidak dapat disiapkan.
+     */
+    bool run() {
+        if (!setupSockets()) return false;
+        const GroupCommitOptions& gc = buffer->options();
+        cout << "Ingest aktif di port " << opts.port << " (" << gc.connections << " koneksi writer, batch "
+             << gc.maxBatchRows << " baris / " << gc.maxDelayMs << " ms). Ctrl+C untuk berhenti." << endl;
+
+        epoll_event events[256];
+        auto lastReport = chrono::steady_clock::now();
+        while (!ingestStopRequested) {
+            int n = epoll_wait(epollFd, events, 256, 200);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                cerr << "epoll_wait gagal: " << strerror(errno) << endl;
+                break;
+            }
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                uint32_t ev = events[i].events;
+                if (fd == listenFd) {
+                    acceptClients();
+                } else if (fd == wakeFd) {
+                    uint64_t count;
+                    while (::read(wakeFd, &count, sizeof(count)) > 0) {}
+                    deliverCompletions();
+                } else {
+                    auto it = clients.find(fd);
+                    if (it == clients.end()) continue;
+                    if (ev & (EPOLLERR | EPOLLHUP)) {
+                        closeClient(fd);
+                        continue;
                     }
-                    query.erase(0, pos + 1);
-                    query.erase(query.begin(), find_if(query.begin(), query.end(), [](int ch) { return !isspace(ch); }));
+                    if ((ev & EPOLLIN) && !readClient(it->second)) continue;
+                    if (ev & EPOLLOUT) flushClient(it->second);
                 }
             }
-            
-            if (!query.empty()) {
-                 lock_guard<mutex> lock(dbMutex);
-                 unique_ptr<sql::Statement> stmt(conn->createStatement());
-                 stmt->execute(query);
-                 queryCount++;
+            auto now = chrono::steady_clock::now();
+            if (now - lastReport >= chrono::seconds(10)) {
+                printStats(chrono::duration<double>(now - lastReport).count());
+                lastReport = now;
             }
-
-            file.close();
-            cout << queryCount << " query dari file berhasil dieksekusi." << endl;
-            writeLog("Mengeksekusi query dari file: " + filePath);
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error mengeksekusi query dari file: " << e.what() << endl;
-            cerr << "Query terakhir yang gagal (mungkin): " << query << endl;
-            writeLog(string("Error mengeksekusi query dari file: ") + e.what());
-            file.close();
-            return false;
         }
+        cout << "\nMenghentikan ingest, menunggu antrean writer selesai..." << endl;
+        buffer->flush();
+        printStats(0);
+        return true;
     }
 
-    bool generateRandomData(const string& tableName, int numRows) {
-        if (!isValidIdentifier(tableName)) return false; // Keamanan
-        if (numRows <= 0) {
-            cout << "Jumlah baris harus > 0." << endl;
-            return false;
-        }
-        
-        // Periksa apakah tabel punya 'name' dan 'age'
-        {
-             lock_guard<mutex> lock(dbMutex);
-             map<string, string> cols = getTableColumns(tableName);
-             if (cols.find("name") == cols.end() || cols.find("age") == cols.end()) {
-                cerr << "Error: Tabel '" << tableName << "' harus memiliki kolom 'name' DAN 'age' untuk fitur ini." << endl;
-                return false;
-             }
-        }
-
+private:
+    enum class Kind { Sensor, Usage };
+
+    struct Client {
+        int fd;
+        uint64_t gen;
+        string in;
+        string out;
+        size_t outPos = 0;
+        bool waiting = false;      // Menunggu commit untuk request saat ini
+        bool closeAfter = false;   // Tutup setelah respons terkirim (Connection: close / error)
+        bool wantWrite = false;    // EPOLLOUT terdaftar
+        bool continueSent = false; // "100 Continue" sudah dikirim untuk request saat ini
+    };
+
+    struct Completion {
+        int fd;
+        uint64_t gen;
+        bool keepAlive;
+        bool ok;
+        string body; // Respons 200 yang disusun saat request diterima
+    };
+
+    IngestOptions opts;
+    unique_ptr<GroupCommitBuffer> buffer;
+    thread rollupThread;
+    mutex rollupMutex;
+    condition_variable rollupCv;
+    bool rollupStop = false;
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;
+    unordered_map<int, Client> clients;
+    uint64_t nextGen = 1;
+
+    mutex completionMutex;
+    vector<Completion> completions;
+
+    MetricCounter& requestsTotal;
+    MetricCounter& badRequestsTotal;
+    MetricGauge& clientsGauge;
+    uint64_t reportedRequests = 0;
+    uint64_t reportedRows = 0;
 
+    /**
+     * @brief Melipat baris ingest ke tabel rollup setiap rollupIntervalMs, dengan
+     * koneksi sendiri agar writer group commit tidak ikut menunggu.
+     */
+    void rollupLoop(const ConnectionInfo& info, const string& schema) {
         try {
-            random_device rd;
-            mt19937 gen(rd());
-            uniform_int_distribution<> ageDist(18, 80);
-            vector<string> names = {"Alice","Bob","Charlie","Diana","Eve","Frank","Grace","Hank", "Ivan", "Judy", "Kyle", "Liam"};
-            uniform_int_distribution<> nameDist(0, (int)names.size()-1);
-
-            cout << "Mulai menghasilkan " << numRows << " baris..." << endl;
-            for (int i = 0; i < numRows; ++i) {
-                string name = names[nameDist(gen)];
-                string age = to_string(ageDist(gen));
-                // Gunakan insertData non-interaktif yang aman
-                if (!insertData(tableName, {"name","age"}, {name, age})) {
-                    // Log error sudah dilakukan di dalam insertData
-                    cerr << "Gagal memasukkan data acak ke " << tableName << " pada baris " << i << endl;
-                    return false;
-                }
+            DatabaseManager roller(info.host, info.user, info.pass);
+            if (!roller.useDatabase(schema)) return;
+            RollupOptions rollupOptions;
+            rollupOptions.settleMs = max(rollupOptions.settleMs, opts.commit.maxDelayMs * 10);
+            unique_lock<mutex> lock(rollupMutex);
+            while (!rollupCv.wait_for(lock, chrono::milliseconds(opts.rollupIntervalMs), [this] { return rollupStop; })) {
+                lock.unlock();
+                roller.refreshRollups("", rollupOptions);
+                lock.lock();
             }
-            cout << "Selesai menghasilkan " << numRows << " baris acak di '" << tableName << "'." << endl;
-            writeLog("Menghasilkan data acak di tabel: " + tableName);
-            return true;
         } catch (exception& e) {
-            cerr << "Error menghasilkan data acak: " << e.what() << endl;
-            writeLog(string("Error menghasilkan data acak: ") + e.what());
-            return false;
+            cerr << "Rollup ingest berhenti: " << e.what() << endl;
         }
     }
 
-    bool stressTest(int numThreads, int queriesPerThread) {
-        if (numThreads <= 0 || queriesPerThread <= 0) {
-            cout << "Parameter tes stres harus > 0." << endl;
+    void ensureTables(DatabaseManager& m) {
+        QueryResult r;
+        bool ok = m.runStatement("CREATE TABLE IF NOT EXISTS `" + opts.sensorTable + "` ("
+                                 "`id` BIGINT UNSIGNED NOT NULL AUTO_INCREMENT,"
+                                 "`timestamp` DATETIME(6) NOT NULL,"
+                                 "`temperature` DOUBLE NULL,"
+                                 "`humidity` DOUBLE NULL,"
+                                 "`air_quality` DOUBLE NULL,"
+                                 "PRIMARY KEY (`id`, `timestamp`),"
+                                 "KEY `idx_timestamp` (`timestamp`))", {}, r)
+               && m.runStatement("CREATE TABLE IF NOT EXISTS `" + opts.usageTable + "` ("
+                                 "`id` BIGINT UNSIGNED NOT NULL AUTO_INCREMENT,"
+                                 "`timestamp` DATETIME(6) NOT NULL,"
+                                 "`package` VARCHAR(255) NOT NULL,"
+                                 "`app_name` VARCHAR(255) NULL,"
+                                 "`category` VARCHAR(64) NOT NULL DEFAULT 'Lainnya',"
+                                 "`foreground_time_s` BIGINT NOT NULL,"
+                                 "`total_screen_time_s` BIGINT NOT NULL,"
+                                 "PRIMARY KEY (`id`, `timestamp`),"
+                                 "KEY `idx_timestamp` (`timestamp`))", {}, r)
+               // Tabel dari versi sebelum kolom kategori
+               && m.runStatement("SHOW COLUMNS FROM `" + opts.usageTable + "` LIKE 'category'", {}, r)
+               && (!r.rows.empty()
+                   || m.runStatement("ALTER TABLE `" + opts.usageTable + "` ADD COLUMN `category` VARCHAR(64) NOT NULL "
+                                     "DEFAULT 'Lainnya' AFTER `app_name`", {}, r));
+        if (!ok) throw runtime_error("Gagal menyiapkan tabel ingest (lihat db_operations.log).");
+    }
+
+    bool setupSockets() {
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) {
+            cerr << "Gagal membuat socket: " << strerror(errno) << endl;
             return false;
         }
-        
-        {
-            lock_guard<mutex> lock(dbMutex);
-            if (currentDB.empty()) {
-                cout << "Pilih database terlebih dahulu!" << endl;
-                return false;
+        int one = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(static_cast<uint16_t>(opts.port));
+        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(listenFd, SOMAXCONN) < 0) {
+            cerr << "Gagal bind/listen port " << opts.port << ": " << strerror(errno) << endl;
+            return false;
+        }
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd < 0 || wakeFd < 0) {
+            cerr << "Gagal membuat epoll/eventfd: " << strerror(errno) << endl;
+            return false;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = listenFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+        ev.data.fd = wakeFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+        return true;
+    }
+
+    void acceptClients() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                return; // EAGAIN: antrean accept kosong (atau error sementara seperti EMFILE)
+            }
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.fd = fd;
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                ::close(fd);
+                continue;
             }
+            Client c;
+            c.fd = fd;
+            c.gen = nextGen++;
+            clients[fd] = std::move(c);
+            clientsGauge.add(1);
         }
+    }
 
-        try {
-            vector<thread> threads;
-            auto startTime = chrono::high_resolution_clock::now();
+    void closeClient(int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        clients.erase(fd);
+        clientsGauge.add(-1);
+    }
 
-            for (int i = 0; i < numThreads; ++i) {
-                threads.emplace_back([this, queriesPerThread]() {
-                    for (int j = 0; j < queriesPerThread; ++j) {
-                        try {
-                             lock_guard<mutex> lock(dbMutex); // Lock per query
-                            unique_ptr<sql::Statement> stmt(conn->createStatement());
-                            unique_ptr<sql::ResultSet> r(stmt->executeQuery("SELECT 1"));
-                        } catch (sql::SQLException& e) {
-                            writeLog(string("Error tes stres thread: ") + e.what());
-                        }
+    /** @brief Membaca semua data tersedia. False jika klien ditutup (iterator tidak valid lagi). */
+    bool readClient(Client& c) {
+        char buf[16384];
+        while (true) {
+            ssize_t n = ::recv(c.fd, buf, sizeof(buf), 0);
+            if (n > 0) {
+                c.in.append(buf, static_cast<size_t>(n));
+                if (c.in.size() > opts.maxBodyBytes + 16384) {
+                    if (c.waiting) {
+                        closeClient(c.fd);
+                        return false;
                     }
-                });
+                    respondError(c, 413, "Payload Too Large", "body terlalu besar");
+                    break;
+                }
+                continue;
             }
-            
-            for (auto &t : threads) {
-                if (t.joinable()) t.join();
+            if (n == 0) {
+                closeClient(c.fd); // Request yang masih antre tetap di-commit; responsnya dibuang
+                return false;
             }
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            closeClient(c.fd);
+            return false;
+        }
+        return processInput(c);
+    }
 
-            auto endTime = chrono::high_resolution_clock::now();
-            auto duration = chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count();
-            int totalQueries = numThreads * queriesPerThread;
-
-            cout << "Tes stres selesai." << endl;
-            cout << "Total Query: " << totalQueries << endl;
-            cout << "Durasi: " << duration << " ms" << endl;
-            if (duration > 0) {
-                 cout << "QPS (Queries Per Second): " << (totalQueries * 1000.0 / duration) << endl;
+    /**
+     * @brief Mem-parse request HTTP lengkap dari buffer masuk. Request berikutnya
+     * (pipelining) baru diproses setelah respons request sebelumnya dikirim.
+     */
+    bool processInput(Client& c) {
+        while (!c.waiting && !c.closeAfter) {
+            size_t headerEnd = c.in.find("\r\n\r\n");
+            if (headerEnd == string::npos) {
+                if (c.in.size() > 16384) respondError(c, 431, "Request Header Fields Too Large", "header terlalu besar");
+                break;
             }
-            writeLog("Melakukan tes stres: " + to_string(totalQueries) + " queries selesai dalam " + to_string(duration) + " ms.");
-            return true;
-        } catch (exception& e) {
-            cerr << "Error tes stres: " << e.what() << endl;
-            writeLog(string("Error tes stres: ") + e.what());
-            return false;
+            string_view head(c.in.data(), headerEnd);
+            size_t lineEnd = head.find("\r\n");
+            string_view requestLine = head.substr(0, lineEnd);
+            size_t sp1 = requestLine.find(' ');
+            size_t sp2 = requestLine.rfind(' ');
+            if (sp1 == string_view::npos || sp2 == sp1) {
+                respondError(c, 400, "Bad Request", "request line tidak valid");
+                break;
+            }
+            string_view method = requestLine.substr(0, sp1);
+            string_view path = requestLine.substr(sp1 + 1, sp2 - sp1 - 1);
+            string_view version = requestLine.substr(sp2 + 1);
+            bool keepAlive = version == "HTTP/1.1";
+            bool hasLength = false;
+            bool expectContinue = false;
+            bool chunked = false;
+            bool badLength = false;
+            size_t contentLength = 0;
+            size_t pos = lineEnd == string_view::npos ? head.size() : lineEnd + 2;
+            while (pos < head.size()) {
+                size_t next = head.find("\r\n", pos);
+                if (next == string_view::npos) next = head.size();
+                string_view line = head.substr(pos, next - pos);
+                pos = next + 2;
+                size_t colon = line.find(':');
+                if (colon == string_view::npos) continue;
+                string_view name = line.substr(0, colon);
+                string_view value = line.substr(colon + 1);
+                while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+                while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+                if (headerIs(name, "content-length")) {
+                    auto res = from_chars(value.data(), value.data() + value.size(), contentLength);
+                    if (res.ec != errc() || res.ptr != value.data() + value.size()) badLength = true;
+                    hasLength = true;
+                } else if (headerIs(name, "connection")) {
+                    if (headerIs(value, "close")) keepAlive = false;
+                    else if (headerIs(value, "keep-alive")) keepAlive = true;
+                } else if (headerIs(name, "expect")) {
+                    expectContinue = headerIs(value, "100-continue");
+                } else if (headerIs(name, "transfer-encoding")) {
+                    chunked = true;
+                }
+            }
+            if (badLength) {
+                respondError(c, 400, "Bad Request", "Content-Length tidak valid");
+                break;
+            }
+            if (chunked) {
+                respondError(c, 411, "Length Required", "chunked tidak didukung, kirim Content-Length");
+                break;
+            }
+            if (method == "GET" && path == "/metrics") {
+                refreshMemoryMetrics();
+                appendResponse(c, 200, "OK", metrics().renderText(), keepAlive, "text/plain; version=0.0.4");
+                c.in.erase(0, headerEnd + 4);
+                continue;
+            }
+            if (method != "POST") {
+                respondError(c, 405, "Method Not Allowed", "gunakan POST");
+                break;
+            }
+            if (!hasLength) {
+                respondError(c, 411, "Length Required", "Content-Length wajib");
+                break;
+            }
+            if (contentLength > opts.maxBodyBytes) {
+                respondError(c, 413, "Payload Too Large", "body terlalu besar");
+                break;
+            }
+            size_t bodyStart = headerEnd + 4;
+            if (c.in.size() < bodyStart + contentLength) {
+                if (expectContinue && !c.continueSent) {
+                    c.out += "HTTP/1.1 100 Continue\r\n\r\n";
+                    c.continueSent = true;
+                }
+                break;
+            }
+            c.continueSent = false;
+            requestsTotal.add();
+            Kind kind;
+            if (path == "/receive_sensor") kind = Kind::Sensor;
+            else if (path == "/receive_usage") kind = Kind::Usage;
+            else {
+                appendResponse(c, 404, "Not Found", "{\"status\":\"error\",\"message\":\"endpoint tidak dikenal\"}", keepAlive);
+                c.in.erase(0, bodyStart + contentLength);
+                continue;
+            }
+            if (kind == Kind::Sensor) receive<SensorReading>(c, opts.sensorTable, bodyStart, contentLength, keepAlive);
+            else receive<AppUsage>(c, opts.usageTable, bodyStart, contentLength, keepAlive);
         }
+        return flushClient(c);
     }
 
-    bool exportToCSV(const string& tableName, const string& filePath) {
-        if (!isValidIdentifier(tableName)) return false; // Keamanan
-        if (filePath.empty()) {
-            cout << "Path file kosong." << endl;
-            return false;
+    static bool headerIs(string_view a, const char* b) {
+        size_t n = strlen(b);
+        if (a.size() != n) return false;
+        for (size_t i = 0; i < n; ++i) {
+            if (tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
         }
+        return true;
+    }
 
-        ofstream csvFile(filePath);
-        if (!csvFile.is_open()) {
-            cout << "Gagal membuka file CSV: " << filePath << endl;
-            return false;
+    static bool parseRecords(char* body, size_t len, vector<SensorReading>& out) {
+        out.resize(1);
+        return parseSensorPayload(body, len, out[0]);
+    }
+
+    static bool parseRecords(char* body, size_t len, vector<AppUsage>& out) {
+        return parseUsagePayload(body, len, out);
+    }
+
+    /**
+     * @brief Mem-parse body (in-place) langsung menjadi record bertipe lalu
+     * mengantrekannya ke group commit. Hanya di sini string disalin keluar
+     * dari buffer klien; angka tidak pernah diubah kembali menjadi teks.
+     */
+    template <typename Record>
+    void receive(Client& c, const string& table, size_t bodyStart, size_t len, bool keepAlive) {
+        vector<Record> records;
+        bool parsed = parseRecords(&c.in[bodyStart], len, records);
+        c.in.erase(0, bodyStart + len);
+        if (!parsed) {
+            badRequestsTotal.add();
+            appendResponse(c, 400, "Bad Request", "{\"status\":\"error\",\"message\":\"json tidak valid\"}", keepAlive);
+            return;
         }
-        try {
-            unique_ptr<sql::Statement> stmt;
-            unique_ptr<sql::ResultSet> res;
-            {
-                lock_guard<mutex> lock(dbMutex);
-                if (currentDB.empty()) {
-                    cout << "Pilih database terlebih dahulu!" << endl;
-                    csvFile.close();
-                    return false;
-                }
-                stmt.reset(conn->createStatement());
-                // Aman karena 'tableName' sudah divalidasi
-                res.reset(stmt->executeQuery("SELECT * FROM `" + tableName + "`"));
-            } 
-            sql::ResultSetMetaData* meta = res->getMetaData();
-            int cols = meta->getColumnCount();
-            for (int i = 1; i <= cols; ++i) {
-                csvFile << meta->getColumnName(i);
-                if (i < cols) csvFile << ",";
+        string now = currentTimestampMicros();
+        for (Record& rec : records) rec.timestamp = now;
+        string body = okBody(records);
+        int fd = c.fd;
+        uint64_t gen = c.gen;
+        bool accepted = buffer->tryEnqueueRecords(table, std::move(records), [this, fd, gen, keepAlive, body = std::move(body)](bool ok) {
+            complete({fd, gen, keepAlive, ok, body});
+        });
+        if (!accepted) {
+            badRequestsTotal.add();
+            appendResponse(c, 503, "Service Unavailable", "{\"status\":\"error\",\"message\":\"antrean penuh, coba lagi\"}", keepAlive);
+            return;
+        }
+        c.waiting = true;
+    }
+
+    /** @brief Seperti server Flask, respons sensor menyertakan record yang disimpan di "data". */
+    static string okBody(const vector<SensorReading>& records) {
+        string body = "{\"status\":\"ok\",\"source\":\"iot\",\"message\":\"Sensor data saved\",\"data\":";
+        appendRecordJSON(body, records[0]);
+        body += '}';
+        return body;
+    }
+
+    static string okBody(const vector<AppUsage>& records) {
+        return "{\"status\":\"ok\",\"source\":\"android\",\"message\":\"Usage data saved\",\"total_apps\":" + to_string(records.size()) + "}";
+    }
+
+    void appendResponse(Client& c, int status, const char* reason, const string& body, bool keepAlive,
+                        const char* contentType = "application/json") {
+        c.out += "HTTP/1.1 " + to_string(status) + " " + reason + "\r\n"
+                 "Content-Type: " + contentType + "\r\n"
+                 "Content-Length: " + to_string(body.size()) + "\r\n"
+                 "Connection: " + (keepAlive ? "keep-alive" : "close") + "\r\n\r\n" + body;
+        if (!keepAlive) c.closeAfter = true;
+    }
+
+    void respondError(Client& c, int status, const char* reason, const char* message) {
+        badRequestsTotal.add();
+        appendResponse(c, status, reason, string("{\"status\":\"error\",\"message\":\"") + message + "\"}", false);
+        c.in.clear();
+    }
+
+    /** @brief Mengirim isi buffer keluar. False jika klien ditutup. */
+    bool flushClient(Client& c) {
+        while (c.outPos < c.out.size()) {
+            ssize_t n = ::send(c.fd, c.out.data() + c.outPos, c.out.size() - c.outPos, MSG_NOSIGNAL);
+            if (n > 0) {
+                c.outPos += static_cast<size_t>(n);
+                continue;
             }
-            csvFile << "\n";
-            while (res->next()) {
-                for (int i = 1; i <= cols; ++i) {
-                    string value;
-                    if(res->isNull(i)) {
-                        value = "";
-                    } else {
-                        value = res->getString(i);
-                        // Escape quotes dan koma
-                        if (value.find(',') != string::npos || value.find('"') != string::npos || value.find('\n') != string::npos) {
-                            string tmp;
-                            for (char c : value) {
-                                if (c == '"') tmp += "\"\"";
-                                else tmp += c;
-                            }
-                            value = "\"" + tmp + "\"";
-                        }
-                    }
-                    csvFile << value;
-                    if (i < cols) csvFile << ",";
-                }
-                csvFile << "\n";
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                setWantWrite(c, true);
+                return true;
             }
-            csvFile.close();
-            cout << "Data dari '" << tableName << "' diekspor ke " << filePath << "." << endl;
-            writeLog("Mengekspor tabel: " + tableName + " ke CSV: " + filePath);
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error mengekspor ke CSV: " << e.what() << endl;
-            writeLog(string("Error mengekspor ke CSV: ") + e.what());
-            csvFile.close();
+            closeClient(c.fd);
+            return false;
+        }
+        c.out.clear();
+        c.outPos = 0;
+        setWantWrite(c, false);
+        if (c.closeAfter && !c.waiting) {
+            closeClient(c.fd);
             return false;
         }
+        return true;
     }
 
-    bool importFromCSV(const string& tableName, const string& filePath) {
-        if (!isValidIdentifier(tableName)) return false; // Keamanan
-        if (filePath.empty()) {
-            cout << "Path file kosong." << endl;
-            return false;
+    void setWantWrite(Client& c, bool want) {
+        if (c.wantWrite == want) return;
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP | (want ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+        ev.data.fd = c.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, c.fd, &ev);
+        c.wantWrite = want;
+    }
+
+    /**
+     * @brief Dipanggil dari thread flusher setelah commit; membangunkan event loop.
+     * Request yang tersimpan saat antrean penuh tidak pernah sampai ke sini
+     * (callback tryEnqueue tidak dipanggil jika ditolak).
+     */
+    void complete(const Completion& done) {
+        {
+            lock_guard<mutex> lock(completionMutex);
+            completions.push_back(done);
         }
+        uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
 
-        ifstream csvFile(filePath);
-        if (!csvFile.is_open()) {
-            cout << "Gagal membuka file CSV: " << filePath << endl;
-            return false;
+    void deliverCompletions() {
+        vector<Completion> done;
+        {
+            lock_guard<mutex> lock(completionMutex);
+            done.swap(completions);
         }
-        string line;
-        try {
-            if (!getline(csvFile, line)) {
-                cout << "File CSV kosong atau gagal dibaca." << endl;
-                csvFile.close();
-                return false;
-            }
-            vector<string> columns = parseCSVLine(line);
-            if (columns.empty()) {
-                cout << "Header CSV kosong." << endl;
-                csvFile.close();
-                return false;
-            }
+        for (const Completion& d : done) {
+            auto it = clients.find(d.fd);
+            if (it == clients.end() || it->second.gen != d.gen) continue; // Klien sudah pergi
+            Client& c = it->second;
+            c.waiting = false;
+            if (d.ok) appendResponse(c, 200, "OK", d.body, d.keepAlive);
+            else appendResponse(c, 503, "Service Unavailable", "{\"status\":\"error\",\"message\":\"gagal menyimpan, coba lagi\"}", d.keepAlive);
+            processInput(c);
+        }
+    }
 
-            // [Keamanan] Validasi kolom CSV terhadap kolom tabel
-            map<string, string> actualColumns;
-            {
-                lock_guard<mutex> lock(dbMutex);
-                 if (currentDB.empty()) {
-                    cout << "Pilih database terlebih dahulu!" << endl;
-                    csvFile.close();
-                    return false;
-                }
-                actualColumns = getTableColumns(tableName);
-                if (actualColumns.empty()) {
-                     cerr << "Gagal memverifikasi kolom tabel '" << tableName << "'." << endl;
-                     csvFile.close();
-                     return false;
-                }
-            }
-            
-            for (const string& csvCol : columns) {
-                if (!isValidIdentifier(csvCol)) { // Periksa juga header CSV
-                     cerr << "Error: Header CSV '" << csvCol << "' mengandung karakter tidak valid." << endl;
-                     csvFile.close();
-                     return false;
-                }
-                if (actualColumns.find(csvCol) == actualColumns.end()) {
-                    cerr << "Error: Kolom '" << csvCol << "' dari CSV tidak ditemukan di tabel '" << tableName << "'. Impor dibatalkan." << endl;
-                    csvFile.close();
-                    return false;
-                }
-            }
-            // Aman untuk melanjutkan, semua kolom CSV ada di tabel
+    void printStats(double intervalSeconds) {
+        MetricsRegistry& m = metrics();
+        uint64_t req = requestsTotal.get();
+        uint64_t rows = m.counter("dbm_group_commit_rows_total", "").get();
+        uint64_t commits = m.counter("dbm_group_commit_flushes_total", "").get();
+        ostringstream oss;
+        oss << fixed << setprecision(1);
+        if (intervalSeconds > 0) {
+            oss << "[ingest] " << (req - reportedRequests) / intervalSeconds << " req/s, "
+                << (rows - reportedRows) / intervalSeconds << " baris/s, ";
+        } else {
+            oss << "[ingest] total " << req << " request, " << rows << " baris, ";
+        }
+        oss << commits << " commit (rata-rata " << (commits ? static_cast<double>(rows) / commits : 0.0)
+            << " baris/commit), baris gagal " << m.counter("dbm_group_commit_failed_rows_total", "").get()
+            << ", request ditolak " << badRequestsTotal.get()
+            << ", klien " << clients.size();
+        cout << oss.str() << endl;
+        reportedRequests = req;
+        reportedRows = rows;
+    }
+};
 
-            string query = "INSERT INTO `" + tableName + "` (";
-            string valuePlaceholders = ") VALUES (";
-            for (size_t i = 0; i < columns.size(); ++i) {
-                query += "`" + columns[i] + "`"; // Aman karena sudah divalidasi
-                valuePlaceholders += "?";
-                if (i < columns.size() - 1) {
-                    query += ",";
-                    valuePlaceholders += ",";
+/**
+ * @brief Generator beban untuk daemon ingest: 'connections' klien keep-alive paralel,
+ * masing-masing mengirim 'requests' POST (campuran sensor/usage sesuai 'usagePercent')
+ * lalu mencetak throughput dan persentil latensi.
+ */
+static int runIngestLoadGenerator(const string& host, int port, size_t connections, size_t requests, int usagePercent) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        cerr << "Alamat IPv4 tidak valid: " << host << endl;
+        return 1;
+    }
+    static const char* packages[] = {"com.whatsapp", "com.instagram.android", "com.google.android.youtube",
+                                     "com.zhiliaoapp.musically", "com.android.chrome", "com.spotify.music",
+                                     "com.twitter.android", "com.google.android.gm", "com.mobile.legends",
+                                     "com.shopee.id"};
+
+    vector<vector<double>> latencies(connections);
+    atomic<uint64_t> errors{0};
+    atomic<uint64_t> rejected{0};
+    auto worker = [&](size_t index) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            errors += requests;
+            if (fd >= 0) ::close(fd);
+            return;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        mt19937 rng(static_cast<unsigned>(index * 7919 + 1));
+        uniform_int_distribution<int> pct(0, 99);
+        uniform_real_distribution<double> temp(20.0, 35.0), hum(40.0, 90.0), air(0.0, 100.0);
+        uniform_int_distribution<int> secs(0, 7200);
+        string body, request, in;
+        char buf[8192];
+        latencies[index].reserve(requests);
+        for (size_t i = 0; i < requests; ++i) {
+            bool usage = pct(rng) < usagePercent;
+            ostringstream b;
+            b << fixed << setprecision(2);
+            if (usage) {
+                int total = 0;
+                b << "{\"usage_data\":[";
+                for (size_t k = 0; k < size(packages); ++k) {
+                    int s = secs(rng);
+                    total += s;
+                    b << (k ? "," : "") << "{\"package\":\"" << packages[k] << "\",\"foreground_time_s\":" << s << "}";
                 }
+                b << "],\"total_screen_time_s\":" << total << "}";
+            } else {
+                b << "{\"temperature\":" << temp(rng) << ",\"humidity\":" << hum(rng) << ",\"air_quality\":" << air(rng) << "}";
             }
-            query += valuePlaceholders + ");";
-
-            unique_ptr<sql::PreparedStatement> pstmt;
-            {
-                lock_guard<mutex> lock(dbMutex);
-                pstmt.reset(conn->prepareStatement(query));
+            body = b.str();
+            request = string("POST ") + (usage ? "/receive_usage" : "/receive_sensor") + " HTTP/1.1\r\n"
+                      "Host: " + host + "\r\nContent-Type: application/json\r\n"
+                      "Content-Length: " + to_string(body.size()) + "\r\n\r\n" + body;
+
+            auto start = chrono::steady_clock::now();
+            size_t sent = 0;
+            while (sent < request.size()) {
+                ssize_t n = ::send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0) break;
+                sent += static_cast<size_t>(n);
             }
-
-            int lineCount = 0;
-            int successCount = 0;
-            while (getline(csvFile, line)) {
-                lineCount++;
-                if (line.empty() || line.find_first_not_of(" \t\r\n") == string::npos) continue;
-                
-                vector<string> values = parseCSVLine(line);
-                if (values.size() != columns.size()) {
-                    cout << "Peringatan: Melewatkan baris " << lineCount << " (jumlah kolom tidak cocok: " << values.size() << " vs " << columns.size() << ")" << endl;
-                    continue;
-                }
-
-                try {
-                    lock_guard<mutex> lock(dbMutex);
-                    for (size_t i = 0; i < values.size(); ++i) {
-                        if (values[i].empty() || values[i] == "NULL") {
-                            pstmt->setNull(i + 1, sql::DataType::VARCHAR);
-                        } else {
-                            pstmt->setString(i + 1, values[i]);
-                        }
+            // Baca satu respons lengkap (header + Content-Length)
+            int status = 0;
+            bool complete = false;
+            while (sent == request.size()) {
+                size_t headerEnd = in.find("\r\n\r\n");
+                if (headerEnd != string::npos) {
+                    status = atoi(in.c_str() + 9);
+                    size_t length = 0;
+                    size_t cl = in.find("Content-Length: ");
+                    if (cl != string::npos && cl < headerEnd) length = strtoul(in.c_str() + cl + 16, nullptr, 10);
+                    if (in.size() >= headerEnd + 4 + length) {
+                        in.erase(0, headerEnd + 4 + length);
+                        complete = true;
+                        break;
                     }
-                    pstmt->executeUpdate();
-                    successCount++;
-                } catch (sql::SQLException& e) {
-                     cout << "Error pada baris " << lineCount << ": " << e.what() << endl;
-                     writeLog("Error impor CSV baris " + to_string(lineCount) + ": " + e.what());
                 }
+                ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+                if (n <= 0) break;
+                in.append(buf, static_cast<size_t>(n));
+            }
+            if (!complete) {
+                errors += requests - i;
+                break;
             }
+            if (status != 200) rejected++;
+            latencies[index].push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        }
+        ::close(fd);
+    };
+
+    cout << "Loadgen: " << connections << " koneksi x " << requests << " request ke " << host << ":" << port
+         << " (" << usagePercent << "% usage)..." << endl;
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (size_t i = 0; i < connections; ++i) threads.emplace_back(worker, i);
+    for (thread& t : threads) t.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<double> all;
+    for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    sort(all.begin(), all.end());
+    auto percentile = [&](double p) { return all.empty() ? 0.0 : all[min(all.size() - 1, static_cast<size_t>(p * all.size()))]; };
+    ostringstream oss;
+    oss << fixed << setprecision(2);
+    oss << "Selesai: " << all.size() << " respons dalam " << seconds << " s ("
+        << (seconds > 0 ? all.size() / seconds : 0.0) << " req/s), non-200: " << rejected << ", gagal: " << errors << "\n"
+        << "Latensi ms  p50 " << percentile(0.50) << "  p95 " << percentile(0.95) << "  p99 " << percentile(0.99)
+        << "  max " << (all.empty() ? 0.0 : all.back());
+    cout << oss.str() << endl;
+    return errors == 0 ? 0 : 1;
+}
+#endif
 
-            csvFile.close();
-            cout << "Selesai: " << successCount << " dari " << lineCount << " baris berhasil diimpor ke '" << tableName << "'." << endl;
-            writeLog("Impor CSV ke tabel: " + tableName + " dari " + filePath);
-            return true;
-        } catch (sql::SQLException& e) {
-            cerr << "Error kritis mengimpor dari CSV: " << e.what() << endl;
-            writeLog(string("Error kritis mengimpor dari CSV: ") + e.what());
-            csvFile.close();
-            return false;
+/**
+ * @brief Kredensial untuk mode non-interaktif: DBM_USER/DBM_PASS, atau ditanyakan jika tidak ada.
+ */
+static ConnectionInfo commandLineCredentials() {
+    ConnectionInfo info{"tcp://127.0.0.1:3306", "", ""};
+    const char* envUser = getenv("DBM_USER");
+    const char* envPass = getenv("DBM_PASS");
+    if (envUser) {
+        info.user = envUser;
+    } else {
+        cout << "Masukkan User (cth: root): ";
+        getline(cin, info.user);
+    }
+    if (envPass) {
+        info.pass = envPass;
+    } else {
+        cout << "Masukkan Password: ";
+        getline(cin, info.pass);
+    }
+    return info;
+}
+
+/**
+ * @brief Mode baris perintah non-interaktif:
+ *   --ingest-server <database> [port] [koneksi] [batch_baris] [delay_ms] [rollup_ms]
+ *   --ingest-loadgen <host> <port> [koneksi] [request_per_koneksi] [persen_usage]
+ *   --partition-maintain <database> <tabel> <harian|bulanan> [precreate] [retain] [kolom_waktu]
+ *   --rollup-refresh <database> [tabel]
+ *   --import-dir <database> <direktori> <pola=tabel,...> [koneksi]
+ *   --workload-replay <database> <file_capture> [koneksi] [kecepatan]
+ *   --fan-out <database|pola,...> <query|truncate|purge|export|backup> <argumen...> [koneksi]
+ * Kredensial server diambil dari DBM_USER/DBM_PASS, atau ditanyakan jika tidak ada.
+ * DBM_TRACE=<file.json> merekam timeline proses dan mengekspornya saat selesai.
+ * DBM_CAPTURE=<file> merekam workload SQL proses (mis. --ingest-server) untuk replay.
+ */
+int runCommandLine(int argc, char* argv[]) {
+    string mode = argv[1];
+    auto argOr = [&](int i, long fallback) { return i < argc ? strtol(argv[i], nullptr, 10) : fallback; };
+    if (mode == "--partition-maintain" && argc >= 5) {
+        // Dijalankan berkala (cron / Task Scheduler) agar partisi ke depan selalu tersedia
+        string granularity = argv[4];
+        if (granularity != "harian" && granularity != "bulanan") {
+            cerr << "Granularitas harus 'harian' atau 'bulanan'." << endl;
+            return 1;
+        }
+        PartitionOptions opts;
+        opts.granularity = granularity == "harian" ? PartitionOptions::Granularity::Daily : PartitionOptions::Granularity::Monthly;
+        opts.precreate = static_cast<int>(max(0L, argOr(5, opts.precreate)));
+        opts.retain = static_cast<int>(max(0L, argOr(6, opts.retain)));
+        if (argc > 7) opts.timeColumn = argv[7];
+        ConnectionInfo info = commandLineCredentials();
+        try {
+            DatabaseManager m(info.host, info.user, info.pass);
+            return m.useDatabase(argv[2]) && m.maintainPartitions(argv[3], opts) ? 0 : 1;
         } catch (exception& e) {
-            cerr << "Error file saat impor CSV: " << e.what() << endl;
-            writeLog(string("Error file saat impor CSV: ") + e.what());
-            csvFile.close();
-            return false;
+            cerr << "Pemeliharaan partisi gagal: " << e.what() << endl;
+            return 1;
         }
     }
-};
+    if (mode == "--import-dir" && argc >= 5) {
+        DirectoryImportOptions dirOptions;
+        dirOptions.directory = argv[3];
+        if (!parseImportRules(argv[4], dirOptions.rules)) {
+            cerr << "Aturan tidak valid; format: pola=tabel[,pola=tabel]" << endl;
+            return 1;
+        }
+        dirOptions.connections = static_cast<size_t>(max(1L, argOr(5, static_cast<long>(dirOptions.connections))));
+        ConnectionInfo info = commandLineCredentials();
+        try {
+            return importDirectory(info, argv[2], dirOptions) ? 0 : 1;
+        } catch (exception& e) {
+            cerr << "Impor direktori gagal: " << e.what() << endl;
+            return 1;
+        }
+    }
+    if (mode == "--fan-out" && argc >= 5) {
+        // Target & operasi sama dengan menu utama 6; tanpa konfirmasi (untuk cron / skrip)
+        FanOutRequest req;
+        string op = argv[3];
+        int next = 5;
+        if (op == "query") {
+            req.kind = FanOutRequest::Kind::Query;
+            req.sql = argv[4];
+        } else if (op == "truncate") {
+            req.kind = FanOutRequest::Kind::Truncate;
+            req.table = argv[4];
+        } else if (op == "purge" && argc >= 6) {
+            req.kind = FanOutRequest::Kind::Purge;
+            req.table = argv[4];
+            string keep = argv[5];
+            if (keep.find('-') != string::npos) req.retention.cutoff = keep;
+            else req.retention.keepDays = max(0, atoi(keep.c_str()));
+            next = 6;
+        } else if (op == "export" && argc >= 6) {
+            req.kind = FanOutRequest::Kind::Export;
+            req.table = argv[4];
+            req.path = argv[5];
+            next = 6;
+        } else if (op == "backup") {
+            req.kind = FanOutRequest::Kind::Backup;
+            req.path = argv[4];
+        } else {
+            cerr << "Operasi fan-out tidak dikenal atau argumen kurang: " << op << endl;
+            return 1;
+        }
+        req.connections = static_cast<size_t>(max(1L, argOr(next, static_cast<long>(req.connections))));
+        ConnectionInfo info = commandLineCredentials();
+        try {
+            DatabaseManager m(info.host, info.user, info.pass);
+            vector<string> targets = resolveFanOutDatabases(m.databaseNames(), splitList(argv[2]));
+            return fanOut(info, targets, req) ? 0 : 1;
+        } catch (exception& e) {
+            cerr << "Fan-out gagal: " << e.what() << endl;
+            return 1;
+        }
+    }
+    if (mode == "--workload-replay" && argc >= 4) {
+        ReplayOptions opts;
+        opts.connections = static_cast<size_t>(max(0L, argOr(4, 0)));
+        if (argc > 5) opts.speed = max(0.0, atof(argv[5]));
+        ConnectionInfo info = commandLineCredentials();
+        try {
+            return replayWorkload(info, argv[2], argv[3], opts) ? 0 : 1;
+        } catch (exception& e) {
+            cerr << "Replay workload gagal: " << e.what() << endl;
+            return 1;
+        }
+    }
+    if (mode == "--rollup-refresh" && argc >= 3) {
+        ConnectionInfo info = commandLineCredentials();
+        try {
+            DatabaseManager m(info.host, info.user, info.pass);
+            return m.useDatabase(argv[2]) && m.refreshRollups(argc > 3 ? argv[3] : "") ? 0 : 1;
+        } catch (exception& e) {
+            cerr << "Refresh rollup gagal: " << e.what() << endl;
+            return 1;
+        }
+    }
+#if defined(__linux__)
+    if (mode == "--ingest-server" && argc >= 3) {
+        IngestOptions opts;
+        opts.port = static_cast<int>(argOr(3, opts.port));
+        opts.commit.connections = static_cast<size_t>(max(1L, argOr(4, static_cast<long>(opts.commit.connections))));
+        opts.commit.maxBatchRows = static_cast<size_t>(max(1L, argOr(5, static_cast<long>(opts.commit.maxBatchRows))));
+        opts.commit.maxDelayMs = static_cast<int>(max(0L, argOr(6, opts.commit.maxDelayMs)));
+        opts.rollupIntervalMs = static_cast<int>(max(0L, argOr(7, opts.rollupIntervalMs)));
+
+        ConnectionInfo info = commandLineCredentials();
+        signal(SIGINT, ingestSignalHandler);
+        signal(SIGTERM, ingestSignalHandler);
+        try {
+            IngestServer server(info, argv[2], opts);
+            return server.run() ? 0 : 1;
+        } catch (exception& e) {
+            cerr << "Ingest gagal: " << e.what() << endl;
+            return 1;
+        }
+    }
+    if (mode == "--ingest-loadgen" && argc >= 4) {
+        size_t connections = static_cast<size_t>(max(1L, argOr(4, 16)));
+        size_t requests = static_cast<size_t>(max(1L, argOr(5, 1000)));
+        int usagePercent = static_cast<int>(min(100L, max(0L, argOr(6, 10))));
+        return runIngestLoadGenerator(argv[2], static_cast<int>(argOr(3, 8080)), connections, requests, usagePercent);
+    }
+#else
+    if (mode == "--ingest-server" || mode == "--ingest-loadgen") {
+        cerr << "Mode ingest membutuhkan epoll dan hanya tersedia di Linux." << endl;
+        return 1;
+    }
+#endif
+    cerr << "Penggunaan:\n"
+         << "  " << argv[0] << "                      (menu interaktif)\n"
+         << "  " << argv[0] << " --ingest-server <database> [port=8080] [koneksi=4] [batch_baris=500] [delay_ms=5] [rollup_ms=0]\n"
+         << "  " << argv[0] << " --ingest-loadgen <host> <port> [koneksi=16] [request_per_koneksi=1000] [persen_usage=10]\n"
+         << "  " << argv[0] << " --partition-maintain <database> <tabel> <harian|bulanan> [precreate=7] [retain=0] [kolom_waktu=timestamp]\n"
+         << "  " << argv[0] << " --rollup-refresh <database> [tabel]\n"
+         << "  " << argv[0] << " --import-dir <database> <direktori> <pola=tabel[,pola=tabel]> [koneksi=4]\n"
+         << "  " << argv[0] << " --workload-replay <database> <file_capture> [koneksi=0 (per sesi)] [kecepatan=1 (0 = maks)]\n"
+         << "  " << argv[0] << " --fan-out <database|pola,...> query <sql> [koneksi=4]\n"
+         << "  " << argv[0] << " --fan-out <database|pola,...> truncate <tabel> [koneksi=4]\n"
+         << "  " << argv[0] << " --fan-out <database|pola,...> purge <tabel> <hari|cutoff> [koneksi=4]\n"
+         << "  " << argv[0] << " --fan-out <database|pola,...> export <tabel> <file_{db}.csv> [koneksi=4]\n"
+         << "  " << argv[0] << " --fan-out <database|pola,...> backup <file_{db}.sql> [koneksi=4]" << endl;
+    return 1;
+}
 
 // --- FUNGSI UTAMA & MENU ---
 
@@ -1437,6 +9817,8 @@ void showMainMenu() {
     cout << "2. USE Database (Masuk ke Menu Tabel)\n";
     cout << "3. Drop Database\n";
     cout << "4. Create Database\n";
+    cout << "5. Metrik (format Prometheus)\n";
+    cout << "6. Fan-Out Multi-Database (Query / Truncate / Purge / Ekspor / Backup)\n";
     cout << "------------------------------------------\n";
     cout << "0. Keluar\n";
     cout << "Pilihan: ";
@@ -1461,13 +9843,26 @@ void showDatabaseMenu(const string& dbName) {
     cout << " 9. Delete Data (Interaktif & Aman)\n";
     cout << "------------------------------------------\n";
     cout << "10. Generate Random Data (Tabel 'users(name, age)')\n";
-    cout << "11. Export Table to CSV\n";
+    cout << "11. Export Table to CSV (Kolom & Filter Opsional)\n";
     cout << "12. Import Table from CSV\n";
     cout << "13. Execute Query from File\n";
     cout << "14. Backup Database (Format Sendiri)\n";
     cout << "15. Stress Test (SELECT 1)\n";
     cout << "16. Execute Custom Query (BERBAHAYA!)\n";
     cout << "------------------------------------------\n";
+    cout << "17. Jobs (Pantau / Batalkan Job Background)\n";
+    cout << "18. Query Paralel (Async, Multi-Koneksi)\n";
+    cout << "19. Follow CSV (Ingest Berkelanjutan, Background)\n";
+    cout << "20. Retensi: Purge Data Lama (Bertahap, Koneksi Terpisah)\n";
+    cout << "21. Partisi Waktu (Buat / Pemeliharaan / Laporan)\n";
+    cout << "22. Rollup Agregat (Menit/Jam/Hari, Inkremental)\n";
+    cout << "23. Impor Direktori (Glob -> Tabel, Paralel)\n";
+    cout << "24. Cache Hasil Select (Statistik / Kosongkan)\n";
+    cout << "25. Index Advisor (Laporan / Terapkan CREATE INDEX)\n";
+    cout << "26. Profiling Query (Slow Query Log / Ringkasan)\n";
+    cout << "27. Tracing Timeline (Mulai / Stop & Ekspor Chrome JSON)\n";
+    cout << "28. Capture & Replay Workload (Rekam / Putar Ulang)\n";
+    cout << "------------------------------------------\n";
     cout << " 0. Kembali ke Menu Utama\n";
     cout << "Pilihan: ";
 }
@@ -1479,10 +9874,149 @@ void cleanCin() {
     }
 }
 
+/**
+ * @brief Menanyakan filter ekspor secara interaktif (=, IN, rentang).
+ */
+vector<ExportFilter> promptExportFilters() {
+    vector<ExportFilter> filters;
+    string colName, kind, val;
+    while (true) {
+        cout << "Filter berdasarkan kolom (atau 'selesai'): ";
+        getline(cin, colName);
+        if (colName == "selesai" || colName.empty()) break;
+
+        cout << "Jenis filter [1] = nilai  [2] IN (daftar)  [3] rentang (>= dari, < sampai): ";
+        getline(cin, kind);
+        ExportFilter f;
+        f.column = colName;
+        if (kind == "2") {
+            f.op = ExportFilter::Op::In;
+            cout << "Daftar nilai (pisahkan koma): ";
+            getline(cin, val);
+            f.values = splitList(val);
+        } else if (kind == "3") {
+            f.op = ExportFilter::Op::Range;
+            string from, to;
+            cout << "Dari (cth: 2025-11-01 00:00:00, kosong = tanpa batas): ";
+            getline(cin, from);
+            cout << "Sampai (eksklusif, kosong = tanpa batas): ";
+            getline(cin, to);
+            f.values = {from, to};
+        } else {
+            f.op = ExportFilter::Op::Equal;
+            cout << "Nilai untuk " << colName << " = ";
+            getline(cin, val);
+            f.values = {val};
+        }
+        filters.push_back(f);
+    }
+    return filters;
+}
+
+/**
+ * @brief Menjalankan operasi panjang sebagai job; di background atau menunggu dengan progres.
+ */
+void runJob(JobManager& jobs, const string& name, function<bool()> work) {
+    cout << "Jalankan di background? (y/n): ";
+    string answer;
+    getline(cin, answer);
+    bool background = answer == "y" || answer == "Y";
+    if (!background && jobs.workersBusy()) {
+        // Menunggu di depan job yang antre akan menahan menu tanpa bisa dibatalkan
+        cout << "Semua worker job sedang dipakai; job dijalankan di background." << endl;
+        background = true;
+    }
+    shared_ptr<Job> job = jobs.submit(name, std::move(work));
+    if (background) {
+        cout << "Job #" << job->id << " dijadwalkan. Pantau lewat menu 17 (Jobs)." << endl;
+    } else {
+        jobs.waitWithProgress(job);
+    }
+}
+
+/**
+ * @brief Membungkus pekerjaan job agar berjalan di koneksi sendiri pada schema
+ * yang aktif saat job dijadwalkan. Koneksi menu tidak dipakai job, sehingga
+ * pindah database atau query interaktif tidak mengenai transaksi job yang terbuka.
+ * 'writes' = buang cache hasil menu setelah job selesai.
+ */
+function<bool()> onJobConnection(DatabaseManager* mgr, function<bool(DatabaseManager&)> work, bool writes = true) {
+    ConnectionInfo info = mgr->connectionInfo();
+    string schema = mgr->getCurrentDB();
+    return [mgr, info, schema, work = std::move(work), writes]() {
+        DatabaseManager worker(info.host, info.user, info.pass);
+        if (!schema.empty() && !worker.useDatabase(schema)) return false;
+        bool ok = work(worker);
+        if (writes) mgr->invalidateResultCache(); // Rollup ikut berubah: buang seluruh cache
+        return ok;
+    };
+}
+
+/**
+ * @brief Menu Jobs: daftar job berjalan/selesai dan pembatalan.
+ */
+void jobsMenu(JobManager& jobs) {
+    jobs.printJobs();
+    cout << "ID job yang dibatalkan (Enter = kembali): ";
+    string input;
+    getline(cin, input);
+    if (input.empty()) return;
+    try {
+        int id = stoi(input);
+        if (jobs.cancel(id)) cout << "Permintaan pembatalan dikirim ke job #" << id << "." << endl;
+        else cout << "Job #" << id << " tidak ditemukan atau sudah selesai." << endl;
+    } catch (exception&) {
+        cout << "ID tidak valid." << endl;
+    }
+}
+
+/**
+ * @brief Menjalankan beberapa query sekaligus lewat AsyncDatabase dan
+ * menampilkan jumlah baris serta waktu antre/eksekusi tiap query.
+ */
+void parallelQueryMenu(DatabaseManager& db) {
+    vector<string> queries;
+    cout << "Masukkan query, satu per baris (baris kosong = selesai):\n";
+    string line;
+    while (getline(cin, line) && !line.empty()) queries.push_back(line);
+    if (queries.empty()) {
+        cout << "Tidak ada query." << endl;
+        return;
+    }
+
+    try {
+        size_t connections = min<size_t>(queries.size(), 8);
+        AsyncDatabase async(db.connectionInfo(), connections, db.getCurrentDB());
+        auto start = chrono::steady_clock::now();
+        vector<future<AsyncResult>> pending;
+        for (const string& q : queries) pending.push_back(async.query(q));
+        bool anyWrite = any_of(queries.begin(), queries.end(), [](const string& q) { return !isReadOnlyStatement(q); });
+
+        double sumMs = 0;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            AsyncResult r = pending[i].get();
+            sumMs += r.elapsedMs;
+            ostringstream oss;
+            oss << fixed << setprecision(1) << "[" << (i + 1) << "] " << (r.ok ? "OK" : "GAGAL") << " | " << r.rows
+                << " baris | antre " << r.queueMs << " ms | eksekusi " << r.elapsedMs << " ms | " << queries[i];
+            cout << oss.str() << endl;
+            if (!r.ok) cout << "    " << r.error << endl;
+        }
+        if (anyWrite) db.invalidateResultCache(); // Ditulis lewat koneksi async, bukan koneksi manager
+        double wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        ostringstream oss;
+        oss << fixed << setprecision(1) << "Total: " << queries.size() << " query di " << connections << " koneksi, "
+            << wallMs << " ms (jumlah waktu eksekusi " << sumMs << " ms).";
+        cout << oss.str() << endl;
+    } catch (exception& e) {
+        cerr << "Gagal membuka koneksi async: " << e.what() << endl;
+    }
+}
+
 /**
  * @brief Logika untuk loop Menu Tabel
  */
-void databaseMenu(unique_ptr<DatabaseManager>& db) {
+void databaseMenu(unique_ptr<DatabaseManager>& db, JobManager& jobs) {
     int choice = -1;
     string currentDBName = db->getCurrentDB();
 
@@ -1498,6 +10032,7 @@ void databaseMenu(unique_ptr<DatabaseManager>& db) {
 
         string name, name2, query, path;
         int num;
+        DatabaseManager* mgr = db.get(); // Untuk job; JobManager dihancurkan sebelum db
 
         switch (choice) {
             case 1: db->listTables(); break;
@@ -1546,19 +10081,56 @@ void databaseMenu(unique_ptr<DatabaseManager>& db) {
                 db->listTables(); // Tampilkan daftar dulu
                 cout << "Nama tabel (harus punya 'name' dan 'age'): "; getline(cin, name);
                 cout << "Jumlah baris: "; cin >> num; cleanCin();
-                db->generateRandomData(name, num);
+                runJob(jobs, "Data acak " + name, onJobConnection(mgr, [name, num](DatabaseManager& worker) {
+                    return worker.generateRandomData(name, num);
+                }));
                 break;
             case 11:
                 db->listTables(); // Tampilkan daftar dulu
                 cout << "Nama tabel: "; getline(cin, name);
-                cout << "Path file CSV (cth: C:/temp/export.csv): "; getline(cin, path);
-                db->exportToCSV(name, path);
+                cout << "Path file CSV (cth: C:/temp/export.csv, .csv.gz / .csv.zst = terkompresi): "; getline(cin, path);
+                cout << "Kolom yang diekspor (pisahkan koma, kosong = semua): "; getline(cin, query);
+                {
+                    vector<string> exportColumns = splitList(query);
+                    vector<ExportFilter> exportFilters = promptExportFilters();
+                    runJob(jobs, "Ekspor " + name + " -> " + path, onJobConnection(mgr, [name, path, exportColumns, exportFilters](DatabaseManager& worker) {
+                        return worker.exportToCSV(name, path, exportColumns, exportFilters);
+                    }, false));
+                }
                 break;
             case 12:
                 db->listTables(); // Tampilkan daftar dulu
                 cout << "Nama tabel: "; getline(cin, name);
-                cout << "Path file CSV (cth: C:/temp/import.csv): "; getline(cin, path);
-                db->importFromCSV(name, path);
+                cout << "Path file CSV (cth: C:/temp/import.csv, .gz/.zst dideteksi otomatis): "; getline(cin, path);
+                {
+                    ImportOptions importOptions;
+                    cout << "Checkpoint: [1] lanjutkan jika ada (default)  [2] mulai ulang dari awal: "; getline(cin, query);
+                    importOptions.restart = (query == "2");
+                    cout << "Baris dengan kunci yang sudah ada: [1] error per baris (default)  [2] upsert\n"
+                         << "  [3] abaikan (INSERT IGNORE)  [4] staging + satu merge set-based: "; getline(cin, query);
+                    if (query == "2") importOptions.merge.mode = MergeMode::Upsert;
+                    else if (query == "3") importOptions.merge.mode = MergeMode::Ignore;
+                    else if (query == "4") importOptions.merge.mode = MergeMode::Staging;
+                    if (importOptions.merge.mode == MergeMode::Upsert || importOptions.merge.mode == MergeMode::Staging) {
+                        cout << "Kebijakan kolom (overwrite/keep/coalesce/sum/max/min, cth: visits=sum,created_at=keep; Enter = timpa semua): ";
+                        getline(cin, query);
+                        if (!parseMergePolicies(query, importOptions.merge.policies)) {
+                            cout << "Kebijakan kolom tidak valid. Impor dibatalkan." << endl;
+                            break;
+                        }
+                    }
+                    cout << "Dedupe berdasarkan kolom (pisahkan koma, * = seluruh baris, Enter = nonaktif): "; getline(cin, query);
+                    importOptions.dedupe.keyColumns = splitList(query);
+                    if (!importOptions.dedupe.keyColumns.empty()) {
+                        cout << "Mode dedupe: [1] hash set eksak, beralih ke Bloom jika terlalu besar (default)  [2] Bloom filter (16 MB tetap): ";
+                        getline(cin, query);
+                        importOptions.dedupe.bloom = (query == "2");
+                    }
+                    runJob(jobs, "Impor " + path + " -> " + name, onJobConnection(mgr, [name, path, importOptions](DatabaseManager& worker) {
+                        // Rollup terdaftar untuk tabel ini ikut dilipat (no-op jika tidak ada)
+                        return worker.importFromCSV(name, path, importOptions) && worker.refreshRollups(name);
+                    }));
+                }
                 break;
             case 13:
                 cout << "Path file SQL (cth: C:/temp/queries.sql): "; getline(cin, path);
@@ -1568,13 +10140,19 @@ void databaseMenu(unique_ptr<DatabaseManager>& db) {
                 // Tampilkan daftar database untuk membantu memilih backup
                 db->listDatabases();
                 cout << "Nama DB yg di-backup (tidak harus DB saat ini): "; getline(cin, name);
-                cout << "Path file backup (cth: C:/temp/backup.txt): "; getline(cin, path);
-                db->backupDatabase(name, path);
+                cout << "Path file backup (cth: C:/temp/backup.txt, .gz / .zst = terkompresi): "; getline(cin, path);
+                runJob(jobs, "Backup " + name + " -> " + path, onJobConnection(mgr, [name, path](DatabaseManager& worker) {
+                    return worker.backupDatabase(name, path);
+                }, false));
                 break;
             case 15:
                 cout << "Jumlah thread: "; cin >> num; cleanCin();
                 cout << "Query per thread: "; cin >> choice; cleanCin(); 
-                db->stressTest(num, choice);
+                {
+                    int perThread = choice;
+                    runJob(jobs, "Tes stres " + to_string(num) + "x" + to_string(perThread),
+                           onJobConnection(mgr, [num, perThread](DatabaseManager& worker) { return worker.stressTest(num, perThread); }));
+                }
                 choice = -1; // Reset choice agar loop tidak keluar
                 break;
             case 16:
@@ -1583,6 +10161,261 @@ void databaseMenu(unique_ptr<DatabaseManager>& db) {
                 getline(cin, query);
                 db->executeQuery(query); 
                 break;
+            case 17:
+                jobsMenu(jobs);
+                break;
+            case 18:
+                parallelQueryMenu(*db);
+                break;
+            case 19:
+                db->listTables(); // Tampilkan daftar dulu
+                cout << "Nama tabel tujuan: "; getline(cin, name);
+                cout << "Path file CSV yang diikuti (cth: ../Server/sensor_data.csv): "; getline(cin, path);
+                {
+                    FollowOptions followOptions;
+                    cout << "Flush setiap N baris (Enter = " << followOptions.flushRows << "): "; getline(cin, query);
+                    if (!query.empty()) followOptions.flushRows = max(1, atoi(query.c_str()));
+                    cout << "Flush paling lambat M ms (Enter = " << followOptions.flushMs << "): "; getline(cin, query);
+                    if (!query.empty()) followOptions.flushMs = max(10, atoi(query.c_str()));
+                    shared_ptr<Job> job = jobs.submit("Follow " + path + " -> " + name, onJobConnection(mgr, [name, path, followOptions](DatabaseManager& worker) {
+                        return worker.followCSV(name, path, followOptions);
+                    }), true);
+                    cout << "Job #" << job->id << " mengikuti file. Hentikan lewat menu 17 (Jobs)." << endl;
+                }
+                break;
+            case 20:
+                db->listTables(); // Tampilkan daftar dulu
+                cout << "Nama tabel: "; getline(cin, name);
+                {
+                    RetentionOptions retention;
+                    cout << "Kolom waktu (Enter = " << retention.timeColumn << "): "; getline(cin, query);
+                    if (!query.empty()) retention.timeColumn = query;
+                    cout << "Hapus data lebih lama dari N hari, atau cutoff 'YYYY-MM-DD HH:MM:SS' (Enter = " << retention.keepDays << " hari): ";
+                    getline(cin, query);
+                    if (query.find('-') != string::npos) retention.cutoff = query;
+                    else if (!query.empty()) retention.keepDays = max(0, atoi(query.c_str()));
+                    cout << "Ukuran potongan awal (Enter = " << retention.chunkRows << "): "; getline(cin, query);
+                    if (!query.empty()) retention.chunkRows = static_cast<size_t>(max(1, atoi(query.c_str())));
+                    cout << "Jeda antar potongan ms (Enter = " << retention.pauseMs << "): "; getline(cin, query);
+                    if (!query.empty()) retention.pauseMs = max(0, atoi(query.c_str()));
+                    // Koneksi sendiri agar dbMutex menu (dan ingest) tidak tertahan selama purge
+                    ConnectionInfo info = mgr->connectionInfo();
+                    string schema = mgr->getCurrentDB();
+                    runJob(jobs, "Retensi " + name, [mgr, info, schema, name, retention]() {
+                        DatabaseManager purger(info.host, info.user, info.pass);
+                        bool ok = purger.useDatabase(schema) && purger.purgeOlderThan(name, retention);
+                        mgr->invalidateResultCache(name);
+                        return ok;
+                    });
+                }
+                break;
+            case 21:
+                db->listTables(); // Tampilkan daftar dulu
+                cout << "Nama tabel: "; getline(cin, name);
+                cout << "1. Buat layout partisi  2. Pemeliharaan (precreate/drop)  3. Laporan\nPilihan: "; getline(cin, path);
+                if (path == "3") {
+                    db->showPartitions(name);
+                } else if (path == "1" || path == "2") {
+                    PartitionOptions partition;
+                    cout << "Kolom waktu (Enter = " << partition.timeColumn << "): "; getline(cin, query);
+                    if (!query.empty()) partition.timeColumn = query;
+                    cout << "Granularitas: 1. Harian  2. Bulanan (Enter = Harian): "; getline(cin, query);
+                    if (query == "2") partition.granularity = PartitionOptions::Granularity::Monthly;
+                    cout << "Siapkan N periode ke depan (Enter = " << partition.precreate << "): "; getline(cin, query);
+                    if (!query.empty()) partition.precreate = max(0, atoi(query.c_str()));
+                    if (path == "2") {
+                        cout << "Drop partisi lebih tua dari N periode (Enter = 0, tidak drop): "; getline(cin, query);
+                        if (!query.empty()) partition.retain = max(0, atoi(query.c_str()));
+                    }
+                    // ALTER partisi bisa lama (menyalin tabel): jalankan di koneksi terpisah
+                    ConnectionInfo info = mgr->connectionInfo();
+                    string schema = mgr->getCurrentDB();
+                    bool create = path == "1";
+                    runJob(jobs, (create ? "Partisi " : "Pemeliharaan partisi ") + name, [info, schema, name, partition, create]() {
+                        DatabaseManager partitioner(info.host, info.user, info.pass);
+                        if (!partitioner.useDatabase(schema)) return false;
+                        return create ? partitioner.partitionByRange(name, partition) : partitioner.maintainPartitions(name, partition);
+                    });
+                } else {
+                    cout << "Pilihan tidak valid." << endl;
+                }
+                break;
+            case 22:
+                cout << "1. Daftarkan rollup  2. Refresh sekarang  3. Refresh berkala (background)  4. Tampilkan\nPilihan: "; getline(cin, path);
+                if (path == "1") {
+                    db->listTables(); // Tampilkan daftar dulu
+                    cout << "Nama tabel sumber: "; getline(cin, name);
+                    cout << "Preset: 1. Sensor (temperature, humidity, air_quality)  2. Usage (per kategori dan package)  3. Kustom: "; getline(cin, query);
+                    RollupSpec spec = query == "1" ? sensorRollupSpec(name) : query == "2" ? usageRollupSpec(name) : RollupSpec();
+                    spec.sourceTable = name;
+                    if (query != "1" && query != "2") {
+                        cout << "Kolom waktu (Enter = " << spec.timeColumn << "): "; getline(cin, query);
+                        if (!query.empty()) spec.timeColumn = query;
+                        cout << "Kolom id AUTO_INCREMENT (Enter = " << spec.idColumn << "): "; getline(cin, query);
+                        if (!query.empty()) spec.idColumn = query;
+                        cout << "Kolom grup, pisahkan koma (Enter = tidak ada): "; getline(cin, query);
+                        spec.groupColumns = splitList(query);
+                        cout << "Kolom ukuran numerik, pisahkan koma: "; getline(cin, query);
+                        spec.measures = splitList(query);
+                    }
+                    db->createRollup(spec);
+                } else if (path == "2") {
+                    runJob(jobs, "Refresh rollup", onJobConnection(mgr, [](DatabaseManager& worker) { return worker.refreshRollups(); }));
+                } else if (path == "3") {
+                    cout << "Interval detik (Enter = 60): "; getline(cin, query);
+                    int intervalSec = query.empty() ? 60 : max(1, atoi(query.c_str()));
+                    // Koneksi sendiri; berjalan hingga dibatalkan lewat menu 17 (Jobs)
+                    ConnectionInfo info = mgr->connectionInfo();
+                    string schema = mgr->getCurrentDB();
+                    shared_ptr<Job> job = jobs.submit("Rollup berkala (" + to_string(intervalSec) + " s)", [info, schema, intervalSec]() {
+                        DatabaseManager roller(info.host, info.user, info.pass);
+                        if (!roller.useDatabase(schema)) return false;
+                        while (!jobCancelled()) {
+                            roller.refreshRollups();
+                            for (int i = 0; i < intervalSec * 10 && !jobCancelled(); ++i) this_thread::sleep_for(chrono::milliseconds(100));
+                        }
+                        return true;
+                    }, true);
+                    cout << "Job #" << job->id << " melipat rollup setiap " << intervalSec << " detik. Hentikan lewat menu 17 (Jobs)." << endl;
+                } else if (path == "4") {
+                    cout << "Nama tabel sumber: "; getline(cin, name);
+                    cout << "Granularitas (minute/hour/day, Enter = hour): "; getline(cin, query);
+                    string granularity = query.empty() ? "hour" : query;
+                    cout << "Jumlah bucket terbaru (Enter = 24): "; getline(cin, query);
+                    int limit = query.empty() ? 24 : atoi(query.c_str());
+                    cout << "Kelompokkan per kolom grup, pisahkan koma (cth: category; Enter = semua): "; getline(cin, query);
+                    db->showRollup(name, granularity, limit, splitList(query));
+                } else {
+                    cout << "Pilihan tidak valid." << endl;
+                }
+                break;
+            case 23:
+                db->listTables(); // Tampilkan daftar dulu
+                {
+                    DirectoryImportOptions dirOptions;
+                    cout << "Direktori sumber: "; getline(cin, dirOptions.directory);
+                    cout << "Aturan pola=tabel, pisahkan koma (cth: sensor_*.csv=sensor_data,usage_*.csv.gz=usage_events): "; getline(cin, query);
+                    if (!parseImportRules(query, dirOptions.rules)) {
+                        cout << "Aturan tidak valid." << endl;
+                        break;
+                    }
+                    cout << "Termasuk subdirektori? (y/n, Enter = n): "; getline(cin, query);
+                    dirOptions.recursive = (query == "y" || query == "Y");
+                    cout << "Jumlah koneksi paralel (Enter = " << dirOptions.connections << "): "; getline(cin, query);
+                    if (!query.empty()) dirOptions.connections = static_cast<size_t>(max(1, atoi(query.c_str())));
+                    cout << "Baris dengan kunci yang sudah ada: [1] error per baris (default)  [2] upsert  [3] abaikan: "; getline(cin, query);
+                    if (query == "2") dirOptions.import.merge.mode = MergeMode::Upsert;
+                    else if (query == "3") dirOptions.import.merge.mode = MergeMode::Ignore;
+                    ConnectionInfo info = mgr->connectionInfo();
+                    string schema = mgr->getCurrentDB();
+                    runJob(jobs, "Impor direktori " + dirOptions.directory, [mgr, info, schema, dirOptions]() {
+                        bool ok = importDirectory(info, schema, dirOptions);
+                        set<string> tables;
+                        for (const auto& rule : dirOptions.rules) tables.insert(rule.second);
+                        DatabaseManager roller(info.host, info.user, info.pass);
+                        if (!roller.useDatabase(schema)) return false;
+                        for (const string& t : tables) ok = roller.refreshRollups(t) && ok; // Rollup terdaftar ikut dilipat
+                        mgr->invalidateResultCache();
+                        return ok;
+                    });
+                }
+                break;
+            case 24:
+                db->showResultCache();
+                cout << "Kosongkan cache? (y/n): "; getline(cin, query);
+                if (query == "y" || query == "Y") {
+                    db->invalidateResultCache();
+                    cout << "Cache hasil dikosongkan." << endl;
+                }
+                break;
+            case 25:
+                {
+                    vector<IndexRecommendation> recs;
+                    db->showIndexAdvice(recs);
+                    if (recs.empty()) break;
+                    cout << "Terapkan rekomendasi nomor (Enter = tidak): "; getline(cin, query);
+                    size_t pick = static_cast<size_t>(max(0, atoi(query.c_str())));
+                    if (pick < 1 || pick > recs.size()) break;
+                    cout << "Jalankan: " << recs[pick - 1].ddl << " ? (y/n): "; getline(cin, query);
+                    if (query == "y" || query == "Y") db->applyIndexRecommendation(recs[pick - 1]);
+                }
+                break;
+            case 26:
+                {
+                    QueryProfileOptions profiling = db->queryProfiling();
+                    cout << "Profiling (menu 13 & 16): " << (profiling.enabled ? "AKTIF" : "nonaktif")
+                         << ", ambang " << profiling.slowMs << " ms, file " << profiling.slowLogPath << endl;
+                    cout << "1. Aktifkan  2. Nonaktifkan  3. Ringkasan  4. Reset ringkasan\nPilihan: "; getline(cin, path);
+                    if (path == "1") {
+                        cout << "Ambang slow query ms (Enter = " << profiling.slowMs << "): "; getline(cin, query);
+                        if (!query.empty()) profiling.slowMs = max(0.0, atof(query.c_str()));
+                        cout << "File slow query (Enter = " << profiling.slowLogPath << "): "; getline(cin, query);
+                        if (!query.empty()) profiling.slowLogPath = query;
+                        cout << "EXPLAIN ANALYZE untuk SELECT lambat? Query dijalankan ulang (y/n, Enter = y): "; getline(cin, query);
+                        profiling.analyze = !(query == "n" || query == "N");
+                        profiling.enabled = true;
+                        db->setQueryProfiling(profiling);
+                        cout << "Profiling aktif." << endl;
+                    } else if (path == "2") {
+                        profiling.enabled = false;
+                        db->setQueryProfiling(profiling);
+                        cout << "Profiling nonaktif." << endl;
+                    } else if (path == "3") {
+                        db->showQueryProfile();
+                    } else if (path == "4") {
+                        db->resetQueryProfile();
+                        cout << "Ringkasan profiling dikosongkan." << endl;
+                    } else {
+                        cout << "Pilihan tidak valid." << endl;
+                    }
+                }
+                break;
+            case 27:
+                cout << "Tracing: " << (tracer().enabled() ? "MEREKAM" : "nonaktif") << endl;
+                cout << "1. Mulai (buffer dikosongkan)  2. Stop & ekspor\nPilihan: "; getline(cin, path);
+                if (path == "1") {
+                    tracer().start();
+                    cout << "Tracing dimulai. Jalankan impor/backup/query, lalu kembali ke menu ini untuk ekspor." << endl;
+                } else if (path == "2") {
+                    tracer().stop();
+                    cout << "File output (Enter = trace.json): "; getline(cin, path);
+                    if (path.empty()) path = "trace.json";
+                    if (tracer().exportChromeTrace(path)) cout << "Buka di chrome://tracing atau https://ui.perfetto.dev" << endl;
+                } else {
+                    cout << "Pilihan tidak valid." << endl;
+                }
+                break;
+            case 28:
+                cout << "Capture workload: " << (workloadRecorder().active() ? "MEREKAM" : "nonaktif") << endl;
+                cout << "1. Mulai capture  2. Stop capture  3. Replay file capture ke database\nPilihan: "; getline(cin, path);
+                if (path == "1") {
+                    cout << "File capture (.gz/.zst = dikompresi, Enter = workload.capture): "; getline(cin, path);
+                    if (path.empty()) path = "workload.capture";
+                    if (workloadRecorder().start(path)) {
+                        cout << "Capture dimulai. Semua koneksi proses ini direkam sampai capture dihentikan." << endl;
+                    }
+                } else if (path == "2") {
+                    if (!workloadRecorder().active()) cout << "Capture tidak sedang berjalan." << endl;
+                    else workloadRecorder().stop();
+                } else if (path == "3") {
+                    cout << "File capture: "; getline(cin, path);
+                    cout << "Database tujuan (Enter = " << currentDBName << "): "; getline(cin, name);
+                    if (name.empty()) name = currentDBName;
+                    ReplayOptions replay;
+                    cout << "Jumlah koneksi (Enter = satu per sesi capture): "; getline(cin, query);
+                    if (!query.empty()) replay.connections = static_cast<size_t>(max(1, atoi(query.c_str())));
+                    cout << "Kecepatan (1 = asli, 2 = 2x lebih cepat, 0 = maksimum, Enter = 1): "; getline(cin, query);
+                    if (!query.empty()) replay.speed = max(0.0, atof(query.c_str()));
+                    ConnectionInfo info = mgr->connectionInfo();
+                    runJob(jobs, "Replay " + path, [mgr, info, name, path, replay]() {
+                        bool ok = replayWorkload(info, name, path, replay);
+                        mgr->invalidateResultCache(); // Replay menulis lewat koneksi lain
+                        return ok;
+                    });
+                } else {
+                    cout << "Pilihan tidak valid." << endl;
+                }
+                break;
             case 0:
                 cout << "Kembali ke Menu Utama..." << endl;
                 break;
@@ -1604,7 +10437,12 @@ void databaseMenu(unique_ptr<DatabaseManager>& db) {
 /**
  * @brief Logika untuk loop Menu Utama
  */
-int main() {
+#ifndef DBM_NO_MAIN // bench/ meng-include file ini dan menyediakan main() sendiri
+int main(int argc, char* argv[]) {
+    TraceSession traceSession(getenv("DBM_TRACE")); // DBM_TRACE=trace.json: rekam timeline seluruh proses
+    CaptureSession captureSession(getenv("DBM_CAPTURE")); // DBM_CAPTURE=workload.capture.zst: rekam statement untuk replay
+    if (argc > 1) return runCommandLine(argc, argv);
+
     string host, user, pass;
     host = "tcp://127.0.0.1:3306";
     cout << "Menggunakan host otomatis: " << host << endl;
@@ -1625,6 +10463,8 @@ int main() {
         return 1;
     }
 
+    JobManager jobs; // Dideklarasikan setelah db agar dihancurkan (dan job ditunggu) lebih dulu
+
     int choice = -1;
     while (choice != 0) {
         showMainMenu();
@@ -1648,7 +10488,7 @@ int main() {
                 getline(cin, name);
                 if (db->useDatabase(name)) {
                     clearScreen();
-                    databaseMenu(db); // Masuk ke menu tabel
+                    databaseMenu(db, jobs); // Masuk ke menu tabel
                 }
                 break;
             case 3:
@@ -1662,7 +10502,74 @@ int main() {
                 getline(cin, name);
                 db->createDatabase(name);
                 break;
+            case 5:
+                refreshMemoryMetrics();
+                cout << metrics().renderText();
+                break;
+            case 6:
+                {
+                    string input;
+                    cout << "Database target, nama/pola glob dipisah koma (cth: site_*,hq_db): "; getline(cin, input);
+                    vector<string> targets = resolveFanOutDatabases(db->databaseNames(), splitList(input));
+                    if (targets.empty()) {
+                        cout << "Tidak ada database yang cocok." << endl;
+                        break;
+                    }
+                    cout << targets.size() << " database: " << joinList(targets, ", ") << endl;
+                    FanOutRequest req;
+                    cout << "Operasi: 1. Query  2. Truncate tabel  3. Purge data lama  4. Ekspor tabel ke CSV  5. Backup\nPilihan: ";
+                    getline(cin, input);
+                    if (input == "1") {
+                        req.kind = FanOutRequest::Kind::Query;
+                        cout << "Query (dijalankan apa adanya di setiap database): "; getline(cin, req.sql);
+                    } else if (input == "2" || input == "3" || input == "4") {
+                        req.kind = input == "2" ? FanOutRequest::Kind::Truncate
+                                 : input == "3" ? FanOutRequest::Kind::Purge : FanOutRequest::Kind::Export;
+                        cout << "Nama tabel: "; getline(cin, req.table);
+                    } else if (input == "5") {
+                        req.kind = FanOutRequest::Kind::Backup;
+                    } else {
+                        cout << "Pilihan tidak valid." << endl;
+                        break;
+                    }
+                    if (req.kind == FanOutRequest::Kind::Purge) {
+                        cout << "Kolom waktu (Enter = " << req.retention.timeColumn << "): "; getline(cin, input);
+                        if (!input.empty()) req.retention.timeColumn = input;
+                        cout << "Hapus data lebih lama dari N hari, atau cutoff 'YYYY-MM-DD HH:MM:SS' (Enter = " << req.retention.keepDays << " hari): ";
+                        getline(cin, input);
+                        if (input.find('-') != string::npos) req.retention.cutoff = input;
+                        else if (!input.empty()) req.retention.keepDays = max(0, atoi(input.c_str()));
+                    }
+                    if (req.kind == FanOutRequest::Kind::Export || req.kind == FanOutRequest::Kind::Backup) {
+                        cout << "File output, {db} = nama database (cth: " << (req.kind == FanOutRequest::Kind::Backup ? "backup_{db}.sql.gz" : "export_{db}.csv.gz") << "): ";
+                        getline(cin, req.path);
+                    }
+                    if (!validateFanOutRequest(req, targets.size())) break;
+                    cout << "Jumlah koneksi paralel (Enter = " << req.connections << "): "; getline(cin, input);
+                    if (!input.empty()) req.connections = static_cast<size_t>(max(1, atoi(input.c_str())));
+                    bool writes = req.kind == FanOutRequest::Kind::Truncate || req.kind == FanOutRequest::Kind::Purge ||
+                                  (req.kind == FanOutRequest::Kind::Query && !isReadOnlyStatement(req.sql));
+                    if (writes) {
+                        cout << "Operasi ini mengubah data di " << targets.size() << " database. Ketik 'YA' untuk melanjutkan: ";
+                        getline(cin, input);
+                        if (input != "YA") {
+                            cout << "Fan-out dibatalkan." << endl;
+                            break;
+                        }
+                    }
+                    ConnectionInfo info = db->connectionInfo();
+                    DatabaseManager* mgr = db.get();
+                    runJob(jobs, "Fan-out " + fanOutLabel(req), [mgr, info, targets, req]() {
+                        bool ok = fanOut(info, targets, req);
+                        mgr->invalidateResultCache(); // Ditulis lewat koneksi lain
+                        return ok;
+                    });
+                }
+                break;
             case 0:
+                if (jobs.activeCount() > 0) {
+                    cout << jobs.activeCount() << " job masih berjalan dan akan dibatalkan." << endl;
+                }
                 cout << "Keluar..." << endl;
                 break;
             default:
@@ -1677,4 +10584,5 @@ int main() {
     }
 
     return 0;
-}
\ No newline at end of file
+}
+#endif // DBM_NO_MAIN
\ No newline at end of file
@@ -0,0 +1,344 @@
+/**
+ * Microbenchmark jalur per-baris Database_option.cpp (Google Benchmark):
+ * parseCSVLine, RowBatch, escapeCSVField, codec record bertipe (JSON ingest dan CSV),
+ * validasi identifier, dan timestamp writeLog.
+ * Setiap benchmark juga melaporkan alokasi per iterasi serta puncak heap/RSS
+ * (counter allocs_per_iter, alloc_bytes_per_iter, peak_heap_bytes, peak_rss_bytes)
+ * dari hook alokator program; nilainya 0 jika dibangun dengan -DDBM_NO_ALLOC_HOOK.
+ *
+ * Build (dari folder Databases, include/lib Connector/C++ sama seperti program utama):
+ *   g++ -std=c++17 -O2 -DNDEBUG bench/hot_paths_bench.cpp -o bench/hot_paths_bench \
+ *       -lbenchmark -lpthread -lmysqlcppconn -lz -lzstd
+ *
+ * Baseline disimpan di bench/baseline.json. Setelah mengubah jalur panas:
+ *   bench/hot_paths_bench --benchmark_out=bench/new.json --benchmark_out_format=json
+ *   python3 <repo google/benchmark>/tools/compare.py benchmarks bench/baseline.json bench/new.json
+ * Perbarui baseline hanya jika perubahan performanya memang disengaja.
+ */
+#define DBM_NO_MAIN
+#include "../Database_option.cpp"
+
+#include <benchmark/benchmark.h>
+#include <regex>
+
+namespace {
+
+// Data meniru Server/usage_data.csv: timestamp ISO, nama aplikasi, package,
+// durasi berbahasa Indonesia (sebagian dikutip, sebagian mengandung koma/kutip).
+const vector<string> APPS = {"TikTok", "WhatsApp", "Twitter", "Instagram", "Google Maps", "ChatGPT",
+                             "YouTube", "Chrome", "Galeri, MIUI", "Setelan \"Sistem\""};
+const vector<string> PACKAGES = {
+    "com.ss.android.ugc.trill", "com.whatsapp", "com.twitter.android", "com.instagram.android",
+    "com.google.android.apps.maps", "com.openai.chatgpt", "com.google.android.youtube", "com.android.chrome",
+    "com.miui.gallery", "com.google.android.googlequicksearchbox",
+    "com.example.screentimemonitoring.debug.instrumentation.longrunning.worker",
+    "id.co.bankmandiri.livinbymandiri.superapp.production.release.internal"};
+const size_t CORPUS = 1024; // Cukup banyak agar tidak hanya satu baris yang panas di cache
+
+/** @brief Satu nilai ter-escape sebagai string baru (pola per-field sebelum ekspor memakai RowBatch). */
+string escapeCSVField(const string& value) {
+    string out;
+    appendCSVField(out, value);
+    return out;
+}
+
+string duration(mt19937& rng) {
+    int h = rng() % 14, m = rng() % 60, s = rng() % 60;
+    return to_string(h) + " jam " + to_string(m) + " menit " + to_string(s) + " detik";
+}
+
+/** @brief Baris CSV apa adanya (sudah di-escape) seperti yang dibaca importFromCSV. */
+vector<string> usageLines() {
+    mt19937 rng(42);
+    vector<string> lines;
+    for (size_t i = 0; i < CORPUS; ++i) {
+        string usage = duration(rng), total = duration(rng);
+        if (i % 3 == 0) usage = "\"" + usage + "\"";              // Durasi dikutip
+        if (i % 7 == 0) total = "\"" + total + ", estimasi\"";    // Koma di dalam kutip
+        lines.push_back("2025-11-05T18:08:13.038242," + escapeCSVField(APPS[i % APPS.size()]) + "," +
+                        PACKAGES[rng() % PACKAGES.size()] + "," + usage + "," + total + "," +
+                        (i % 2 ? "High" : "Medium"));
+    }
+    return lines;
+}
+
+/** @brief Baris lebar (64 kolom campuran angka, teks, dan durasi dikutip). */
+vector<string> wideLines() {
+    mt19937 rng(7);
+    vector<string> lines;
+    for (size_t i = 0; i < CORPUS; ++i) {
+        string line;
+        for (int c = 0; c < 64; ++c) {
+            if (c) line += ',';
+            switch (c % 4) {
+                case 0: line += to_string(rng() % 100000); break;
+                case 1: line += PACKAGES[rng() % PACKAGES.size()]; break;
+                case 2: line += "\"" + duration(rng) + "\""; break;
+                default: line += to_string((rng() % 10000) / 100.0); break;
+            }
+        }
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+/** @brief Nilai mentah dari database yang akan di-escape oleh ekspor/backup. */
+vector<string> rawValues() {
+    mt19937 rng(3);
+    vector<string> values;
+    for (size_t i = 0; i < CORPUS; ++i) {
+        switch (i % 4) {
+            case 0: values.push_back(PACKAGES[rng() % PACKAGES.size()]); break;
+            case 1: values.push_back(duration(rng)); break;
+            case 2: values.push_back(APPS[rng() % APPS.size()]); break; // Sebagian mengandung koma/kutip
+            default: values.push_back("Catatan: \"" + duration(rng) + "\", dipakai malam hari\nbaris kedua"); break;
+        }
+    }
+    return values;
+}
+
+/**
+ * @brief Mengukur alokasi di dalam loop benchmark. Dibuat tepat sebelum loop,
+ *        report() dipanggil setelahnya agar data uji (static) tidak ikut terhitung.
+ */
+class AllocationCounter {
+public:
+    AllocationCounter() : scope("bench") {}
+
+    void report(benchmark::State& state) const {
+        MemoryUsage u = scope.usage();
+        double iterations = max<double>(1, static_cast<double>(state.iterations()));
+        state.counters["allocs_per_iter"] = u.allocations / iterations;
+        state.counters["alloc_bytes_per_iter"] = u.allocatedBytes / iterations;
+        state.counters["peak_heap_bytes"] = static_cast<double>(u.peakHeapBytes);
+        state.counters["peak_rss_bytes"] = static_cast<double>(u.peakRssBytes);
+    }
+
+private:
+    MemoryScope scope;
+};
+
+void parseLines(benchmark::State& state, const vector<string>& lines) {
+    size_t i = 0, bytes = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        const string& line = lines[i++ % lines.size()];
+        vector<string> fields = parseCSVLine(line);
+        benchmark::DoNotOptimize(fields.data());
+        bytes += line.size();
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+void BM_ParseCSVLine_Usage(benchmark::State& state) {
+    static const vector<string> lines = usageLines();
+    parseLines(state, lines);
+}
+BENCHMARK(BM_ParseCSVLine_Usage);
+
+void BM_ParseCSVLine_Wide64(benchmark::State& state) {
+    static const vector<string> lines = wideLines();
+    parseLines(state, lines);
+}
+BENCHMARK(BM_ParseCSVLine_Wide64);
+
+// Jalur impor: parse langsung ke arena RowBatch yang dipakai ulang per 1000 baris (batchSize default)
+void BM_RowBatchAppendCSVLine_Usage(benchmark::State& state) {
+    static const vector<string> lines = usageLines();
+    RowBatch batch(parseCSVLine(lines[0]).size());
+    size_t i = 0, bytes = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        const string& line = lines[i++ % lines.size()];
+        if (batch.size() == 1000) batch.clear();
+        benchmark::DoNotOptimize(batch.appendCSVLine(line, i));
+        bytes += line.size();
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_RowBatchAppendCSVLine_Usage);
+
+void BM_EscapeCSVField(benchmark::State& state) {
+    static const vector<string> values = rawValues();
+    size_t i = 0, bytes = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        const string& v = values[i++ % values.size()];
+        string out = escapeCSVField(v);
+        benchmark::DoNotOptimize(out.data());
+        bytes += v.size();
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_EscapeCSVField);
+
+// Satu baris ekspor penuh: escape tiap kolom lalu gabung, seperti loop exportToCSV/backupDatabase
+void BM_EscapeCSVRow_Usage(benchmark::State& state) {
+    static const vector<vector<string>> rows = [] {
+        vector<vector<string>> out;
+        for (const string& line : usageLines()) out.push_back(parseCSVLine(line));
+        return out;
+    }();
+    size_t i = 0, bytes = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        const vector<string>& row = rows[i++ % rows.size()];
+        string line;
+        for (size_t c = 0; c < row.size(); ++c) {
+            if (c) line += ',';
+            line += escapeCSVField(row[c]);
+        }
+        benchmark::DoNotOptimize(line.data());
+        bytes += line.size();
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_EscapeCSVRow_Usage);
+
+// Jalur ekspor/backup: satu RowBatch (EXPORT_BATCH_ROWS baris) diformat ke buffer keluaran yang dipakai ulang
+void BM_AppendCSVRows_Usage(benchmark::State& state) {
+    static const RowBatch rows = [] {
+        vector<string> lines = usageLines();
+        RowBatch out(parseCSVLine(lines[0]).size());
+        for (size_t i = 0; i < EXPORT_BATCH_ROWS; ++i) out.appendCSVLine(lines[i % lines.size()], i + 1);
+        return out;
+    }();
+    string out;
+    size_t bytes = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        out.clear();
+        appendCSVRows(rows, out);
+        benchmark::DoNotOptimize(out.data());
+        bytes += out.size();
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_AppendCSVRows_Usage);
+
+/** @brief Body POST /receive_usage seperti yang dikirim aplikasi Android (8 aplikasi per request). */
+vector<string> usagePayloads() {
+    mt19937 rng(11);
+    vector<string> bodies;
+    for (size_t i = 0; i < CORPUS / 8; ++i) {
+        string body = "{\"total_screen_time_s\":" + to_string(rng() % 50000) + ",\"usage_data\":[";
+        for (int a = 0; a < 8; ++a) {
+            AppUsage item;
+            item.package = PACKAGES[rng() % PACKAGES.size()];
+            item.appName = APPS[rng() % APPS.size()];
+            item.foregroundTimeSeconds = rng() % 20000;
+            if (a) body += ',';
+            body += "{\"package\":";
+            appendJSONString(body, item.package);
+            body += ",\"app_name\":";
+            appendJSONString(body, *item.appName);
+            body += ",\"foreground_time_s\":" + to_string(item.foregroundTimeSeconds) + "}";
+        }
+        bodies.push_back(body + "]}");
+    }
+    return bodies;
+}
+
+// Jalur ingest: body JSON di-parse in-place langsung menjadi AppUsage (angka tanpa string perantara)
+void BM_ParseUsagePayload(benchmark::State& state) {
+    static const vector<string> bodies = usagePayloads();
+    string scratch;
+    vector<AppUsage> records;
+    size_t i = 0, bytes = 0, items = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        scratch = bodies[i++ % bodies.size()]; // Parser menulis ke buffer (unescape in-place)
+        bool ok = parseUsagePayload(&scratch[0], scratch.size(), records);
+        benchmark::DoNotOptimize(ok);
+        bytes += scratch.size();
+        items += records.size();
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(items));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_ParseUsagePayload);
+
+// Encode record bertipe ke CSV: kolom angka langsung ditulis dengan to_chars, tanpa string perantara
+void BM_AppendRecordCSV_Sensor(benchmark::State& state) {
+    static const vector<SensorReading> readings = [] {
+        mt19937 rng(5);
+        vector<SensorReading> out(CORPUS);
+        for (SensorReading& r : out) {
+            r.timestamp = "2025-11-05 18:08:13.038242";
+            r.temperature = 20 + (rng() % 1500) / 100.0;
+            if (rng() % 4) r.humidity = (rng() % 10000) / 100.0;
+            r.airQuality = (rng() % 50000) / 100.0;
+        }
+        return out;
+    }();
+    string out;
+    size_t i = 0, bytes = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        out.clear();
+        appendRecordCSV(out, readings[i++ % readings.size()]);
+        benchmark::DoNotOptimize(out.data());
+        bytes += out.size();
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_AppendRecordCSV_Sensor);
+
+const vector<string> IDENTIFIERS = {"usage_events", "sensor_data", "package", "total_screen_time", "fuzzy_level",
+                                    "_dbm_rollup_sensor_data_minute", "9invalid", "app-name", "timestamp",
+                                    "a_really_long_but_still_valid_identifier_name_for_a_rollup_tbl"};
+
+void BM_IsSafeIdentifier(benchmark::State& state) {
+    size_t i = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(isSafeIdentifier(IDENTIFIERS[i++ % IDENTIFIERS.size()]));
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IsSafeIdentifier);
+
+// Referensi: implementasi isValidIdentifier lama berbasis std::regex, untuk melihat selisihnya
+void BM_IdentifierRegexReference(benchmark::State& state) {
+    static const regex pattern("^[a-zA-Z_][a-zA-Z0-9_]*$");
+    size_t i = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        const string& name = IDENTIFIERS[i++ % IDENTIFIERS.size()];
+        benchmark::DoNotOptimize(name.size() <= 64 && regex_match(name, pattern));
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IdentifierRegexReference);
+
+void BM_FormatLogTimestamp(benchmark::State& state) {
+    auto when = chrono::system_clock::now();
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        string ts = formatLogTimestamp(when);
+        benchmark::DoNotOptimize(ts.data());
+        when += chrono::seconds(1);
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatLogTimestamp);
+
+} // namespace
+
+BENCHMARK_MAIN();